@@ -0,0 +1,239 @@
+#ifndef VML_BENCH_BENCH_HPP_INCLUDED
+#define VML_BENCH_BENCH_HPP_INCLUDED
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#elif defined(_WIN32)
+/// The `min` and `max` macros of windows.h break `std::max` and `vml::max`
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+#include <vml/vml.hpp>
+
+/// A minimal benchmark harness. Every benchmark runs an operation over
+/// `bench::batch_size` independent inputs per iteration, so the numbers
+/// measure throughput rather than latency.
+
+namespace bench {
+
+/// Number of operations per iteration of every benchmark
+inline constexpr size_t batch_size = 256;
+
+/// Forces the compiler to materialize \p value
+template <typename T>
+inline void do_not_optimize(T const& value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    _ReadWriteBarrier();
+    (void)*reinterpret_cast<char const volatile*>(&value);
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/// A benchmark runs the measured operation `batch_size` times per call
+struct benchmark {
+    std::string name;
+    std::function<void()> body;
+};
+
+struct result {
+    std::string name;
+    /// Median over all repetitions
+    double ns_per_op;
+    /// Operations per second
+    double throughput;
+    /// Fastest and slowest repetition
+    double min_ns_per_op;
+    double max_ns_per_op;
+};
+
+inline std::vector<benchmark>& registry() {
+    static std::vector<benchmark> benchmarks;
+    return benchmarks;
+}
+
+inline void add(std::string name, std::function<void()> body) {
+    registry().push_back({ std::move(name), std::move(body) });
+}
+
+/// Registers a benchmark that calls \p op with every element of \p inputs
+template <typename Input, typename Op>
+void add_unary(std::string name, std::vector<Input> const& inputs,
+               Op op) {
+    add(std::move(name), [inputs, op] {
+        for (auto const& x: inputs) {
+            do_not_optimize(op(x));
+        }
+    });
+}
+
+/// Registers a benchmark that calls \p op with the elements of \p a and \p b
+template <typename A, typename B, typename Op>
+void add_binary(std::string name, std::vector<A> const& a,
+                std::vector<B> const& b, Op op) {
+    add(std::move(name), [a, b, op] {
+        for (size_t i = 0; i < batch_size; ++i) {
+            do_not_optimize(op(a[i], b[i]));
+        }
+    });
+}
+
+/// Time per operation of \p calls calls of \p b in nanoseconds
+inline double measure(benchmark const& b, size_t calls) {
+    using clock = std::chrono::steady_clock;
+    auto const begin = clock::now();
+    for (size_t i = 0; i < calls; ++i) {
+        b.body();
+    }
+    auto const elapsed = clock::now() - begin;
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           double(calls * batch_size);
+}
+
+/// Doubles the number of calls of \p b until they last at least \p min_time
+inline size_t calibrate(benchmark const& b, std::chrono::nanoseconds min_time) {
+    b.body(); // Warm up caches and branch predictors
+    size_t calls = 1;
+    double const min_ns = std::chrono::duration<double, std::nano>(min_time)
+                              .count();
+    while (measure(b, calls) * double(calls * batch_size) < min_ns) {
+        calls *= 2;
+    }
+    return calls;
+}
+
+/// Median, fastest and slowest of \p samples
+inline result summarize(std::string name, std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    size_t const n = samples.size();
+    double const median = n % 2 ? samples[n / 2]
+                                : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    return { std::move(name), median, 1e9 / median, samples.front(),
+             samples.back() };
+}
+
+/// Calibrates all of \p benchmarks, then runs \p repetitions repetitions of
+/// each and reports the medians. The repetitions are interleaved: repetition
+/// `r` of every benchmark runs before repetition `r + 1` of any. The first
+/// benchmarks would otherwise be measured while the CPU is still ramping up
+/// its clock, and a frequency drift would favour whichever benchmarks run
+/// last. The whole set runs once for \p warm_up before anything is measured.
+inline std::vector<result> run_all(
+    std::vector<benchmark const*> const& benchmarks,
+    std::chrono::nanoseconds min_time, size_t repetitions,
+    std::chrono::nanoseconds warm_up) {
+    using clock = std::chrono::steady_clock;
+    auto const warm_up_end = clock::now() + warm_up;
+    do {
+        for (auto const* b: benchmarks) {
+            b->body();
+        }
+    } while (!benchmarks.empty() && clock::now() < warm_up_end);
+
+    std::vector<size_t> calls;
+    for (auto const* b: benchmarks) {
+        calls.push_back(calibrate(*b, min_time));
+    }
+    repetitions = std::max(repetitions, size_t(1));
+    std::vector<std::vector<double>> samples(benchmarks.size());
+    for (size_t r = 0; r < repetitions; ++r) {
+        for (size_t i = 0; i < benchmarks.size(); ++i) {
+            samples[i].push_back(measure(*benchmarks[i], calls[i]));
+        }
+    }
+    std::vector<result> results;
+    for (size_t i = 0; i < benchmarks.size(); ++i) {
+        results.push_back(summarize(benchmarks[i]->name,
+                                    std::move(samples[i])));
+    }
+    return results;
+}
+
+/// Pins the calling thread to the logical CPU \p cpu, so the timings are not
+/// disturbed by migrations. Returns `false` if the platform does not
+/// support it.
+inline bool pin_to_cpu(int cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+/// Deterministic pseudo random values in `[lo, hi)`
+class generator {
+public:
+    explicit generator(unsigned seed = 1): _state(seed) {}
+
+    double operator()(double lo = -1, double hi = 1) {
+        _state = _state * 6364136223846793005ull + 1442695040888963407ull;
+        return lo + (hi - lo) * double(_state >> 11) * 0x1.0p-53;
+    }
+
+    /// `batch_size` values of type `T` constructed by \p make
+    template <typename T, typename F>
+    std::vector<T> fill(F make) {
+        std::vector<T> result;
+        result.reserve(batch_size);
+        for (size_t i = 0; i < batch_size; ++i) {
+            result.push_back(make(*this));
+        }
+        return result;
+    }
+
+private:
+    unsigned long long _state;
+};
+
+/// "float", "double", "float, packed", ...
+template <typename T>
+std::string type_name() {
+    return std::is_same_v<T, float> ? "float" : "double";
+}
+
+template <typename T, vml::vector_options O>
+std::string type_name() {
+    return type_name<T>() + (O.packed() ? ", packed" : ", aligned");
+}
+
+/// Calls \p f with every combination of `float`/`double` and packed/aligned
+/// as `f.template operator()<T, O>()`
+template <typename F>
+void for_each_type(F&& f) {
+    constexpr auto packed = vml::vector_options{}.packed(true);
+    constexpr auto aligned = vml::vector_options{};
+    f.template operator()<float, aligned>();
+    f.template operator()<float, packed>();
+    f.template operator()<double, aligned>();
+    f.template operator()<double, packed>();
+}
+
+void register_vector();
+void register_matrix();
+void register_quaternion();
+void register_complex();
+void register_color();
+void register_shapes();
+
+} // namespace bench
+
+#endif // VML_BENCH_BENCH_HPP_INCLUDED
@@ -0,0 +1,14 @@
+#include "bench.hpp"
+
+void bench::register_color() {
+    for_each_type([]<typename T, vml::vector_options O> {
+        using V3 = vml::vector3<T, O>;
+        generator gen;
+        auto const rgb = gen.fill<V3>(
+            [](generator& g) { return V3(g(0, 1), g(0, 1), g(0, 1)); });
+        add_unary("rgb_to_hsv <" + type_name<T, O>() + ">", rgb,
+                  [](V3 const& x) { return vml::rgb_to_hsv(x); });
+        add_unary("hsv_to_rgb <" + type_name<T, O>() + ">", rgb,
+                  [](V3 const& x) { return vml::hsv_to_rgb(x); });
+    });
+}
@@ -0,0 +1,20 @@
+#include "bench.hpp"
+
+void bench::register_complex() {
+    auto const types = []<typename T> {
+        using C = vml::complex<T>;
+        std::string const suffix = "<" + type_name<T>() + ">";
+        generator gen;
+        auto const random = [](generator& g) { return C(g(0.1, 2), g()); };
+        auto const a = gen.fill<C>(random), b = gen.fill<C>(random);
+
+        add_unary("exp(complex) " + suffix, a,
+                  [](C const& z) { return vml::exp(z); });
+        add_unary("log(complex) " + suffix, a,
+                  [](C const& z) { return vml::log(z); });
+        add_binary("pow(complex, complex) " + suffix, a, b,
+                   [](C const& x, C const& y) { return vml::pow(x, y); });
+    };
+    types.template operator()<float>();
+    types.template operator()<double>();
+}
@@ -0,0 +1,135 @@
+#include "bench.hpp"
+#include "report.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace {
+
+struct options {
+    char const* filter = "";
+    char const* json = nullptr;
+    char const* baseline = nullptr;
+    double threshold = 0.25;
+    size_t repetitions = 5;
+    int cpu = 0;
+    bool pin = true;
+    bool normalize_host = false;
+};
+
+void usage() {
+    std::fprintf(stderr,
+                 "Usage: vml_bench [options] [filter]\n"
+                 "Runs all benchmarks whose name contains `filter`.\n"
+                 "  --json <file>        Write the results to <file>\n"
+                 "  --baseline <file>    Fail if a benchmark is slower than "
+                 "in <file>\n"
+                 "  --threshold <ratio>  Tolerated slowdown, default 0.25\n"
+                 "  --normalize-host     Compare the timings relative to the "
+                 "other\n"
+                 "                       benchmarks, for a baseline of "
+                 "another machine\n"
+                 "  --repetitions <n>    Repetitions per benchmark, default "
+                 "5\n"
+                 "  --cpu <n>            Pin the thread to CPU <n>, default "
+                 "0\n"
+                 "  --no-pin             Do not pin the thread\n");
+}
+
+bool parse(int argc, char** argv, options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        bool const has_value = i + 1 < argc;
+        if (arg == "--json" && has_value) {
+            opt.json = argv[++i];
+        }
+        else if (arg == "--baseline" && has_value) {
+            opt.baseline = argv[++i];
+        }
+        else if (arg == "--threshold" && has_value) {
+            opt.threshold = std::atof(argv[++i]);
+        }
+        else if (arg == "--repetitions" && has_value) {
+            opt.repetitions = size_t(std::atoi(argv[++i]));
+        }
+        else if (arg == "--cpu" && has_value) {
+            opt.cpu = std::atoi(argv[++i]);
+        }
+        else if (arg == "--no-pin") {
+            opt.pin = false;
+        }
+        else if (arg == "--normalize-host") {
+            opt.normalize_host = true;
+        }
+        else if (arg.starts_with("--")) {
+            return false;
+        }
+        else {
+            opt.filter = argv[i];
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opt;
+    if (!parse(argc, argv, opt)) {
+        usage();
+        return 2;
+    }
+    if (opt.pin && !bench::pin_to_cpu(opt.cpu)) {
+        std::fprintf(stderr, "warning: failed to pin thread to CPU %d\n",
+                     opt.cpu);
+    }
+    bench::register_vector();
+    bench::register_matrix();
+    bench::register_quaternion();
+    bench::register_complex();
+    bench::register_color();
+    bench::register_shapes();
+
+    std::vector<bench::benchmark const*> selected;
+    for (auto const& b: bench::registry()) {
+        if (std::strstr(b.name.c_str(), opt.filter)) {
+            selected.push_back(&b);
+        }
+    }
+    auto const results = bench::run_all(selected,
+                                        std::chrono::milliseconds(10),
+                                        opt.repetitions,
+                                        std::chrono::milliseconds(500));
+    std::printf("%-52s %12s %14s\n", "benchmark", "ns/op", "Mops/s");
+    for (auto const& r: results) {
+        std::printf("%-52s %12.3f %14.1f\n", r.name.c_str(), r.ns_per_op,
+                    r.throughput / 1e6);
+    }
+    if (opt.json) {
+        std::ofstream file(opt.json);
+        bench::write_json(file, results);
+        if (!file) {
+            std::fprintf(stderr, "error: failed to write %s\n", opt.json);
+            return 2;
+        }
+    }
+    if (opt.baseline) {
+        auto const baseline = bench::read_json(opt.baseline);
+        if (!baseline) {
+            std::fprintf(stderr, "error: failed to read %s\n", opt.baseline);
+            return 2;
+        }
+        size_t const failures =
+            bench::compare(results, *baseline, opt.threshold,
+                           opt.normalize_host);
+        if (failures > 0) {
+            std::printf("%zu benchmark(s) regressed by more than %.1f%% or "
+                        "are missing from the baseline\n",
+                        failures, opt.threshold * 100);
+            return 1;
+        }
+    }
+}
@@ -0,0 +1,37 @@
+#include "bench.hpp"
+
+void bench::register_matrix() {
+    for_each_type([]<typename T, vml::vector_options O> {
+        using M3 = vml::matrix3x3<T, O>;
+        using M4 = vml::matrix4x4<T, O>;
+        using V4 = vml::vector4<T, O>;
+        std::string const suffix = "<" + type_name<T, O>() + ">";
+        generator gen;
+        /// Diagonally dominant, so the inverses exist
+        auto const random3 = [](generator& g) {
+            return M3([&](size_t i, size_t j) { return g() + 4 * (i == j); });
+        };
+        auto const random4 = [](generator& g) {
+            return M4([&](size_t i, size_t j) { return g() + 4 * (i == j); });
+        };
+        auto const a = gen.fill<M3>(random3), b = gen.fill<M3>(random3);
+        auto const c = gen.fill<M4>(random4), d = gen.fill<M4>(random4);
+        auto const v = gen.fill<V4>(
+            [](generator& g) { return V4(g(), g(), g(), g()); });
+
+        add_binary("matrix3x3 * matrix3x3 " + suffix, a, b,
+                   [](M3 const& x, M3 const& y) { return x * y; });
+        add_binary("matrix4x4 * matrix4x4 " + suffix, c, d,
+                   [](M4 const& x, M4 const& y) { return x * y; });
+        add_binary("matrix4x4 * vector4 " + suffix, c, v,
+                   [](M4 const& x, V4 const& y) { return x * y; });
+        add_unary("inverse(matrix3x3) " + suffix, a,
+                  [](M3 const& x) { return vml::inverse(x); });
+        add_unary("inverse(matrix4x4) " + suffix, c,
+                  [](M4 const& x) { return vml::inverse(x); });
+        add_unary("det(matrix3x3) " + suffix, a,
+                  [](M3 const& x) { return vml::det(x); });
+        add_unary("det(matrix4x4) " + suffix, c,
+                  [](M4 const& x) { return vml::det(x); });
+    });
+}
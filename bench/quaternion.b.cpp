@@ -0,0 +1,24 @@
+#include "bench.hpp"
+
+void bench::register_quaternion() {
+    for_each_type([]<typename T, vml::vector_options O> {
+        using Q = vml::quaternion<T>;
+        using V3 = vml::vector3<T, O>;
+        std::string const suffix = "<" + type_name<T, O>() + ">";
+        generator gen;
+        auto const random = [](generator& g) {
+            return vml::normalize(Q(g(), g(), g(), g()));
+        };
+        auto const a = gen.fill<Q>(random), b = gen.fill<Q>(random);
+        auto const v =
+            gen.fill<V3>([](generator& g) { return V3(g(), g(), g()); });
+
+        /// Quaternions have no vector options, only run them once per type
+        if (!O.packed()) {
+            add_binary("quaternion * quaternion <" + type_name<T>() + ">", a,
+                       b, [](Q const& x, Q const& y) { return x * y; });
+        }
+        add_binary("rotate(vector3, quaternion) " + suffix, v, a,
+                   [](V3 const& x, Q const& q) { return vml::rotate(x, q); });
+    });
+}
@@ -0,0 +1,170 @@
+#ifndef VML_BENCH_REPORT_HPP_INCLUDED
+#define VML_BENCH_REPORT_HPP_INCLUDED
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+/// Results are exchanged as
+///
+///     { "benchmarks": [
+///         { "name": "...", "ns_per_op": 1.25, "min_ns_per_op": 1.2,
+///           "max_ns_per_op": 1.4 },
+///         ...
+///     ] }
+///
+/// Only `name` and `ns_per_op` are read back, all other keys are ignored.
+
+namespace bench {
+
+inline std::string json_escape(std::string const& str) {
+    std::string result;
+    for (char c: str) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+        }
+        result += c;
+    }
+    return result;
+}
+
+inline void write_json(std::ostream& str, std::vector<result> const& results) {
+    str << "{\n  \"benchmarks\": [";
+    char const* separator = "\n";
+    for (auto const& r: results) {
+        char buffer[128];
+        std::snprintf(buffer, sizeof buffer,
+                      "\"ns_per_op\": %.4f, \"min_ns_per_op\": %.4f, "
+                      "\"max_ns_per_op\": %.4f",
+                      r.ns_per_op, r.min_ns_per_op, r.max_ns_per_op);
+        str << separator << "    { \"name\": \"" << json_escape(r.name)
+            << "\", " << buffer << " }";
+        separator = ",\n";
+    }
+    str << "\n  ]\n}\n";
+}
+
+/// Reads the median time per operation of every benchmark in the file at
+/// \p path. Returns `std::nullopt` if the file cannot be opened or parsed.
+inline std::optional<std::map<std::string, double>> read_json(
+    std::string const& path) {
+    std::ifstream file(path);
+    if (!file) {
+        return std::nullopt;
+    }
+    std::stringstream sstr;
+    sstr << file.rdbuf();
+    std::string const text = sstr.str();
+    size_t pos = 0;
+    auto const skip_space = [&] {
+        while (pos < text.size() && std::isspace((unsigned char)text[pos])) {
+            ++pos;
+        }
+    };
+    auto const parse_string = [&]() -> std::optional<std::string> {
+        skip_space();
+        if (pos >= text.size() || text[pos] != '"') {
+            return std::nullopt;
+        }
+        std::string result;
+        for (++pos; pos < text.size() && text[pos] != '"'; ++pos) {
+            if (text[pos] == '\\') {
+                ++pos;
+            }
+            if (pos < text.size()) {
+                result += text[pos];
+            }
+        }
+        ++pos;
+        return result;
+    };
+    std::map<std::string, double> result;
+    std::optional<std::string> name;
+    // We only look at the keys we need and skip over everything else
+    while ((pos = text.find('"', pos)) != std::string::npos) {
+        auto key = parse_string();
+        skip_space();
+        if (!key || pos >= text.size() || text[pos] != ':') {
+            continue;
+        }
+        ++pos;
+        skip_space();
+        if (*key == "name") {
+            name = parse_string();
+        }
+        else if (*key == "ns_per_op") {
+            char* end = nullptr;
+            double const value = std::strtod(text.c_str() + pos, &end);
+            if (end == text.c_str() + pos || !name) {
+                return std::nullopt;
+            }
+            pos = size_t(end - text.c_str());
+            result[*name] = value;
+            name.reset();
+        }
+    }
+    return result;
+}
+
+/// Prints every result that is slower than its baseline by more than
+/// \p threshold (relative, e.g. `0.25` for 25%), and every result that has no
+/// baseline. Returns the number of such results.
+///
+/// With \p normalize_host every ratio to the baseline is divided by the
+/// geometric mean of all ratios first, so a baseline recorded on a faster or
+/// slower machine can be used. That also hides a regression that slows down
+/// every benchmark alike, so it is off by default.
+inline size_t compare(std::vector<result> const& results,
+                      std::map<std::string, double> const& baseline,
+                      double threshold, bool normalize_host = false) {
+    double host_factor = 1;
+    if (normalize_host) {
+        double log_sum = 0;
+        size_t matched = 0;
+        for (auto const& r: results) {
+            auto const itr = baseline.find(r.name);
+            if (itr != baseline.end()) {
+                log_sum += std::log(r.ns_per_op / itr->second);
+                ++matched;
+            }
+        }
+        if (matched) {
+            host_factor = std::exp(log_sum / double(matched));
+            std::printf("This host is %.2fx the speed of the baseline host\n",
+                        1 / host_factor);
+        }
+    }
+    size_t failures = 0;
+    for (auto const& r: results) {
+        auto const itr = baseline.find(r.name);
+        if (itr == baseline.end()) {
+            std::printf("%-52s not in baseline, regenerate it\n",
+                        r.name.c_str());
+            ++failures;
+            continue;
+        }
+        double const change = r.ns_per_op / itr->second / host_factor - 1;
+        if (change > threshold) {
+            std::printf("%-52s regressed by %.1f%% (%.3f ns/op -> %.3f ns/op)"
+                        "\n",
+                        r.name.c_str(), change * 100, itr->second,
+                        r.ns_per_op);
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+} // namespace bench
+
+#endif // VML_BENCH_REPORT_HPP_INCLUDED
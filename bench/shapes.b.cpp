@@ -0,0 +1,83 @@
+#include "bench.hpp"
+
+#include <array>
+
+void bench::register_shapes() {
+    for_each_type([]<typename T, vml::vector_options O> {
+        using V3 = vml::vector3<T, O>;
+        using Box = vml::AABB<T, 3, O>;
+        using Sphere = vml::sphere<T, 3, O>;
+        using Ray = vml::ray<T, 3, O>;
+        std::string const suffix = "<" + type_name<T, O>() + ">";
+        generator gen;
+        auto const point = [](generator& g) { return V3(g(), g(), g()); };
+        auto const boxes = gen.fill<Box>([&](generator& g) {
+            V3 const p = point(g);
+            return Box(p, p + V3(g(0, 1), g(0, 1), g(0, 1)));
+        });
+        auto const spheres = gen.fill<Sphere>(
+            [&](generator& g) { return Sphere(point(g), T(g(0, 1))); });
+        auto const rays = gen.fill<Ray>([&](generator& g) {
+            return Ray(point(g) * T(4), vml::normalize(point(g)));
+        });
+        auto const triangles =
+            gen.fill<vml::triangle<T, 3, O>>([&](generator& g) {
+            vml::triangle<T, 3, O> t;
+            t[0] = point(g);
+            t[1] = point(g);
+            t[2] = point(g);
+            return t;
+        });
+        auto const boxes_shifted = gen.fill<Box>([&](generator& g) {
+            V3 const p = point(g);
+            return Box(p, p + V3(g(0, 1), g(0, 1), g(0, 1)));
+        });
+
+        add_binary("do_intersect(AABB, AABB) " + suffix, boxes, boxes_shifted,
+                   [](Box const& x, Box const& y) {
+            return vml::do_intersect(x, y);
+        });
+        add_binary("do_intersect(sphere, sphere) " + suffix, spheres,
+                   spheres, [](Sphere const& x, Sphere const& y) {
+            return vml::do_intersect(x, y);
+        });
+        add_binary("do_intersect(sphere, AABB) " + suffix, spheres, boxes,
+                   [](Sphere const& x, Box const& y) {
+            return vml::do_intersect(x, y);
+        });
+        add_binary("intersect(ray, AABB) " + suffix, rays, boxes,
+                   [](Ray const& r, Box const& b) {
+            return vml::intersect(r, b);
+        });
+        add_binary("intersect(ray, sphere) " + suffix, rays, spheres,
+                   [](Ray const& r, Sphere const& s) {
+            return vml::intersect(r, s);
+        });
+        add_binary("intersect(ray, triangle) " + suffix, rays, triangles,
+                   [](Ray const& r, auto const& t) {
+            return vml::intersect(r, t).has_value();
+        });
+
+        /// One ray against 8 boxes per operation
+        if constexpr (std::is_same_v<T, float>) {
+            if (O.packed()) {
+                return;
+            }
+            std::vector<vml::aabb_packet<float, 8>> packets(batch_size);
+            std::array<vml::AABB<float>, 8> group;
+            for (size_t i = 0; i < batch_size; ++i) {
+                for (size_t j = 0; j < group.size(); ++j) {
+                    Box const& b = boxes[(i + j) % batch_size];
+                    group[j] = vml::AABB<float>(b.lower_bound(),
+                                                b.upper_bound());
+                }
+                packets[i] = vml::aabb_packet<float, 8>(group);
+            }
+            add_binary("intersect(ray, aabb_packet<8>) " + suffix, rays,
+                       packets,
+                       [](Ray const& r, vml::aabb_packet<float, 8> const& p) {
+                return vml::intersect(r, p).hit().bits();
+            });
+        }
+    });
+}
@@ -0,0 +1,45 @@
+#include "bench.hpp"
+
+void bench::register_vector() {
+    for_each_type([]<typename T, vml::vector_options O> {
+        using V3 = vml::vector3<T, O>;
+        using V4 = vml::vector4<T, O>;
+        std::string const suffix = "<" + type_name<T, O>() + ">";
+        generator gen;
+        auto const random3 = [](generator& g) { return V3(g(), g(), g()); };
+        auto const random4 = [](generator& g) {
+            return V4(g(), g(), g(), g());
+        };
+        auto const a = gen.fill<V3>(random3), b = gen.fill<V3>(random3);
+        auto const c = gen.fill<V4>(random4), d = gen.fill<V4>(random4);
+
+        add_binary("vector3 + vector3 " + suffix, a, b,
+                   [](V3 const& x, V3 const& y) { return x + y; });
+        add_binary("vector3 * vector3 " + suffix, a, b,
+                   [](V3 const& x, V3 const& y) { return x * y; });
+        add_binary("vector4 * vector4 " + suffix, c, d,
+                   [](V4 const& x, V4 const& y) { return x * y; });
+        add_binary("vector4 / vector4 " + suffix, c, d,
+                   [](V4 const& x, V4 const& y) { return x / y; });
+        add_binary("dot(vector3) " + suffix, a, b,
+                   [](V3 const& x, V3 const& y) { return vml::dot(x, y); });
+        add_binary("dot(vector4) " + suffix, c, d,
+                   [](V4 const& x, V4 const& y) { return vml::dot(x, y); });
+        add_binary("cross " + suffix, a, b,
+                   [](V3 const& x, V3 const& y) { return vml::cross(x, y); });
+        add_unary("normalize(vector3) " + suffix, a,
+                  [](V3 const& x) { return vml::normalize(x); });
+        add_unary("normalize_approx(vector3) " + suffix, a,
+                  [](V3 const& x) { return vml::normalize_approx(x); });
+        add_unary("norm(vector3) " + suffix, a,
+                  [](V3 const& x) { return vml::norm(x); });
+        add_unary("fast_norm(vector3) " + suffix, a,
+                  [](V3 const& x) { return vml::fast_norm(x); });
+        add_unary("norm(vector4) " + suffix, c,
+                  [](V4 const& x) { return vml::norm(x); });
+        add_unary("fast_norm(vector4) " + suffix, c,
+                  [](V4 const& x) { return vml::fast_norm(x); });
+        add_unary("std::hash(vector3) " + suffix, a,
+                  [](V3 const& x) { return std::hash<V3>{}(x); });
+    });
+}
@@ -8,8 +8,16 @@
 namespace _VVML {
 
 template <typename VectorType, typename T, vector_options O>
-VectorType __vml_load(vector<T, VectorType::size(), O> const& x) {
-    return type_cast<typename VectorType::value_type>(x);
+__vml_always_inline __vml_interface_export VectorType
+    __vml_load(vector<T, VectorType::size(), O> const& x) {
+    if constexpr (std::is_same_v<VectorType,
+                                 vector<T, VectorType::size(), O>>)
+    {
+        return x;
+    }
+    else {
+        return type_cast<typename VectorType::value_type>(x);
+    }
 }
 
 template <typename VectorType>
@@ -33,7 +41,17 @@ template <scalar T, scalar U, size_t Size, vector_options O, vector_options P>
 __vml_mathfunction __vml_always_inline __vml_interface_export constexpr vector<
     __vml_promote(T, U), Size, combine(O, P)>
     operator+(vector<T, Size, O> const& a, vector<U, Size, P> const& b) {
-    return map(a, b, _VVML::__vml_plus);
+    if (std::is_constant_evaluated()) {
+        return map(a, b, _VVML::__vml_plus);
+    }
+
+    using result_type = vector<__vml_promote(T, U), Size, combine(O, P)>;
+    using simd_type = __vml_get_simd_type<result_type>;
+
+    result_type result = __vml_load<result_type>(a);
+    simd_type::add(result.__vec, __vml_load<result_type>(b).__vec);
+
+    return result;
 }
 
 /// Add Scalar to Vector (element-wise)
@@ -41,7 +59,8 @@ template <scalar T, scalar U, size_t Size, vector_options O>
 __vml_mathfunction __vml_always_inline
     __vml_interface_export constexpr vector<__vml_promote(T, U), Size, O>
     operator+(vector<T, Size, O> const& a, U const& b) {
-    return map(a, [&b](auto _a) { return _a + b; });
+    using result_type = vector<__vml_promote(T, U), Size, O>;
+    return a + result_type(b);
 }
 
 /// Add Vector to Scalar (element-wise)
@@ -49,7 +68,8 @@ template <scalar T, scalar U, size_t Size, vector_options O>
 __vml_mathfunction __vml_always_inline
     __vml_interface_export constexpr vector<__vml_promote(T, U), Size, O>
     operator+(T const& a, vector<U, Size, O> const& b) {
-    return map(b, [&a](auto b) { return a + b; });
+    using result_type = vector<__vml_promote(T, U), Size, O>;
+    return result_type(a) + b;
 }
 
 /// MARK: Minus
@@ -66,7 +86,17 @@ template <scalar T, scalar U, size_t Size, vector_options O, vector_options P>
 __vml_mathfunction __vml_always_inline __vml_interface_export constexpr vector<
     __vml_promote(T, U), Size, combine(O, P)>
     operator-(vector<T, Size, O> const& a, vector<U, Size, P> const& b) {
-    return map(a, b, _VVML::__vml_minus);
+    if (std::is_constant_evaluated()) {
+        return map(a, b, _VVML::__vml_minus);
+    }
+
+    using result_type = vector<__vml_promote(T, U), Size, combine(O, P)>;
+    using simd_type = __vml_get_simd_type<result_type>;
+
+    result_type result = __vml_load<result_type>(a);
+    simd_type::sub(result.__vec, __vml_load<result_type>(b).__vec);
+
+    return result;
 }
 
 /// Subract Scalar from Vector (element-wise)
@@ -74,7 +104,8 @@ template <scalar T, scalar U, size_t Size, vector_options O>
 __vml_mathfunction __vml_always_inline
     __vml_interface_export constexpr vector<__vml_promote(T, U), Size, O>
     operator-(vector<T, Size, O> const& a, U const& b) {
-    return map(a, [&b](auto a) { return a - b; });
+    using result_type = vector<__vml_promote(T, U), Size, O>;
+    return a - result_type(b);
 }
 
 /// Subract Vector from Scalar (element-wise)
@@ -82,7 +113,8 @@ template <scalar T, scalar U, size_t Size, vector_options O>
 __vml_mathfunction __vml_always_inline
     __vml_interface_export constexpr vector<__vml_promote(T, U), Size, O>
     operator-(T const& a, vector<U, Size, O> const& b) {
-    return map(b, [&a](auto b) { return a - b; });
+    using result_type = vector<__vml_promote(T, U), Size, O>;
+    return result_type(a) - b;
 }
 
 /// MARK: Multiply
@@ -393,6 +425,34 @@ __vml_mathfunction __vml_always_inline __vml_interface_export constexpr matrix<
     return map(b, [&a](auto b) { return a * b; });
 }
 
+/// Whether 4x4 matrices of \p T are stored as rows of SIMD registers
+template <typename T, vector_options O>
+inline constexpr bool __vml_has_simd_rows =
+    !O.packed() && (std::is_same_v<T, float> ||
+                    (std::is_same_v<T, double> && VML_AVX));
+
+/// Computes `C = A * B` as a linear combination of the rows of B for every row
+/// of A. The sum is accumulated from the last column, so the association
+/// matches the fold in the constexpr path.
+template <typename T, vector_options O>
+__vml_always_inline void __vml_mul4x4(matrix<T, 4, 4, O>& C,
+                                      matrix<T, 4, 4, O> const& A,
+                                      matrix<T, 4, 4, O> const& B) {
+    using simd_type = __simd_type<T, 4, false>;
+    for (size_t i = 0; i < 4; ++i) {
+        typename simd_type::type row = B.__vec[3];
+        typename simd_type::type a;
+        simd_type::splat(a, A.__vml_at(i, 3));
+        simd_type::mul(row, a);
+        for (size_t k = 3; k-- > 0;) {
+            simd_type::splat(a, A.__vml_at(i, k));
+            simd_type::fma(a, B.__vec[k], row);
+            row = a;
+        }
+        C.__vec[i] = row;
+    }
+}
+
 /// Multiply Matrix by Matrix
 template <scalar T, scalar U, size_t RowsA, size_t ColumnsA, size_t ColumnsB,
           vector_options O, vector_options P>
@@ -400,8 +460,19 @@ __vml_mathfunction __vml_interface_export constexpr matrix<
     __vml_promote(T, U), RowsA, ColumnsB, combine(O, P)>
     operator*(matrix<T, RowsA, ColumnsA, O> const& A,
               matrix<U, ColumnsA, ColumnsB, P> const& B) {
+    if constexpr (RowsA == 4 && ColumnsA == 4 && ColumnsB == 4 &&
+                  std::is_same_v<T, U> && __vml_has_simd_rows<T, O> &&
+                  __vml_has_simd_rows<U, P>)
+    {
+        if (!std::is_constant_evaluated()) {
+            matrix<T, 4, 4, O> C;
+            _VVML::__vml_mul4x4(C, A, B);
+            return C;
+        }
+    }
     return matrix<__vml_promote(T, U), RowsA, ColumnsB, combine(O, P)>(
         [&](size_t i, size_t j) {
+        __vml_no_contract;
         return __vml_with_index_sequence((K, ColumnsA), {
             return ((A.__vml_at(i, K) * B.__vml_at(K, j)) + ...);
         });
@@ -416,6 +487,7 @@ __vml_mathfunction __vml_interface_export constexpr vector<__vml_promote(T, U),
     operator*(matrix<T, RowsA, ColumnsA, O> const& A,
               vector<U, ColumnsA, P> const& v) {
     return vector<__vml_promote(T, U), RowsA, combine(O, P)>([&](size_t i) {
+        __vml_no_contract;
         return __vml_with_index_sequence((K, ColumnsA), {
             return ((A.__vml_at(i, K) * v.__vml_at(K)) + ...);
         });
@@ -430,6 +502,7 @@ __vml_mathfunction __vml_interface_export constexpr vector<
     operator*(vector<T, ColumnsA, O> const& v,
               matrix<U, ColumnsA, ColumnsB, P> const& A) {
     return vector<__vml_promote(T, U), ColumnsB, combine(O, P)>([&](size_t j) {
+        __vml_no_contract;
         return __vml_with_index_sequence((K, ColumnsA), {
             return ((v.__vml_at(K) * A.__vml_at(K, j)) + ...);
         });
@@ -0,0 +1,1092 @@
+#ifndef __VML_BATCH_HPP_INCLUDED__
+#define __VML_BATCH_HPP_INCLUDED__
+
+#include <array>
+#include <concepts>
+#include <numeric>
+#include <ranges>
+
+#include <immintrin.h>
+
+#include "dispatch.hpp"
+#include "ext.hpp"
+#include "fwd.hpp"
+#include "half.hpp"
+#include "matrix.hpp"
+#include "quaternion.hpp"
+#include "vector.hpp"
+
+/// Element-wise kernels over arrays of scalars and vectors.
+///
+/// With `VML_RUNTIME_DISPATCH` enabled the kernels are compiled for SSE2,
+/// AVX2 + FMA + F16C and AVX-512 and selected at runtime depending on the
+/// host CPU. Otherwise only the instruction set selected by the compiler flags
+/// is used.
+
+namespace _VVML {
+
+/// Vectors in memory, component `k` of element `i` is
+/// `data[i * element_stride + k * component_stride]`. Arrays of vectors have a
+/// component stride of one, structure-of-arrays streams an element stride of
+/// one.
+template <typename P>
+struct __vml_strided {
+    P data;
+    size_t element_stride;
+    size_t component_stride;
+};
+
+/// MARK: - SSE2
+namespace __vml_sse2 {
+
+template <typename>
+struct __simd;
+
+template <>
+struct __simd<float> {
+    using reg = __m128;
+    static constexpr size_t width = 4;
+    static reg loadu(float const* p) { return _mm_loadu_ps(p); }
+    static void storeu(float* p, reg a) { _mm_storeu_ps(p, a); }
+    static reg set1(float a) { return _mm_set1_ps(a); }
+    static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+    static reg div(reg a, reg b) { return _mm_div_ps(a, b); }
+    /// Without FMA instructions or with `VML_DETERMINISTIC`, `fma` is a
+    /// multiply and an add, rounded twice
+#if defined(__FMA__) && !VML_DETERMINISTIC
+    static constexpr bool fma_rounds_once = true;
+    static reg fma(reg a, reg b, reg c) { return _mm_fmadd_ps(a, b, c); }
+#else
+    static constexpr bool fma_rounds_once = false;
+    static reg fma(reg a, reg b, reg c) {
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+    }
+#endif
+    static reg min(reg a, reg b) { return _mm_min_ps(b, a); }
+    static reg max(reg a, reg b) { return _mm_max_ps(b, a); }
+    static reg sqrt(reg a) { return _mm_sqrt_ps(a); }
+    static reg rsqrt(reg a) { return _mm_rsqrt_ps(a); }
+    static reg abs(reg a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    /// The magnitude of \p a with the sign of \p b
+    static reg copysign(reg a, reg b) {
+        reg const sign = _mm_set1_ps(-0.0f);
+        return _mm_or_ps(_mm_andnot_ps(sign, a), _mm_and_ps(sign, b));
+    }
+    /// `x < y ? a : b`
+    static reg select_lt(reg x, reg y, reg a, reg b) {
+        reg const mask = _mm_cmplt_ps(x, y);
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+    /// Bit `i` is set if `a[i] < b[i]`
+    static unsigned mask_lt(reg a, reg b) {
+        return unsigned(_mm_movemask_ps(_mm_cmplt_ps(a, b)));
+    }
+    /// Without F16C the conversions go through scalar code
+    static reg load_half(std::uint16_t const* p) {
+        alignas(16) float buffer[width];
+        for (size_t i = 0; i < width; ++i) {
+            buffer[i] = __vml_half_to_float(p[i]);
+        }
+        return _mm_load_ps(buffer);
+    }
+    static void store_half(std::uint16_t* p, reg a) {
+        alignas(16) float buffer[width];
+        _mm_store_ps(buffer, a);
+        for (size_t i = 0; i < width; ++i) {
+            p[i] = __vml_float_to_half(buffer[i]);
+        }
+    }
+};
+
+template <>
+struct __simd<double> {
+    using reg = __m128d;
+    static constexpr size_t width = 2;
+    static reg loadu(double const* p) { return _mm_loadu_pd(p); }
+    static void storeu(double* p, reg a) { _mm_storeu_pd(p, a); }
+    static reg set1(double a) { return _mm_set1_pd(a); }
+    static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+    static reg div(reg a, reg b) { return _mm_div_pd(a, b); }
+#if defined(__FMA__) && !VML_DETERMINISTIC
+    static constexpr bool fma_rounds_once = true;
+    static reg fma(reg a, reg b, reg c) { return _mm_fmadd_pd(a, b, c); }
+#else
+    static constexpr bool fma_rounds_once = false;
+    static reg fma(reg a, reg b, reg c) {
+        return _mm_add_pd(_mm_mul_pd(a, b), c);
+    }
+#endif
+    static reg min(reg a, reg b) { return _mm_min_pd(b, a); }
+    static reg max(reg a, reg b) { return _mm_max_pd(b, a); }
+    static reg sqrt(reg a) { return _mm_sqrt_pd(a); }
+    static reg rsqrt(reg a) { return _mm_div_pd(set1(1), _mm_sqrt_pd(a)); }
+    static reg abs(reg a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+    static reg copysign(reg a, reg b) {
+        reg const sign = _mm_set1_pd(-0.0);
+        return _mm_or_pd(_mm_andnot_pd(sign, a), _mm_and_pd(sign, b));
+    }
+    static reg select_lt(reg x, reg y, reg a, reg b) {
+        reg const mask = _mm_cmplt_pd(x, y);
+        return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+    }
+    static unsigned mask_lt(reg a, reg b) {
+        return unsigned(_mm_movemask_pd(_mm_cmplt_pd(a, b)));
+    }
+};
+
+template <>
+struct __simd<std::uint64_t> {
+    using reg = __m128i;
+    static constexpr size_t width = 2;
+    static reg loadu(std::uint64_t const* p) {
+        return _mm_loadu_si128((__m128i const*)p);
+    }
+    static void storeu(std::uint64_t* p, reg a) {
+        _mm_storeu_si128((__m128i*)p, a);
+    }
+    static reg set1(std::uint64_t a) { return _mm_set1_epi64x((long long)a); }
+    static reg bit_xor(reg a, reg b) { return _mm_xor_si128(a, b); }
+    template <int K>
+    static reg shift_right(reg a) {
+        return _mm_srli_epi64(a, K);
+    }
+    /// Low half of the product, assembled from 32 bit multiplies
+    static reg mul(reg a, reg b) {
+        reg const cross =
+            _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b),
+                          _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+        return _mm_add_epi64(_mm_mul_epu32(a, b), _mm_slli_epi64(cross, 32));
+    }
+};
+
+} // namespace __vml_sse2
+
+} // namespace _VVML
+
+#define __VML_BATCH_ISA __vml_sse2
+#include "batch_kernels.hpp"
+#undef __VML_BATCH_ISA
+
+/// MARK: - AVX2
+#if VML_RUNTIME_DISPATCH || defined(__AVX2__)
+
+__VML_TARGET_PUSH("avx2,fma,f16c")
+
+namespace _VVML::__vml_avx2 {
+
+template <typename>
+struct __simd;
+
+template <>
+struct __simd<float> {
+    using reg = __m256;
+    static constexpr size_t width = 8;
+    static reg loadu(float const* p) { return _mm256_loadu_ps(p); }
+    static void storeu(float* p, reg a) { _mm256_storeu_ps(p, a); }
+    static reg set1(float a) { return _mm256_set1_ps(a); }
+    static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+    static reg div(reg a, reg b) { return _mm256_div_ps(a, b); }
+#if VML_DETERMINISTIC
+    static constexpr bool fma_rounds_once = false;
+    static reg fma(reg a, reg b, reg c) { return add(mul(a, b), c); }
+#else
+    static constexpr bool fma_rounds_once = true;
+    static reg fma(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+#endif
+    static reg min(reg a, reg b) { return _mm256_min_ps(b, a); }
+    static reg max(reg a, reg b) { return _mm256_max_ps(b, a); }
+    static reg sqrt(reg a) { return _mm256_sqrt_ps(a); }
+    static reg rsqrt(reg a) { return _mm256_rsqrt_ps(a); }
+    static reg abs(reg a) {
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);
+    }
+    static reg copysign(reg a, reg b) {
+        reg const sign = _mm256_set1_ps(-0.0f);
+        return _mm256_or_ps(_mm256_andnot_ps(sign, a),
+                            _mm256_and_ps(sign, b));
+    }
+    static reg select_lt(reg x, reg y, reg a, reg b) {
+        return _mm256_blendv_ps(b, a, _mm256_cmp_ps(x, y, _CMP_LT_OQ));
+    }
+    static unsigned mask_lt(reg a, reg b) {
+        return unsigned(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ)));
+    }
+    static reg load_half(std::uint16_t const* p) {
+        return _mm256_cvtph_ps(_mm_loadu_si128((__m128i const*)p));
+    }
+    static void store_half(std::uint16_t* p, reg a) {
+        _mm_storeu_si128((__m128i*)p,
+                         _mm256_cvtps_ph(a, _MM_FROUND_TO_NEAREST_INT));
+    }
+};
+
+template <>
+struct __simd<double> {
+    using reg = __m256d;
+    static constexpr size_t width = 4;
+    static reg loadu(double const* p) { return _mm256_loadu_pd(p); }
+    static void storeu(double* p, reg a) { _mm256_storeu_pd(p, a); }
+    static reg set1(double a) { return _mm256_set1_pd(a); }
+    static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+    static reg div(reg a, reg b) { return _mm256_div_pd(a, b); }
+#if VML_DETERMINISTIC
+    static constexpr bool fma_rounds_once = false;
+    static reg fma(reg a, reg b, reg c) { return add(mul(a, b), c); }
+#else
+    static constexpr bool fma_rounds_once = true;
+    static reg fma(reg a, reg b, reg c) { return _mm256_fmadd_pd(a, b, c); }
+#endif
+    static reg min(reg a, reg b) { return _mm256_min_pd(b, a); }
+    static reg max(reg a, reg b) { return _mm256_max_pd(b, a); }
+    static reg sqrt(reg a) { return _mm256_sqrt_pd(a); }
+    static reg rsqrt(reg a) {
+        return _mm256_div_pd(set1(1), _mm256_sqrt_pd(a));
+    }
+    static reg abs(reg a) {
+        return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a);
+    }
+    static reg copysign(reg a, reg b) {
+        reg const sign = _mm256_set1_pd(-0.0);
+        return _mm256_or_pd(_mm256_andnot_pd(sign, a),
+                            _mm256_and_pd(sign, b));
+    }
+    static reg select_lt(reg x, reg y, reg a, reg b) {
+        return _mm256_blendv_pd(b, a, _mm256_cmp_pd(x, y, _CMP_LT_OQ));
+    }
+    static unsigned mask_lt(reg a, reg b) {
+        return unsigned(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)));
+    }
+};
+
+template <>
+struct __simd<std::uint64_t> {
+    using reg = __m256i;
+    static constexpr size_t width = 4;
+    static reg loadu(std::uint64_t const* p) {
+        return _mm256_loadu_si256((__m256i const*)p);
+    }
+    static void storeu(std::uint64_t* p, reg a) {
+        _mm256_storeu_si256((__m256i*)p, a);
+    }
+    static reg set1(std::uint64_t a) {
+        return _mm256_set1_epi64x((long long)a);
+    }
+    static reg bit_xor(reg a, reg b) { return _mm256_xor_si256(a, b); }
+    template <int K>
+    static reg shift_right(reg a) {
+        return _mm256_srli_epi64(a, K);
+    }
+    static reg mul(reg a, reg b) {
+        reg const cross =
+            _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                             _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+        return _mm256_add_epi64(_mm256_mul_epu32(a, b),
+                                _mm256_slli_epi64(cross, 32));
+    }
+};
+
+} // namespace _VVML::__vml_avx2
+
+#define __VML_BATCH_ISA __vml_avx2
+#include "batch_kernels.hpp"
+#undef __VML_BATCH_ISA
+
+__VML_TARGET_POP
+
+#endif // VML_RUNTIME_DISPATCH || defined(__AVX2__)
+
+/// MARK: - AVX-512
+#if VML_RUNTIME_DISPATCH || defined(__AVX512F__)
+
+__VML_TARGET_PUSH("avx512f")
+
+namespace _VVML::__vml_avx512 {
+
+template <typename>
+struct __simd;
+
+template <>
+struct __simd<float> {
+    using reg = __m512;
+    static constexpr size_t width = 16;
+    static reg loadu(float const* p) { return _mm512_loadu_ps(p); }
+    static void storeu(float* p, reg a) { _mm512_storeu_ps(p, a); }
+    static reg set1(float a) { return _mm512_set1_ps(a); }
+    static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+    static reg div(reg a, reg b) { return _mm512_div_ps(a, b); }
+#if VML_DETERMINISTIC
+    static constexpr bool fma_rounds_once = false;
+    static reg fma(reg a, reg b, reg c) { return add(mul(a, b), c); }
+#else
+    static constexpr bool fma_rounds_once = true;
+    static reg fma(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+#endif
+    static reg min(reg a, reg b) { return _mm512_min_ps(b, a); }
+    static reg max(reg a, reg b) { return _mm512_max_ps(b, a); }
+    static reg sqrt(reg a) { return _mm512_sqrt_ps(a); }
+    static reg rsqrt(reg a) { return _mm512_rsqrt14_ps(a); }
+    static reg abs(reg a) { return _mm512_abs_ps(a); }
+    /// Floating point logic needs AVX-512DQ, so we use integer logic
+    static reg copysign(reg a, reg b) {
+        __m512i const sign = _mm512_set1_epi32(int(0x80000000));
+        return _mm512_castsi512_ps(_mm512_or_si512(
+            _mm512_andnot_si512(sign, _mm512_castps_si512(a)),
+            _mm512_and_si512(sign, _mm512_castps_si512(b))));
+    }
+    static reg select_lt(reg x, reg y, reg a, reg b) {
+        return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x, y, _CMP_LT_OQ), b,
+                                    a);
+    }
+    static unsigned mask_lt(reg a, reg b) {
+        return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ);
+    }
+    static reg load_half(std::uint16_t const* p) {
+        return _mm512_cvtph_ps(_mm256_loadu_si256((__m256i const*)p));
+    }
+    static void store_half(std::uint16_t* p, reg a) {
+        _mm256_storeu_si256((__m256i*)p,
+                            _mm512_cvtps_ph(a, _MM_FROUND_TO_NEAREST_INT));
+    }
+};
+
+template <>
+struct __simd<double> {
+    using reg = __m512d;
+    static constexpr size_t width = 8;
+    static reg loadu(double const* p) { return _mm512_loadu_pd(p); }
+    static void storeu(double* p, reg a) { _mm512_storeu_pd(p, a); }
+    static reg set1(double a) { return _mm512_set1_pd(a); }
+    static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+    static reg div(reg a, reg b) { return _mm512_div_pd(a, b); }
+#if VML_DETERMINISTIC
+    static constexpr bool fma_rounds_once = false;
+    static reg fma(reg a, reg b, reg c) { return add(mul(a, b), c); }
+#else
+    static constexpr bool fma_rounds_once = true;
+    static reg fma(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+#endif
+    static reg min(reg a, reg b) { return _mm512_min_pd(b, a); }
+    static reg max(reg a, reg b) { return _mm512_max_pd(b, a); }
+    static reg sqrt(reg a) { return _mm512_sqrt_pd(a); }
+    static reg rsqrt(reg a) { return _mm512_rsqrt14_pd(a); }
+    static reg abs(reg a) { return _mm512_abs_pd(a); }
+    static reg copysign(reg a, reg b) {
+        __m512i const sign = _mm512_set1_epi64(
+            (long long)0x8000'0000'0000'0000);
+        return _mm512_castsi512_pd(_mm512_or_si512(
+            _mm512_andnot_si512(sign, _mm512_castpd_si512(a)),
+            _mm512_and_si512(sign, _mm512_castpd_si512(b))));
+    }
+    static reg select_lt(reg x, reg y, reg a, reg b) {
+        return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(x, y, _CMP_LT_OQ), b,
+                                    a);
+    }
+    static unsigned mask_lt(reg a, reg b) {
+        return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ);
+    }
+};
+
+template <>
+struct __simd<std::uint64_t> {
+    using reg = __m512i;
+    static constexpr size_t width = 8;
+    static reg loadu(std::uint64_t const* p) { return _mm512_loadu_si512(p); }
+    static void storeu(std::uint64_t* p, reg a) { _mm512_storeu_si512(p, a); }
+    static reg set1(std::uint64_t a) {
+        return _mm512_set1_epi64((long long)a);
+    }
+    static reg bit_xor(reg a, reg b) { return _mm512_xor_si512(a, b); }
+    template <int K>
+    static reg shift_right(reg a) {
+        return _mm512_srli_epi64(a, K);
+    }
+    /// `vpmullq` needs AVX-512DQ, this is the AVX-512F sequence
+    static reg mul(reg a, reg b) { return _mm512_mullox_epi64(a, b); }
+};
+
+} // namespace _VVML::__vml_avx512
+
+#define __VML_BATCH_ISA __vml_avx512
+#include "batch_kernels.hpp"
+#undef __VML_BATCH_ISA
+
+__VML_TARGET_POP
+
+#endif // VML_RUNTIME_DISPATCH || defined(__AVX512F__)
+
+/// MARK: - Kernel Selection
+
+namespace _VVML {
+
+#if defined(__AVX512F__)
+namespace __vml_native = __vml_avx512;
+#elif defined(__AVX2__)
+namespace __vml_native = __vml_avx2;
+#else
+namespace __vml_native = __vml_sse2;
+#endif
+
+} // namespace _VVML
+
+#if VML_RUNTIME_DISPATCH
+#define __vml_batch_kernel(NAME, T)                                            \
+    _VVML::__vml_dispatch(&_VVML::__vml_sse2::NAME<T>,                         \
+                          &_VVML::__vml_avx2::NAME<T>,                         \
+                          &_VVML::__vml_avx512::NAME<T>)
+#else
+#define __vml_batch_kernel(NAME, T) (&_VVML::__vml_native::NAME<T>)
+#endif
+
+/// MARK: - Public Interface
+
+namespace _VVML::batch {
+
+/// Arrays of these element types can be processed as flat arrays of scalars
+template <typename>
+struct __vml_batch_element: std::false_type {};
+
+template <typename T>
+    requires std::same_as<T, float> || std::same_as<T, double>
+struct __vml_batch_element<T>: std::true_type {
+    using scalar_type = T;
+    static constexpr size_t lanes = 1;
+};
+
+template <typename T, size_t Size, vector_options O>
+    requires std::same_as<T, float> || std::same_as<T, double>
+struct __vml_batch_element<vector<T, Size, O>>: std::true_type {
+    using scalar_type = T;
+    static constexpr size_t lanes = vector<T, Size, O>::data_size();
+    static_assert(sizeof(vector<T, Size, O>) == lanes * sizeof(T));
+};
+
+template <typename R>
+using __vml_batch_value_t = std::remove_cv_t<std::ranges::range_value_t<R>>;
+
+template <typename R>
+concept __vml_batch_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    __vml_batch_element<__vml_batch_value_t<R>>::value;
+
+/// All ranges have the same element type
+template <typename R, typename... S>
+concept __vml_batch_compatible =
+    __vml_batch_range<R> && (__vml_batch_range<S> && ...) &&
+    (std::same_as<__vml_batch_value_t<R>, __vml_batch_value_t<S>> && ...);
+
+template <typename R>
+using __vml_batch_scalar_t =
+    typename __vml_batch_element<__vml_batch_value_t<R>>::scalar_type;
+
+/// Number of scalars in the range \p r
+template <typename R>
+size_t __vml_batch_size(R const& r) {
+    using E = __vml_batch_element<__vml_batch_value_t<R>>;
+    return std::ranges::size(r) * E::lanes;
+}
+
+template <typename R>
+__vml_batch_scalar_t<R> const* __vml_batch_in(R const& r) {
+    return reinterpret_cast<__vml_batch_scalar_t<R> const*>(
+        std::ranges::data(r));
+}
+
+template <typename R>
+__vml_batch_scalar_t<R>* __vml_batch_out(R&& r) {
+    return reinterpret_cast<__vml_batch_scalar_t<R>*>(std::ranges::data(r));
+}
+
+/// Element-wise `out[i] = NAME(a[i], b[i])`
+#define __VML_PRIV_BATCH_BINARY(NAME)                                          \
+    template <typename A, typename B, typename Out>                            \
+        requires __vml_batch_compatible<Out, A, B>                             \
+    void NAME(A const& a, B const& b, Out&& out) {                             \
+        using T = __vml_batch_scalar_t<Out>;                                   \
+        __vml_expect(std::ranges::size(a) == std::ranges::size(out));          \
+        __vml_expect(std::ranges::size(b) == std::ranges::size(out));          \
+        __vml_batch_kernel(NAME, T)(__vml_batch_in(a), __vml_batch_in(b),      \
+                                    __vml_batch_out(out),                      \
+                                    __vml_batch_size(out));                    \
+    }
+
+__VML_PRIV_BATCH_BINARY(add)
+__VML_PRIV_BATCH_BINARY(sub)
+__VML_PRIV_BATCH_BINARY(mul)
+__VML_PRIV_BATCH_BINARY(div)
+__VML_PRIV_BATCH_BINARY(min)
+__VML_PRIV_BATCH_BINARY(max)
+
+#undef __VML_PRIV_BATCH_BINARY
+
+/// `out[i] = sqrt(a[i])`
+template <typename A, typename Out>
+    requires __vml_batch_compatible<Out, A>
+void sqrt(A const& a, Out&& out) {
+    using T = __vml_batch_scalar_t<Out>;
+    __vml_expect(std::ranges::size(a) == std::ranges::size(out));
+    __vml_batch_kernel(sqrt, T)(__vml_batch_in(a), __vml_batch_out(out),
+                                __vml_batch_size(out));
+}
+
+/// `out[i] = a[i] * s`
+template <typename A, typename Out>
+    requires __vml_batch_compatible<Out, A>
+void mul(A const& a, __vml_batch_scalar_t<Out> s, Out&& out) {
+    using T = __vml_batch_scalar_t<Out>;
+    __vml_expect(std::ranges::size(a) == std::ranges::size(out));
+    __vml_batch_kernel(scale, T)(__vml_batch_in(a), s, __vml_batch_out(out),
+                                 __vml_batch_size(out));
+}
+
+/// `out[i] = a[i] * b[i] + c[i]`
+/// The AVX2 and AVX-512 kernels round once, the SSE2 kernel rounds twice
+/// unless the compiler targets FMA. With `VML_DETERMINISTIC` all kernels
+/// round twice.
+template <typename A, typename B, typename C, typename Out>
+    requires __vml_batch_compatible<Out, A, B, C>
+void fma(A const& a, B const& b, C const& c, Out&& out) {
+    using T = __vml_batch_scalar_t<Out>;
+    __vml_expect(std::ranges::size(a) == std::ranges::size(out));
+    __vml_expect(std::ranges::size(b) == std::ranges::size(out));
+    __vml_expect(std::ranges::size(c) == std::ranges::size(out));
+    __vml_batch_kernel(fma, T)(__vml_batch_in(a), __vml_batch_in(b),
+                               __vml_batch_in(c), __vml_batch_out(out),
+                               __vml_batch_size(out));
+}
+
+/// `out[i] = a[i] * s + c[i]`
+template <typename A, typename C, typename Out>
+    requires __vml_batch_compatible<Out, A, C>
+void fma(A const& a, __vml_batch_scalar_t<Out> s, C const& c, Out&& out) {
+    using T = __vml_batch_scalar_t<Out>;
+    __vml_expect(std::ranges::size(a) == std::ranges::size(out));
+    __vml_expect(std::ranges::size(c) == std::ranges::size(out));
+    __vml_batch_kernel(fma_scalar, T)(__vml_batch_in(a), s, __vml_batch_in(c),
+                                      __vml_batch_out(out),
+                                      __vml_batch_size(out));
+}
+
+/// MARK: - Compensated Reductions
+/// The sums are as accurate as if computed in twice the working precision,
+/// see `sum_compensated(vector)`. For a given instruction set the order of
+/// the additions is fixed, so the results do not depend on alignment.
+
+/// Arrays of vectors with at most 16 scalars each
+template <typename R>
+concept __vml_batch_reducible =
+    __vml_batch_range<R> &&
+    __vml_batch_element<__vml_batch_value_t<R>>::lanes <= 16;
+
+/// Number of components of the elements of `R`, without padding
+template <typename R>
+constexpr size_t __vml_batch_dim() {
+    using V = __vml_batch_value_t<R>;
+    if constexpr (std::floating_point<V>) {
+        return 1;
+    }
+    else {
+        return V::size();
+    }
+}
+
+/// Sum of the elements of \p r, e.g. a `float3` for an array of `float3`
+template <typename R>
+    requires __vml_batch_reducible<R>
+__vml_batch_value_t<R> sum_compensated(R const& r) {
+    using T = __vml_batch_scalar_t<R>;
+    constexpr size_t lanes =
+        __vml_batch_element<__vml_batch_value_t<R>>::lanes;
+    T sum[lanes], err[lanes];
+    __vml_batch_kernel(sum_compensated, T)(__vml_batch_in(r),
+                                           __vml_batch_size(r), lanes, sum,
+                                           err);
+    if constexpr (lanes == 1) {
+        return sum[0] + err[0];
+    }
+    else {
+        return __vml_batch_value_t<R>(
+            [&](size_t k) { return sum[k] + err[k]; });
+    }
+}
+
+/// Sum of `dot(a[i], b[i])`
+template <typename A, typename B>
+    requires __vml_batch_reducible<A> && __vml_batch_compatible<A, B>
+__vml_batch_scalar_t<A> dot_compensated(A const& a, B const& b) {
+    using T = __vml_batch_scalar_t<A>;
+    constexpr size_t lanes =
+        __vml_batch_element<__vml_batch_value_t<A>>::lanes;
+    __vml_expect(std::ranges::size(a) == std::ranges::size(b));
+    T sum[lanes], err[lanes];
+    __vml_batch_kernel(dot_compensated, T)(__vml_batch_in(a),
+                                           __vml_batch_in(b),
+                                           __vml_batch_size(a), lanes, sum,
+                                           err);
+    // Padding lanes are skipped
+    T s = 0, c = 0;
+    for (size_t k = 0; k < __vml_batch_dim<A>(); ++k) {
+        T e;
+        s = __vml_two_sum(s, sum[k], e);
+        c += e + err[k];
+    }
+    return s + c;
+}
+
+/// Sum of `norm_squared(r[i])`
+template <typename R>
+    requires __vml_batch_reducible<R>
+__vml_batch_scalar_t<R> norm_squared_compensated(R const& r) {
+    return batch::dot_compensated(r, r);
+}
+
+/// MARK: - Conversions
+
+/// Scalar type and number of stored scalars of elements of `float`, `half`
+/// and `bfloat16` arrays
+template <typename T>
+struct __vml_convert_element {
+    using scalar_type = T;
+    static constexpr size_t lanes = 1;
+};
+
+template <typename T, size_t Size, vector_options O>
+struct __vml_convert_element<vector<T, Size, O>> {
+    using scalar_type = T;
+    static constexpr size_t lanes = vector<T, Size, O>::data_size();
+};
+
+template <typename R>
+using __vml_convert_scalar_t = typename __vml_convert_element<
+    __vml_batch_value_t<R>>::scalar_type;
+
+/// `From` and `To` are contiguous ranges of `float` and a 16 bit float type
+/// or vice versa, or of vectors of them with the same size and padding
+template <typename From, typename To>
+concept __vml_batch_convertible =
+    std::ranges::contiguous_range<From> && std::ranges::sized_range<From> &&
+    std::ranges::contiguous_range<To> && std::ranges::sized_range<To> &&
+    (__vml_convert_element<__vml_batch_value_t<From>>::lanes ==
+     __vml_convert_element<__vml_batch_value_t<To>>::lanes) &&
+    (sizeof(__vml_batch_value_t<From>) ==
+         __vml_convert_element<__vml_batch_value_t<From>>::lanes *
+             sizeof(__vml_convert_scalar_t<From>) &&
+     sizeof(__vml_batch_value_t<To>) ==
+         __vml_convert_element<__vml_batch_value_t<To>>::lanes *
+             sizeof(__vml_convert_scalar_t<To>)) &&
+    ((std::same_as<__vml_convert_scalar_t<From>, float> &&
+      __vml_float16<__vml_convert_scalar_t<To>>) ||
+     (__vml_float16<__vml_convert_scalar_t<From>> &&
+      std::same_as<__vml_convert_scalar_t<To>, float>));
+
+/// `out[i] = in[i]` between arrays of `float` and `half` or `bfloat16`, e.g.
+/// from `float4` to `half4`. `half` conversions use F16C on the AVX2 and
+/// AVX-512 kernels, `bfloat16` conversions are plain shifts and left to the
+/// compiler.
+template <typename In, typename Out>
+    requires __vml_batch_convertible<In, Out>
+void convert(In const& in, Out&& out) {
+    using From = __vml_convert_scalar_t<In>;
+    using To = __vml_convert_scalar_t<Out>;
+    __vml_expect(std::ranges::size(in) == std::ranges::size(out));
+    size_t const n = std::ranges::size(out) *
+                     __vml_convert_element<__vml_batch_value_t<Out>>::lanes;
+    auto const* const src = reinterpret_cast<From const*>(
+        std::ranges::data(in));
+    auto* const dest = reinterpret_cast<To*>(std::ranges::data(out));
+    if constexpr (std::same_as<To, half>) {
+        __vml_batch_kernel(to_half, float)(
+            src, reinterpret_cast<std::uint16_t*>(dest), n);
+    }
+    else if constexpr (std::same_as<From, half>) {
+        __vml_batch_kernel(from_half, float)(
+            reinterpret_cast<std::uint16_t const*>(src), dest, n);
+    }
+    else {
+        for (size_t i = 0; i < n; ++i) {
+            dest[i] = To(src[i]);
+        }
+    }
+}
+
+} // namespace _VVML::batch
+
+/// MARK: - Transforms
+
+namespace _VVML {
+
+enum class __vml_transform_kind { points, projective_points, vectors };
+
+/// Runs the transform kernel selected by \p kind. \p m holds the 4x4 matrix
+/// in row major order.
+template <typename T>
+void __vml_transform(__vml_transform_kind kind, T const* m,
+                     __vml_strided<T const*> in, __vml_strided<T*> out,
+                     size_t n) {
+    switch (kind) {
+    case __vml_transform_kind::points:
+        __vml_batch_kernel(transform_points, T)(m, in, out, n);
+        return;
+    case __vml_transform_kind::projective_points:
+        __vml_batch_kernel(transform_projective_points, T)(m, in, out, n);
+        return;
+    case __vml_transform_kind::vectors:
+        __vml_batch_kernel(transform_vectors, T)(m, in, out, n);
+        return;
+    }
+}
+
+/// The coefficients of \p m in row major order. Points are only divided by
+/// `w` if the last row of \p m is not `(0, 0, 0, 1)`.
+template <typename T, vector_options O>
+std::array<T, 16> __vml_transform_matrix(matrix4x4<T, O> const& m,
+                                         __vml_transform_kind& kind) {
+    std::array<T, 16> result;
+    for (size_t i = 0; i < 16; ++i) {
+        result[i] = m.__vml_at(i / 4, i % 4);
+    }
+    if (kind == __vml_transform_kind::points &&
+        !(result[12] == 0 && result[13] == 0 && result[14] == 0 &&
+          result[15] == 1))
+    {
+        kind = __vml_transform_kind::projective_points;
+    }
+    return result;
+}
+
+/// The inverse transpose of the linear part of \p m. Its columns are the
+/// cross products of the columns of \p m divided by the determinant.
+template <typename T, vector_options O>
+std::array<T, 16> __vml_normal_matrix(matrix4x4<T, O> const& m) {
+    auto const column = [&](size_t j) {
+        return vector3<T, O>(m.__vml_at(0, j), m.__vml_at(1, j),
+                             m.__vml_at(2, j));
+    };
+    vector3<T, O> const c0 = column(0), c1 = column(1), c2 = column(2);
+    vector3<T, O> r[3] = { cross(c1, c2), cross(c2, c0), cross(c0, c1) };
+    T const d = dot(c0, r[0]);
+    __vml_expect(d != 0);
+    std::array<T, 16> result{};
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            result[i * 4 + j] = r[j].__vml_at(i) / d;
+        }
+    }
+    result[15] = 1;
+    return result;
+}
+
+/// Ranges of 3-vectors with scalar type `T`, packed or aligned
+template <typename R, typename T>
+concept __vml_vector3_range =
+    batch::__vml_batch_range<R> &&
+    std::same_as<batch::__vml_batch_scalar_t<R>, T> &&
+    (batch::__vml_batch_value_t<R>::size() == 3);
+
+template <typename T, typename In, typename Out>
+void __vml_transform_range(__vml_transform_kind kind,
+                           std::array<T, 16> const& m, In const& in,
+                           Out&& out) {
+    __vml_expect(std::ranges::size(in) == std::ranges::size(out));
+    constexpr size_t in_stride = batch::__vml_batch_value_t<In>::data_size();
+    constexpr size_t out_stride = batch::__vml_batch_value_t<Out>::data_size();
+    __vml_transform<T>(kind, m.data(),
+                       { batch::__vml_batch_in(in), in_stride, 1 },
+                       { batch::__vml_batch_out(out), out_stride, 1 },
+                       std::ranges::size(out));
+}
+
+/// `out[i] = m * (in[i], 1)`. The matrix is kept in registers and 4 to 16
+/// points are transformed at once, depending on the instruction set. If the
+/// last row of \p m is not `(0, 0, 0, 1)` the results are divided by `w`.
+/// \p in and \p out may be the same range.
+template <typename T, vector_options O, typename In, typename Out>
+    requires __vml_vector3_range<In, T> && __vml_vector3_range<Out, T>
+void transform_points(matrix4x4<T, O> const& m, In const& in, Out&& out) {
+    auto kind = __vml_transform_kind::points;
+    auto const coefficients = __vml_transform_matrix(m, kind);
+    __vml_transform_range<T>(kind, coefficients, in, out);
+}
+
+/// `out[i] = m * (in[i], 0)`, i.e. directions ignore the translation of \p m
+template <typename T, vector_options O, typename In, typename Out>
+    requires __vml_vector3_range<In, T> && __vml_vector3_range<Out, T>
+void transform_vectors(matrix4x4<T, O> const& m, In const& in, Out&& out) {
+    auto kind = __vml_transform_kind::vectors;
+    auto const coefficients = __vml_transform_matrix(m, kind);
+    __vml_transform_range<T>(kind, coefficients, in, out);
+}
+
+/// Transforms normals by the inverse transpose of the linear part of \p m,
+/// so they stay perpendicular to transformed surfaces. The results are not
+/// renormalized.
+template <typename T, vector_options O, typename In, typename Out>
+    requires __vml_vector3_range<In, T> && __vml_vector3_range<Out, T>
+void transform_normals(matrix4x4<T, O> const& m, In const& in, Out&& out) {
+    __vml_transform_range<T>(__vml_transform_kind::vectors,
+                                __vml_normal_matrix(m), in, out);
+}
+
+/// MARK: - Quaternions
+
+/// The coefficients of the matrix of `rotate(v, q)` in row major order, the
+/// rotation matrix of \p q if \p q has unit length
+template <typename T>
+std::array<T, 16> __vml_rotation_matrix(quaternion<T> const& q) {
+    T const w = q.__vml_at(0), x = q.__vml_at(1), y = q.__vml_at(2),
+            z = q.__vml_at(3);
+    return { w * w + x * x - y * y - z * z,
+             2 * (x * y - w * z),
+             2 * (x * z + w * y),
+             0,
+             2 * (x * y + w * z),
+             w * w - x * x + y * y - z * z,
+             2 * (y * z - w * x),
+             0,
+             2 * (x * z - w * y),
+             2 * (y * z + w * x),
+             w * w - x * x - y * y + z * z,
+             0,
+             0,
+             0,
+             0,
+             1 };
+}
+
+/// Contiguous ranges of `quaternion<T>`
+template <typename R, typename T>
+concept __vml_quaternion_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    std::same_as<batch::__vml_batch_value_t<R>, quaternion<T>> &&
+    (std::same_as<T, float> || std::same_as<T, double>);
+
+/// Contiguous ranges of 3x3 or 4x4 matrices of `T`, packed or aligned
+template <typename R, typename T>
+concept __vml_rotation_matrix_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    std::same_as<typename batch::__vml_batch_value_t<R>::value_type, T> &&
+    batch::__vml_batch_value_t<R>::rows() ==
+        batch::__vml_batch_value_t<R>::columns() &&
+    (batch::__vml_batch_value_t<R>::rows() == 3 ||
+     batch::__vml_batch_value_t<R>::rows() == 4);
+
+template <typename R>
+auto __vml_quaternions_in(R const& r) {
+    using T = typename batch::__vml_batch_value_t<R>::value_type;
+    return __vml_strided<T const*>{
+        reinterpret_cast<T const*>(std::ranges::data(r)), 4, 1
+    };
+}
+
+/// `out[i] = rotate(in[i], q)`. \p q is converted to a matrix once and the
+/// vectors go through the `transform_vectors` kernel. \p in and \p out may
+/// be the same range.
+template <typename T, typename In, typename Out>
+    requires __vml_vector3_range<In, T> && __vml_vector3_range<Out, T>
+void rotate(In const& in, quaternion<T> const& q, Out&& out) {
+    __vml_transform_range<T>(__vml_transform_kind::vectors,
+                             __vml_rotation_matrix(q), in, out);
+}
+
+/// `out[i] = rotate(in[i], q[i])`, 2 to 8 vectors at a time depending on the
+/// instruction set
+template <typename In, typename Q, typename Out,
+          typename T = batch::__vml_batch_scalar_t<Out>>
+    requires __vml_vector3_range<In, T> && __vml_quaternion_range<Q, T> &&
+             __vml_vector3_range<Out, T>
+void rotate(In const& in, Q const& q, Out&& out) {
+    __vml_expect(std::ranges::size(in) == std::ranges::size(out));
+    __vml_expect(std::ranges::size(q) == std::ranges::size(out));
+    constexpr size_t in_stride = batch::__vml_batch_value_t<In>::data_size();
+    constexpr size_t out_stride = batch::__vml_batch_value_t<Out>::data_size();
+    __vml_batch_kernel(rotate, T)(
+        __vml_quaternions_in(q), { batch::__vml_batch_in(in), in_stride, 1 },
+        { batch::__vml_batch_out(out), out_stride, 1 },
+        std::ranges::size(out));
+}
+
+/// `out[i] = a[i] * b[i]`. \p out may be the same range as \p a or \p b.
+template <typename A, typename B, typename Out,
+          typename T = typename batch::__vml_batch_value_t<Out>::value_type>
+    requires __vml_quaternion_range<A, T> && __vml_quaternion_range<B, T> &&
+             __vml_quaternion_range<Out, T>
+void multiply_quaternions(A const& a, B const& b, Out&& out) {
+    __vml_expect(std::ranges::size(a) == std::ranges::size(out));
+    __vml_expect(std::ranges::size(b) == std::ranges::size(out));
+    __vml_batch_kernel(multiply_quaternions, T)(
+        __vml_quaternions_in(a), __vml_quaternions_in(b),
+        { reinterpret_cast<T*>(std::ranges::data(out)), 4, 1 },
+        std::ranges::size(out));
+}
+
+/// Writes the matrix of `rotate(v, q[i])` to `out[i]`, which is the rotation
+/// matrix of `q[i]` for unit quaternions. `out` holds `matrix3x3` or
+/// `matrix4x4`, the latter with no translation.
+template <typename Q, typename Out,
+          typename T = typename batch::__vml_batch_value_t<Out>::value_type>
+    requires __vml_quaternion_range<Q, T> &&
+             __vml_rotation_matrix_range<Out, T>
+void rotation_matrices(Q const& q, Out&& out) {
+    using M = batch::__vml_batch_value_t<Out>;
+    __vml_expect(std::ranges::size(q) == std::ranges::size(out));
+    __vml_batch_kernel(rotation_matrices, T)(
+        __vml_quaternions_in(q), M::rows(), M::data_size() / M::rows(),
+        { reinterpret_cast<T*>(std::ranges::data(out)), M::data_size(), 1 },
+        std::ranges::size(out));
+}
+
+/// MARK: - Decompositions
+
+template <typename>
+struct __vml_is_matrix3: std::false_type {};
+
+template <typename T, vector_options O>
+    requires std::same_as<T, float> || std::same_as<T, double>
+struct __vml_is_matrix3<matrix3x3<T, O>>: std::true_type {};
+
+/// Contiguous ranges of the 3x3 matrix type `M` of `float` or `double`,
+/// packed or aligned
+template <typename R, typename M>
+concept __vml_matrix3_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    std::same_as<batch::__vml_batch_value_t<R>, M> &&
+    __vml_is_matrix3<M>::value;
+
+template <typename R>
+auto __vml_matrix3_in(R const& r) {
+    using M = batch::__vml_batch_value_t<R>;
+    using T = typename M::value_type;
+    return __vml_strided<T const*>{
+        reinterpret_cast<T const*>(std::ranges::data(r)), M::data_size(), 1
+    };
+}
+
+template <typename R>
+auto __vml_matrix3_out(R&& r) {
+    using M = batch::__vml_batch_value_t<R>;
+    using T = typename M::value_type;
+    return __vml_strided<T*>{ reinterpret_cast<T*>(std::ranges::data(r)),
+                              M::data_size(), 1 };
+}
+
+/// `values[i]` and `vectors[i]` of `eigen_symmetric(in[i])`, 2 to 16
+/// matrices at a time depending on the instruction set
+template <typename In, typename Values, typename Vectors,
+          typename M = batch::__vml_batch_value_t<In>,
+          typename T = typename M::value_type>
+    requires __vml_matrix3_range<In, M> && __vml_vector3_range<Values, T> &&
+             __vml_matrix3_range<Vectors, M>
+void eigen_symmetric(In const& in, Values&& values, Vectors&& vectors) {
+    constexpr size_t values_stride =
+        batch::__vml_batch_value_t<Values>::data_size();
+    __vml_expect(std::ranges::size(in) == std::ranges::size(values));
+    __vml_expect(std::ranges::size(in) == std::ranges::size(vectors));
+    __vml_batch_kernel(eigen_symmetric, T)(
+        __vml_matrix3_in(in), M::data_size() / 3,
+        { batch::__vml_batch_out(values), values_stride, 1 },
+        __vml_matrix3_out(vectors), std::ranges::size(in));
+}
+
+/// `u[i]`, `sigma[i]` and `v[i]` of `svd(in[i])`
+template <typename In, typename U, typename Sigma, typename V,
+          typename M = batch::__vml_batch_value_t<In>,
+          typename T = typename M::value_type>
+    requires __vml_matrix3_range<In, M> && __vml_matrix3_range<U, M> &&
+             __vml_vector3_range<Sigma, T> && __vml_matrix3_range<V, M>
+void svd(In const& in, U&& u, Sigma&& sigma, V&& v) {
+    constexpr size_t sigma_stride =
+        batch::__vml_batch_value_t<Sigma>::data_size();
+    __vml_expect(std::ranges::size(in) == std::ranges::size(u));
+    __vml_expect(std::ranges::size(in) == std::ranges::size(sigma));
+    __vml_expect(std::ranges::size(in) == std::ranges::size(v));
+    __vml_batch_kernel(svd, T)(
+        __vml_matrix3_in(in), M::data_size() / 3, __vml_matrix3_out(u),
+        { batch::__vml_batch_out(sigma), sigma_stride, 1 },
+        __vml_matrix3_out(v), std::ranges::size(in));
+}
+
+/// `rotation[i]` and `stretch[i]` of `polar_decompose(in[i])`. \p rotation
+/// may be the same range as \p in.
+template <typename In, typename Rotation, typename Stretch,
+          typename M = batch::__vml_batch_value_t<In>,
+          typename T = typename M::value_type>
+    requires __vml_matrix3_range<In, M> &&
+             __vml_matrix3_range<Rotation, M> &&
+             __vml_matrix3_range<Stretch, M>
+void polar_decompose(In const& in, Rotation&& rotation, Stretch&& stretch) {
+    __vml_expect(std::ranges::size(in) == std::ranges::size(rotation));
+    __vml_expect(std::ranges::size(in) == std::ranges::size(stretch));
+    __vml_batch_kernel(polar_decompose, T)(
+        __vml_matrix3_in(in), M::data_size() / 3,
+        __vml_matrix3_out(rotation), __vml_matrix3_out(stretch),
+        std::ranges::size(in));
+}
+
+/// MARK: - Normalization
+
+/// Ranges of 3- or 4-vectors of `float` or `double`, packed or aligned
+template <typename R>
+concept __vml_normalizable_range =
+    batch::__vml_batch_range<R> &&
+    (batch::__vml_batch_value_t<R>::size() == 3 ||
+     batch::__vml_batch_value_t<R>::size() == 4);
+
+/// `out[i] = normalize_approx<P>(in[i])`, 4 to 16 vectors at a time
+/// depending on the instruction set. The squared norms are not guarded
+/// against overflow, not even with `normalize_precision::exact`. \p in and
+/// \p out may be the same range.
+template <normalize_precision P = normalize_precision::rsqrt_newton,
+          typename In, typename Out>
+    requires __vml_normalizable_range<In> &&
+             batch::__vml_batch_compatible<Out, In>
+void normalize_approx(In const& in, Out&& out) {
+    using T = batch::__vml_batch_scalar_t<Out>;
+    using V = batch::__vml_batch_value_t<Out>;
+    __vml_expect(std::ranges::size(in) == std::ranges::size(out));
+    __vml_batch_kernel(normalize, T)(
+        P, V::size(), { batch::__vml_batch_in(in), V::data_size(), 1 },
+        { batch::__vml_batch_out(out), V::data_size(), 1 },
+        std::ranges::size(out));
+}
+
+/// MARK: - Hashing
+
+template <typename>
+struct __vml_is_hashable_vector: std::false_type {};
+
+template <__vml_hashable T, size_t Size, vector_options O>
+struct __vml_is_hashable_vector<vector<T, Size, O>>: std::true_type {};
+
+/// `out[i] = std::hash<vector>{}(in[i])` for vectors of integers, `float` or
+/// `double`. The 64 bit multiplies of the mixing steps run 2 to 8 vectors at
+/// a time depending on the instruction set.
+template <typename In, typename Out>
+    requires std::ranges::contiguous_range<In> &&
+             std::ranges::sized_range<In> &&
+             __vml_is_hashable_vector<batch::__vml_batch_value_t<In>>::value &&
+             std::ranges::contiguous_range<Out> &&
+             std::same_as<batch::__vml_batch_value_t<Out>, size_t>
+void hash_many(In const& in, Out&& out) {
+    using V = batch::__vml_batch_value_t<In>;
+    using T = typename V::value_type;
+    static_assert(sizeof(V) == V::data_size() * sizeof(T));
+    __vml_expect(std::ranges::size(in) == std::ranges::size(out));
+    __vml_batch_kernel(hash, T)(
+        reinterpret_cast<T const*>(std::ranges::data(in)), V::size(),
+        V::data_size(), std::ranges::data(out), std::ranges::size(in));
+}
+
+} // namespace _VVML
+
+#endif // __VML_BATCH_HPP_INCLUDED__
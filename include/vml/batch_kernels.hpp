@@ -0,0 +1,1091 @@
+/// Batch kernels, written once against the `__simd<T>` interface and compiled
+/// once per instruction set by "batch.hpp".
+///
+/// We have no include guard, before every inclusion `__VML_BATCH_ISA` must
+/// name a namespace that defines `__simd<float>`, `__simd<double>` and
+/// `__simd<std::uint64_t>`.
+
+namespace _VVML::__VML_BATCH_ISA {
+
+/// Computes `out[i] = f(in[i]...)`. The tail is routed through a local buffer
+/// so every element goes through the same instructions.
+template <typename T, typename F, typename... In>
+void __map(T* out, size_t n, F f, In const*... in) {
+    using S = __simd<T>;
+    size_t i = 0;
+    for (; i + S::width <= n; i += S::width) {
+        S::storeu(out + i, f(S::loadu(in + i)...));
+    }
+    if (i == n) {
+        return;
+    }
+    size_t const rest = n - i;
+    auto const load_rest = [&](T const* p) {
+        T buffer[S::width]{};
+        for (size_t j = 0; j < rest; ++j) {
+            buffer[j] = p[i + j];
+        }
+        return S::loadu(buffer);
+    };
+    T result[S::width];
+    S::storeu(result, f(load_rest(in)...));
+    for (size_t j = 0; j < rest; ++j) {
+        out[i + j] = result[j];
+    }
+}
+
+template <typename T>
+void add(T const* a, T const* b, T* out, size_t n) {
+    __map(out, n, [](auto x, auto y) { return __simd<T>::add(x, y); }, a, b);
+}
+
+template <typename T>
+void sub(T const* a, T const* b, T* out, size_t n) {
+    __map(out, n, [](auto x, auto y) { return __simd<T>::sub(x, y); }, a, b);
+}
+
+template <typename T>
+void mul(T const* a, T const* b, T* out, size_t n) {
+    __map(out, n, [](auto x, auto y) { return __simd<T>::mul(x, y); }, a, b);
+}
+
+template <typename T>
+void div(T const* a, T const* b, T* out, size_t n) {
+    __map(out, n, [](auto x, auto y) { return __simd<T>::div(x, y); }, a, b);
+}
+
+template <typename T>
+void min(T const* a, T const* b, T* out, size_t n) {
+    __map(out, n, [](auto x, auto y) { return __simd<T>::min(x, y); }, a, b);
+}
+
+template <typename T>
+void max(T const* a, T const* b, T* out, size_t n) {
+    __map(out, n, [](auto x, auto y) { return __simd<T>::max(x, y); }, a, b);
+}
+
+template <typename T>
+void sqrt(T const* a, T* out, size_t n) {
+    __map(out, n, [](auto x) { return __simd<T>::sqrt(x); }, a);
+}
+
+template <typename T>
+void fma(T const* a, T const* b, T const* c, T* out, size_t n) {
+    __map(
+        out, n,
+        [](auto x, auto y, auto z) { return __simd<T>::fma(x, y, z); }, a, b,
+        c);
+}
+
+template <typename T>
+void scale(T const* a, T s, T* out, size_t n) {
+    auto const v = __simd<T>::set1(s);
+    __map(out, n, [v](auto x) { return __simd<T>::mul(x, v); }, a);
+}
+
+template <typename T>
+void fma_scalar(T const* a, T s, T const* c, T* out, size_t n) {
+    auto const v = __simd<T>::set1(s);
+    __map(
+        out, n, [v](auto x, auto z) { return __simd<T>::fma(x, v, z); }, a, c);
+}
+
+/// Converts `n` floats to IEEE half precision, `__simd<T>` must provide
+/// `store_half`
+template <typename T>
+void to_half(T const* in, std::uint16_t* out, size_t n) {
+    using S = __simd<T>;
+    size_t i = 0;
+    for (; i + S::width <= n; i += S::width) {
+        S::store_half(out + i, S::loadu(in + i));
+    }
+    if (i == n) {
+        return;
+    }
+    T buffer[S::width]{};
+    for (size_t j = 0; i + j < n; ++j) {
+        buffer[j] = in[i + j];
+    }
+    std::uint16_t result[S::width];
+    S::store_half(result, S::loadu(buffer));
+    for (size_t j = 0; i + j < n; ++j) {
+        out[i + j] = result[j];
+    }
+}
+
+/// Converts `n` IEEE half precision floats to `T`, `__simd<T>` must provide
+/// `load_half`
+template <typename T>
+void from_half(std::uint16_t const* in, T* out, size_t n) {
+    using S = __simd<T>;
+    size_t i = 0;
+    for (; i + S::width <= n; i += S::width) {
+        S::storeu(out + i, S::load_half(in + i));
+    }
+    if (i == n) {
+        return;
+    }
+    std::uint16_t buffer[S::width]{};
+    for (size_t j = 0; i + j < n; ++j) {
+        buffer[j] = in[i + j];
+    }
+    T result[S::width];
+    S::storeu(result, S::load_half(buffer));
+    for (size_t j = 0; i + j < n; ++j) {
+        out[i + j] = result[j];
+    }
+}
+
+/// Loads component \p k of the \p count elements starting at \p i. Strided
+/// elements are gathered through a local buffer.
+template <typename T>
+typename __simd<T>::reg __load_strided(__vml_strided<T const*> in, size_t i,
+                                       size_t count, size_t k) {
+    using S = __simd<T>;
+    T const* const p =
+        in.data + i * in.element_stride + k * in.component_stride;
+    if (count == S::width && in.element_stride == 1) {
+        return S::loadu(p);
+    }
+    T buffer[S::width]{};
+    for (size_t j = 0; j < count; ++j) {
+        buffer[j] = p[j * in.element_stride];
+    }
+    return S::loadu(buffer);
+}
+
+/// Stores \p value to component \p k of the \p count elements starting at
+/// \p i. Strided elements are scattered from a local buffer.
+template <typename T>
+void __store_strided(__vml_strided<T*> out, size_t i, size_t count, size_t k,
+                     typename __simd<T>::reg value) {
+    using S = __simd<T>;
+    T* const p = out.data + i * out.element_stride + k * out.component_stride;
+    if (count == S::width && out.element_stride == 1) {
+        S::storeu(p, value);
+        return;
+    }
+    T buffer[S::width];
+    S::storeu(buffer, value);
+    for (size_t j = 0; j < count; ++j) {
+        p[j * out.element_stride] = buffer[j];
+    }
+}
+
+/// Applies the row major 4x4 matrix \p m to `n` 3-vectors with homogeneous
+/// coordinate `W`, `S::width` vectors at a time. With `Project` the results
+/// are divided by their transformed `w`.
+template <typename T, int W, bool Project>
+void __transform3(T const* m, __vml_strided<T const*> in,
+                  __vml_strided<T*> out, size_t n) {
+    using S = __simd<T>;
+    using reg = typename S::reg;
+    constexpr size_t rows = Project ? 4 : 3;
+    reg c[rows][4];
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            c[i][j] = S::set1(m[i * 4 + j]);
+        }
+    }
+    for (size_t i = 0; i < n; i += S::width) {
+        size_t const count = n - i < S::width ? n - i : S::width;
+        // All components are loaded before any is stored, so `in` and `out`
+        // may alias
+        reg const x = __load_strided(in, i, count, 0);
+        reg const y = __load_strided(in, i, count, 1);
+        reg const z = __load_strided(in, i, count, 2);
+        reg r[rows];
+        for (size_t k = 0; k < rows; ++k) {
+            reg v = S::mul(c[k][0], x);
+            v = S::fma(c[k][1], y, v);
+            v = S::fma(c[k][2], z, v);
+            if constexpr (W != 0) {
+                v = S::add(v, c[k][3]);
+            }
+            r[k] = v;
+        }
+        for (size_t k = 0; k < 3; ++k) {
+            if constexpr (Project) {
+                r[k] = S::div(r[k], r[rows - 1]);
+            }
+            __store_strided(out, i, count, k, r[k]);
+        }
+    }
+}
+
+template <typename T>
+void transform_points(T const* m, __vml_strided<T const*> in,
+                      __vml_strided<T*> out, size_t n) {
+    __transform3<T, 1, false>(m, in, out, n);
+}
+
+template <typename T>
+void transform_projective_points(T const* m, __vml_strided<T const*> in,
+                                 __vml_strided<T*> out, size_t n) {
+    __transform3<T, 1, true>(m, in, out, n);
+}
+
+template <typename T>
+void transform_vectors(T const* m, __vml_strided<T const*> in,
+                       __vml_strided<T*> out, size_t n) {
+    __transform3<T, 0, false>(m, in, out, n);
+}
+
+/// Normalizes `n` vectors of dimension `N` with precision `P`, `S::width`
+/// vectors at a time
+template <typename T, size_t N, normalize_precision P>
+void __normalize(__vml_strided<T const*> in, __vml_strided<T*> out,
+                 size_t n) {
+    using S = __simd<T>;
+    using reg = typename S::reg;
+    for (size_t i = 0; i < n; i += S::width) {
+        size_t const count = n - i < S::width ? n - i : S::width;
+        reg x[N];
+        for (size_t k = 0; k < N; ++k) {
+            x[k] = __load_strided(in, i, count, k);
+        }
+        reg n2 = S::mul(x[0], x[0]);
+        for (size_t k = 1; k < N; ++k) {
+            n2 = S::fma(x[k], x[k], n2);
+        }
+        if constexpr (P == normalize_precision::exact) {
+            reg const r = S::sqrt(n2);
+            for (size_t k = 0; k < N; ++k) {
+                x[k] = S::div(x[k], r);
+            }
+        }
+        else {
+            reg r;
+            if constexpr (P == normalize_precision::fast) {
+                r = S::div(S::set1(1), S::sqrt(n2));
+            }
+            else {
+                r = S::rsqrt(n2);
+            }
+            if constexpr (P == normalize_precision::rsqrt_newton) {
+                reg const h = S::mul(S::mul(S::set1(T(0.5)), n2), r);
+                r = S::mul(r, S::sub(S::set1(T(1.5)), S::mul(h, r)));
+            }
+            for (size_t k = 0; k < N; ++k) {
+                x[k] = S::mul(x[k], r);
+            }
+        }
+        for (size_t k = 0; k < N; ++k) {
+            __store_strided(out, i, count, k, x[k]);
+        }
+    }
+}
+
+template <typename T, size_t N>
+void __normalize(normalize_precision precision, __vml_strided<T const*> in,
+                 __vml_strided<T*> out, size_t n) {
+#if VML_DETERMINISTIC
+    // The estimates differ between CPU vendors
+    if (precision != normalize_precision::exact) {
+        precision = normalize_precision::fast;
+    }
+#endif
+    switch (precision) {
+    case normalize_precision::exact:
+        __normalize<T, N, normalize_precision::exact>(in, out, n);
+        return;
+    case normalize_precision::fast:
+        __normalize<T, N, normalize_precision::fast>(in, out, n);
+        return;
+    case normalize_precision::rsqrt_newton:
+        __normalize<T, N, normalize_precision::rsqrt_newton>(in, out, n);
+        return;
+    case normalize_precision::rsqrt:
+        __normalize<T, N, normalize_precision::rsqrt>(in, out, n);
+        return;
+    }
+}
+
+/// Normalizes `n` vectors of dimension \p dim, which must be 2, 3 or 4
+template <typename T>
+void normalize(normalize_precision precision, size_t dim,
+               __vml_strided<T const*> in, __vml_strided<T*> out, size_t n) {
+    __vml_expect(dim >= 2 && dim <= 4);
+    switch (dim) {
+    case 2:
+        __normalize<T, 2>(precision, in, out, n);
+        return;
+    case 3:
+        __normalize<T, 3>(precision, in, out, n);
+        return;
+    case 4:
+        __normalize<T, 4>(precision, in, out, n);
+        return;
+    }
+}
+
+/// MARK: - Quaternions
+
+/// Quaternions are strided 4-vectors with the real part in component 0. All
+/// inputs are loaded before any output is stored, so outputs may alias
+/// inputs.
+
+/// `out[i] = q[i] * (0, in[i]) * conj(q[i])` as
+/// `(w^2 - u.u) v + 2 (u.v) u + 2 w (u x v)`
+template <typename T>
+void rotate(__vml_strided<T const*> q, __vml_strided<T const*> in,
+            __vml_strided<T*> out, size_t n) {
+    using S = __simd<T>;
+    using reg = typename S::reg;
+    reg const two = S::set1(2);
+    for (size_t i = 0; i < n; i += S::width) {
+        size_t const count = n - i < S::width ? n - i : S::width;
+        reg const w = __load_strided(q, i, count, 0);
+        reg u[3], v[3];
+        for (size_t k = 0; k < 3; ++k) {
+            u[k] = __load_strided(q, i, count, k + 1);
+            v[k] = __load_strided(in, i, count, k);
+        }
+        auto const dot = [](reg const* p, reg const* q) {
+            return S::fma(p[2], q[2], S::fma(p[1], q[1], S::mul(p[0], q[0])));
+        };
+        reg const a = S::sub(S::mul(w, w), dot(u, u));
+        reg const b = S::mul(two, dot(u, v));
+        reg const c = S::mul(two, w);
+        for (size_t k = 0; k < 3; ++k) {
+            size_t const k1 = (k + 1) % 3, k2 = (k + 2) % 3;
+            reg const cross =
+                S::sub(S::mul(u[k1], v[k2]), S::mul(u[k2], v[k1]));
+            reg const r = S::fma(c, cross, S::fma(b, u[k], S::mul(a, v[k])));
+            __store_strided(out, i, count, k, r);
+        }
+    }
+}
+
+/// `out[i] = a[i] * b[i]`
+template <typename T>
+void multiply_quaternions(__vml_strided<T const*> a, __vml_strided<T const*> b,
+                          __vml_strided<T*> out, size_t n) {
+    using S = __simd<T>;
+    using reg = typename S::reg;
+    for (size_t i = 0; i < n; i += S::width) {
+        size_t const count = n - i < S::width ? n - i : S::width;
+        reg x[4], y[4];
+        for (size_t k = 0; k < 4; ++k) {
+            x[k] = __load_strided(a, i, count, k);
+            y[k] = __load_strided(b, i, count, k);
+        }
+        // Same terms as `operator*(quaternion, quaternion)`
+        reg const r0 = S::sub(
+            S::sub(S::sub(S::mul(x[0], y[0]), S::mul(x[1], y[1])),
+                   S::mul(x[2], y[2])),
+            S::mul(x[3], y[3]));
+        reg const r1 = S::sub(
+            S::add(S::add(S::mul(x[0], y[1]), S::mul(x[1], y[0])),
+                   S::mul(x[2], y[3])),
+            S::mul(x[3], y[2]));
+        reg const r2 = S::add(
+            S::add(S::sub(S::mul(x[0], y[2]), S::mul(x[1], y[3])),
+                   S::mul(x[2], y[0])),
+            S::mul(x[3], y[1]));
+        reg const r3 = S::add(
+            S::sub(S::add(S::mul(x[0], y[3]), S::mul(x[1], y[2])),
+                   S::mul(x[2], y[1])),
+            S::mul(x[3], y[0]));
+        __store_strided(out, i, count, 0, r0);
+        __store_strided(out, i, count, 1, r1);
+        __store_strided(out, i, count, 2, r2);
+        __store_strided(out, i, count, 3, r3);
+    }
+}
+
+/// Writes the matrices of `rotate(v, q[i])` to `n` row major \p dim x \p dim
+/// matrices, \p dim is 3 or 4. Rows are \p row_stride scalars apart, padding
+/// is zeroed. `out.component_stride` is ignored.
+template <typename T>
+void rotation_matrices(__vml_strided<T const*> q, size_t dim,
+                       size_t row_stride, __vml_strided<T*> out, size_t n) {
+    using S = __simd<T>;
+    using reg = typename S::reg;
+    reg const two = S::set1(2), zero = S::set1(0);
+    out.component_stride = 1;
+    for (size_t i = 0; i < n; i += S::width) {
+        size_t const count = n - i < S::width ? n - i : S::width;
+        reg const w = __load_strided(q, i, count, 0);
+        reg const x = __load_strided(q, i, count, 1);
+        reg const y = __load_strided(q, i, count, 2);
+        reg const z = __load_strided(q, i, count, 3);
+        reg const ww = S::mul(w, w), xx = S::mul(x, x);
+        reg const yy = S::mul(y, y), zz = S::mul(z, z);
+        reg const xy = S::mul(two, S::mul(x, y));
+        reg const xz = S::mul(two, S::mul(x, z));
+        reg const yz = S::mul(two, S::mul(y, z));
+        reg const wx = S::mul(two, S::mul(w, x));
+        reg const wy = S::mul(two, S::mul(w, y));
+        reg const wz = S::mul(two, S::mul(w, z));
+        reg const m[3][3] = {
+            { S::sub(S::add(ww, xx), S::add(yy, zz)), S::sub(xy, wz),
+              S::add(xz, wy) },
+            { S::add(xy, wz), S::sub(S::add(ww, yy), S::add(xx, zz)),
+              S::sub(yz, wx) },
+            { S::sub(xz, wy), S::add(yz, wx),
+              S::sub(S::add(ww, zz), S::add(xx, yy)) },
+        };
+        for (size_t r = 0; r < dim; ++r) {
+            for (size_t c = 0; c < row_stride; ++c) {
+                reg const value = r < 3 && c < 3 ? m[r][c]
+                                  : r == 3 && c == 3 ? S::set1(1)
+                                                     : zero;
+                __store_strided(out, i, count, r * row_stride + c, value);
+            }
+        }
+    }
+}
+
+/// MARK: - Decompositions
+
+/// 3x3 matrices are strided with element `(r, c)` in component
+/// `r * row_stride + c`. Stores zero the padding of aligned rows. The steps
+/// are the same as in `eigen_symmetric()`, `svd()` and `polar_decompose()`
+/// in "ext.hpp", with selects in place of branches.
+
+template <typename T>
+void __load_matrix3(__vml_strided<T const*> in, size_t row_stride, size_t i,
+                    size_t count, typename __simd<T>::reg (&m)[3][3]) {
+    for (size_t r = 0; r < 3; ++r) {
+        for (size_t c = 0; c < 3; ++c) {
+            m[r][c] = __load_strided(in, i, count, r * row_stride + c);
+        }
+    }
+}
+
+template <typename T>
+void __store_matrix3(__vml_strided<T*> out, size_t row_stride, size_t i,
+                     size_t count, typename __simd<T>::reg const (&m)[3][3]) {
+    for (size_t r = 0; r < 3; ++r) {
+        for (size_t c = 0; c < row_stride; ++c) {
+            __store_strided(out, i, count, r * row_stride + c,
+                            c < 3 ? m[r][c] : __simd<T>::set1(0));
+        }
+    }
+}
+
+/// `r = a * b`, or `a * transpose(b)` with `TransposeB`
+template <typename T, bool TransposeB = false>
+void __multiply3(typename __simd<T>::reg const (&a)[3][3],
+                 typename __simd<T>::reg const (&b)[3][3],
+                 typename __simd<T>::reg (&r)[3][3]) {
+    using S = __simd<T>;
+    auto const at = [&](size_t k, size_t j) {
+        return TransposeB ? b[j][k] : b[k][j];
+    };
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            r[i][j] = S::fma(a[i][2], at(2, j),
+                             S::fma(a[i][1], at(1, j), S::mul(a[i][0],
+                                                              at(0, j))));
+        }
+    }
+}
+
+/// Jacobi rotation in the \p p, \p q plane, see `__vml_jacobi_rotate()`
+template <typename T>
+void __jacobi_rotate(typename __simd<T>::reg (&a)[3][3],
+                     typename __simd<T>::reg (&v)[3][3], size_t p, size_t q) {
+    using S = __simd<T>;
+    using reg = typename S::reg;
+    size_t const r = 3 - p - q;
+    reg const one = S::set1(1);
+    reg const d = S::sub(a[q][q], a[p][p]);
+    reg const o = a[p][q];
+    reg const root = S::sqrt(S::fma(d, d, S::mul(S::set1(4), S::mul(o, o))));
+    reg const t = S::div(
+        S::mul(S::copysign(S::set1(2), d), o),
+        S::add(S::add(S::abs(d), root),
+               S::set1(std::numeric_limits<T>::min())));
+    reg const c = S::div(one, S::sqrt(S::fma(t, t, one)));
+    reg const s = S::mul(t, c);
+    a[p][p] = S::sub(a[p][p], S::mul(t, o));
+    a[q][q] = S::add(a[q][q], S::mul(t, o));
+    a[p][q] = a[q][p] = S::set1(0);
+    reg const arp = a[r][p], arq = a[r][q];
+    a[r][p] = a[p][r] = S::sub(S::mul(c, arp), S::mul(s, arq));
+    a[r][q] = a[q][r] = S::add(S::mul(s, arp), S::mul(c, arq));
+    for (size_t k = 0; k < 3; ++k) {
+        reg const vp = v[k][p], vq = v[k][q];
+        v[k][p] = S::sub(S::mul(c, vp), S::mul(s, vq));
+        v[k][q] = S::add(S::mul(s, vp), S::mul(c, vq));
+    }
+}
+
+/// Diagonalizes the symmetric \p a, leaving the sorted eigenvalues in
+/// \p values and the eigenvectors in the columns of \p v
+template <typename T>
+void __eigen_symmetric3(typename __simd<T>::reg (&a)[3][3],
+                        typename __simd<T>::reg (&v)[3][3],
+                        typename __simd<T>::reg (&values)[3]) {
+    using S = __simd<T>;
+    using reg = typename S::reg;
+    for (size_t r = 0; r < 3; ++r) {
+        for (size_t c = 0; c < 3; ++c) {
+            v[r][c] = S::set1(T(r == c));
+        }
+    }
+    for (int sweep = 0; sweep < __vml_jacobi_sweeps<T>; ++sweep) {
+        __jacobi_rotate<T>(a, v, 0, 1);
+        __jacobi_rotate<T>(a, v, 0, 2);
+        __jacobi_rotate<T>(a, v, 1, 2);
+    }
+    for (size_t k = 0; k < 3; ++k) {
+        values[k] = a[k][k];
+    }
+    auto const order = [&](size_t i, size_t j) {
+        reg const x = values[i], y = values[j];
+        values[i] = S::select_lt(x, y, y, x);
+        values[j] = S::select_lt(x, y, x, y);
+        for (size_t k = 0; k < 3; ++k) {
+            reg const vi = v[k][i], vj = v[k][j];
+            v[k][i] = S::select_lt(x, y, vj, vi);
+            v[k][j] = S::select_lt(x, y, S::sub(S::set1(0), vi), vj);
+        }
+    };
+    order(0, 1);
+    order(1, 2);
+    order(0, 1);
+}
+
+/// Givens rotation of rows \p p and \p r, see `__vml_givens_rotate()`
+template <typename T>
+void __givens_rotate(typename __simd<T>::reg (&b)[3][3],
+                     typename __simd<T>::reg (&q)[3][3], size_t p, size_t r,
+                     size_t k) {
+    using S = __simd<T>;
+    using reg = typename S::reg;
+    reg const x = b[p][k], y = b[r][k];
+    reg const rho = S::sqrt(S::fma(x, x, S::mul(y, y)));
+    reg const tiny = S::set1(std::numeric_limits<T>::min());
+    reg const c = S::select_lt(tiny, rho, S::div(x, rho), S::set1(1));
+    reg const s = S::select_lt(tiny, rho, S::div(y, rho), S::set1(0));
+    for (auto* m: { &b, &q }) {
+        for (size_t j = 0; j < 3; ++j) {
+            reg const mp = (*m)[p][j], mr = (*m)[r][j];
+            (*m)[p][j] = S::fma(c, mp, S::mul(s, mr));
+            (*m)[r][j] = S::sub(S::mul(c, mr), S::mul(s, mp));
+        }
+    }
+}
+
+/// Computes \p u, \p sigma and \p v of the SVD of \p a
+template <typename T>
+void __svd3(typename __simd<T>::reg const (&a)[3][3],
+            typename __simd<T>::reg (&u)[3][3],
+            typename __simd<T>::reg (&sigma)[3],
+            typename __simd<T>::reg (&v)[3][3]) {
+    using S = __simd<T>;
+    using reg = typename S::reg;
+    reg ata[3][3], at[3][3];
+    for (size_t r = 0; r < 3; ++r) {
+        for (size_t c = 0; c < 3; ++c) {
+            at[r][c] = a[c][r];
+        }
+    }
+    __multiply3<T, true>(at, at, ata);
+    __eigen_symmetric3<T>(ata, v, sigma);
+    reg b[3][3], q[3][3];
+    __multiply3<T>(a, v, b);
+    for (size_t r = 0; r < 3; ++r) {
+        for (size_t c = 0; c < 3; ++c) {
+            q[r][c] = S::set1(T(r == c));
+        }
+    }
+    __givens_rotate<T>(b, q, 0, 1, 0);
+    __givens_rotate<T>(b, q, 0, 2, 0);
+    __givens_rotate<T>(b, q, 1, 2, 1);
+    for (size_t r = 0; r < 3; ++r) {
+        sigma[r] = b[r][r];
+        for (size_t c = 0; c < 3; ++c) {
+            u[r][c] = q[c][r];
+        }
+    }
+}
+
+/// `values[i], vectors[i] = eigen_symmetric(in[i])`
+template <typename T>
+void eigen_symmetric(__vml_strided<T const*> in, size_t row_stride,
+                     __vml_strided<T*> values, __vml_strided<T*> vectors,
+                     size_t n) {
+    using S = __simd<T>;
+    using reg = typename S::reg;
+    for (size_t i = 0; i < n; i += S::width) {
+        size_t const count = n - i < S::width ? n - i : S::width;
+        reg a[3][3], v[3][3], lambda[3];
+        for (size_t r = 0; r < 3; ++r) {
+            for (size_t c = r; c < 3; ++c) {
+                a[r][c] = a[c][r] =
+                    __load_strided(in, i, count, r * row_stride + c);
+            }
+        }
+        __eigen_symmetric3<T>(a, v, lambda);
+        for (size_t k = 0; k < 3; ++k) {
+            __store_strided(values, i, count, k, lambda[k]);
+        }
+        __store_matrix3(vectors, row_stride, i, count, v);
+    }
+}
+
+/// `u[i], sigma[i], v[i] = svd(in[i])`
+template <typename T>
+void svd(__vml_strided<T const*> in, size_t row_stride, __vml_strided<T*> u,
+         __vml_strided<T*> sigma, __vml_strided<T*> v, size_t n) {
+    using S = __simd<T>;
+    using reg = typename S::reg;
+    for (size_t i = 0; i < n; i += S::width) {
+        size_t const count = n - i < S::width ? n - i : S::width;
+        reg a[3][3], ur[3][3], sr[3], vr[3][3];
+        __load_matrix3(in, row_stride, i, count, a);
+        __svd3<T>(a, ur, sr, vr);
+        __store_matrix3(u, row_stride, i, count, ur);
+        for (size_t k = 0; k < 3; ++k) {
+            __store_strided(sigma, i, count, k, sr[k]);
+        }
+        __store_matrix3(v, row_stride, i, count, vr);
+    }
+}
+
+/// `rotation[i], stretch[i] = polar_decompose(in[i])`
+template <typename T>
+void polar_decompose(__vml_strided<T const*> in, size_t row_stride,
+                     __vml_strided<T*> rotation, __vml_strided<T*> stretch,
+                     size_t n) {
+    using S = __simd<T>;
+    using reg = typename S::reg;
+    for (size_t i = 0; i < n; i += S::width) {
+        size_t const count = n - i < S::width ? n - i : S::width;
+        reg a[3][3], u[3][3], sigma[3], v[3][3], r[3][3], vs[3][3], p[3][3];
+        __load_matrix3(in, row_stride, i, count, a);
+        __svd3<T>(a, u, sigma, v);
+        __multiply3<T, true>(u, v, r);
+        for (size_t k = 0; k < 3; ++k) {
+            for (size_t j = 0; j < 3; ++j) {
+                vs[k][j] = S::mul(v[k][j], sigma[j]);
+            }
+        }
+        __multiply3<T, true>(vs, v, p);
+        __store_matrix3(rotation, row_stride, i, count, r);
+        __store_matrix3(stretch, row_stride, i, count, p);
+    }
+}
+
+/// MARK: - Culling
+
+/// See `cull()` below, `Boxes` selects the shape
+template <typename T, bool Boxes>
+void __cull(T const* planes, __vml_strided<T const*> in, size_t extent,
+            std::uint64_t* visible, size_t n) {
+    using S = __simd<T>;
+    using reg = typename S::reg;
+    reg const half = S::set1(T(0.5)), zero = S::set1(0);
+    for (size_t i = 0; i < n; i += S::width) {
+        size_t const count = n - i < S::width ? n - i : S::width;
+        reg c[3], e[3], r;
+        for (size_t k = 0; k < 3; ++k) {
+            c[k] = __load_strided(in, i, count, k);
+            if constexpr (Boxes) {
+                e[k] = S::mul(half, __load_strided(in, i, count, extent + k));
+                c[k] = S::add(c[k], e[k]);
+            }
+        }
+        if constexpr (!Boxes) {
+            r = __load_strided(in, i, count, extent);
+        }
+        // Smallest distance of the shape's farthest point along any of the
+        // plane normals
+        reg nearest;
+        for (size_t p = 0; p < 6; ++p) {
+            T const* const plane = planes + 4 * p;
+            reg d = S::set1(plane[3]);
+            for (size_t k = 0; k < 3; ++k) {
+                d = S::fma(S::set1(plane[k]), c[k], d);
+                if constexpr (Boxes) {
+                    d = S::fma(S::set1(std::abs(plane[k])), e[k], d);
+                }
+            }
+            if constexpr (!Boxes) {
+                d = S::add(d, r);
+            }
+            nearest = p == 0 ? d : S::min(nearest, d);
+        }
+        std::uint64_t const bits =
+            ~std::uint64_t(S::mask_lt(nearest, zero)) &
+            (~std::uint64_t(0) >> (64 - count));
+        // `S::width` divides 64, so the bits of one iteration share a word
+        if (i % 64 == 0) {
+            visible[i / 64] = 0;
+        }
+        visible[i / 64] |= bits << (i % 64);
+    }
+}
+
+/// Sets bit `i % 64` of `visible[i / 64]` if shape `i` is not entirely
+/// outside of any of the 6 \p planes. Each plane is `(nx, ny, nz, d)` with
+/// the inside where `n.p + d >= 0`. The shapes start with their origin, the
+/// radius of spheres is component \p extent. Boxes have the 3 components of
+/// their size there. The words covering the `n` bits are overwritten.
+template <typename T>
+void cull(T const* planes, bool boxes, __vml_strided<T const*> in,
+          size_t extent, std::uint64_t* visible, size_t n) {
+    if (boxes) {
+        __cull<T, true>(planes, in, extent, visible, n);
+    }
+    else {
+        __cull<T, false>(planes, in, extent, visible, n);
+    }
+}
+
+/// MARK: - Encodings
+
+/// Octahedral encoding of `n` unit 3-vectors into pairs of `U`, see
+/// `_VVML::encode_octahedral`. Only the quantized results go through scalar
+/// code.
+template <typename U>
+void encode_octahedral(__vml_strided<float const*> in, U* out, size_t n) {
+    using S = __simd<float>;
+    using reg = typename S::reg;
+    constexpr float scale = 0.5f * float(std::numeric_limits<U>::max());
+    reg const one = S::set1(1), zero = S::set1(0);
+    for (size_t i = 0; i < n; i += S::width) {
+        size_t const count = n - i < S::width ? n - i : S::width;
+        reg const x = __load_strided(in, i, count, 0);
+        reg const y = __load_strided(in, i, count, 1);
+        reg const z = __load_strided(in, i, count, 2);
+        reg const l1 = S::add(S::add(S::abs(x), S::abs(y)), S::abs(z));
+        reg px = S::div(x, l1);
+        reg py = S::div(y, l1);
+        reg const fx = S::copysign(S::sub(one, S::abs(py)), px);
+        reg const fy = S::copysign(S::sub(one, S::abs(px)), py);
+        px = S::select_lt(z, zero, fx, px);
+        py = S::select_lt(z, zero, fy, py);
+        float qx[S::width], qy[S::width];
+        S::storeu(qx, S::fma(px, S::set1(scale), S::set1(scale + 0.5f)));
+        S::storeu(qy, S::fma(py, S::set1(scale), S::set1(scale + 0.5f)));
+        for (size_t j = 0; j < count; ++j) {
+            out[2 * (i + j)] = U(qx[j]);
+            out[2 * (i + j) + 1] = U(qy[j]);
+        }
+    }
+}
+
+/// Inverse of `encode_octahedral`
+template <typename U>
+void decode_octahedral(U const* in, __vml_strided<float*> out, size_t n) {
+    using S = __simd<float>;
+    using reg = typename S::reg;
+    constexpr float scale = 2.0f / float(std::numeric_limits<U>::max());
+    reg const one = S::set1(1), zero = S::set1(0);
+    for (size_t i = 0; i < n; i += S::width) {
+        size_t const count = n - i < S::width ? n - i : S::width;
+        float ex[S::width]{}, ey[S::width]{};
+        for (size_t j = 0; j < count; ++j) {
+            ex[j] = float(in[2 * (i + j)]);
+            ey[j] = float(in[2 * (i + j) + 1]);
+        }
+        reg x = S::fma(S::loadu(ex), S::set1(scale), S::set1(-1));
+        reg y = S::fma(S::loadu(ey), S::set1(scale), S::set1(-1));
+        reg const z = S::sub(S::sub(one, S::abs(x)), S::abs(y));
+        reg const t = S::max(S::sub(zero, z), zero);
+        x = S::sub(x, S::copysign(t, x));
+        y = S::sub(y, S::copysign(t, y));
+        reg const n2 = S::fma(z, z, S::fma(y, y, S::mul(x, x)));
+        reg const r = S::div(one, S::sqrt(n2));
+        __store_strided(out, i, count, 0, S::mul(x, r));
+        __store_strided(out, i, count, 1, S::mul(y, r));
+        __store_strided(out, i, count, 2, S::mul(z, r));
+    }
+}
+
+/// Smallest three encoding of `n` unit quaternions, 32 bit codes if `U` is
+/// `uint32_t` and 48 bit codes in three `uint16_t` if `U` is `uint16_t`. See
+/// `_VVML::encode_smallest_three`.
+template <typename U>
+void encode_smallest_three(float const* in, U* out, size_t n) {
+    using S = __simd<float>;
+    using reg = typename S::reg;
+    constexpr unsigned bits = sizeof(U) == 4 ? 10 : 15;
+    constexpr float max = float((1u << bits) - 1);
+    constexpr float scale = 0.5f * max * constants<float>::sqrt2;
+    __vml_strided<float const*> const q = { in, 4, 1 };
+    for (size_t i = 0; i < n; i += S::width) {
+        size_t const count = n - i < S::width ? n - i : S::width;
+        reg c[4];
+        for (size_t k = 0; k < 4; ++k) {
+            c[k] = __load_strided(q, i, count, k);
+        }
+        // Index of the component with the largest magnitude, the first one
+        // wins ties
+        reg largest = c[0], magnitude = S::abs(c[0]), index = S::set1(0);
+        for (size_t k = 1; k < 4; ++k) {
+            reg const a = S::abs(c[k]);
+            largest = S::select_lt(magnitude, a, c[k], largest);
+            index = S::select_lt(magnitude, a, S::set1(float(k)), index);
+            magnitude = S::max(magnitude, a);
+        }
+        // `q` and `-q` are the same rotation, so the sign is chosen to make
+        // the dropped component positive
+        reg const s = S::copysign(S::set1(scale), largest);
+        reg const r[3] = {
+            S::select_lt(index, S::set1(0.5f), c[1], c[0]),
+            S::select_lt(index, S::set1(1.5f), c[2], c[1]),
+            S::select_lt(index, S::set1(2.5f), c[3], c[2]),
+        };
+        float quantized[3][S::width], indices[S::width];
+        for (size_t k = 0; k < 3; ++k) {
+            reg const v = S::fma(r[k], s, S::set1(0.5f * max + 0.5f));
+            S::storeu(quantized[k],
+                      S::min(S::max(v, S::set1(0)), S::set1(max + 0.5f)));
+        }
+        S::storeu(indices, index);
+        for (size_t j = 0; j < count; ++j) {
+            std::uint64_t code = std::uint64_t(indices[j]);
+            for (size_t k = 0; k < 3; ++k) {
+                code = code << bits | std::uint64_t(quantized[k][j]);
+            }
+            if constexpr (sizeof(U) == 4) {
+                out[i + j] = U(code);
+            }
+            else {
+                for (size_t k = 0; k < 3; ++k) {
+                    out[3 * (i + j) + k] = U(code >> (16 * k));
+                }
+            }
+        }
+    }
+}
+
+/// Inverse of `encode_smallest_three`
+template <typename U>
+void decode_smallest_three(U const* in, float* out, size_t n) {
+    using S = __simd<float>;
+    using reg = typename S::reg;
+    constexpr unsigned bits = sizeof(U) == 4 ? 10 : 15;
+    constexpr std::uint64_t mask = (1u << bits) - 1;
+    constexpr float scale = 2.0f / (float(mask) * constants<float>::sqrt2);
+    __vml_strided<float*> const q = { out, 4, 1 };
+    for (size_t i = 0; i < n; i += S::width) {
+        size_t const count = n - i < S::width ? n - i : S::width;
+        float quantized[3][S::width]{}, indices[S::width]{};
+        for (size_t j = 0; j < count; ++j) {
+            std::uint64_t code = 0;
+            if constexpr (sizeof(U) == 4) {
+                code = in[i + j];
+            }
+            else {
+                for (size_t k = 0; k < 3; ++k) {
+                    code |= std::uint64_t(in[3 * (i + j) + k]) << (16 * k);
+                }
+            }
+            indices[j] = float(code >> (3 * bits));
+            for (size_t k = 0; k < 3; ++k) {
+                quantized[2 - k][j] = float((code >> (k * bits)) & mask);
+            }
+        }
+        reg r[3];
+        reg n2 = S::set1(0);
+        for (size_t k = 0; k < 3; ++k) {
+            r[k] = S::fma(S::loadu(quantized[k]), S::set1(scale),
+                          S::set1(-0.5f * constants<float>::sqrt2));
+            n2 = S::fma(r[k], r[k], n2);
+        }
+        reg const w = S::sqrt(S::max(S::sub(S::set1(1), n2), S::set1(0)));
+        reg const index = S::loadu(indices);
+        auto const lt = [&](float bound, reg a, reg b) {
+            return S::select_lt(index, S::set1(bound), a, b);
+        };
+        __store_strided(q, i, count, 0, lt(0.5f, w, r[0]));
+        __store_strided(q, i, count, 1, lt(0.5f, r[0], lt(1.5f, w, r[1])));
+        __store_strided(q, i, count, 2, lt(1.5f, r[1], lt(2.5f, w, r[2])));
+        __store_strided(q, i, count, 3, lt(2.5f, r[2], w));
+    }
+}
+
+/// MARK: - Hashing
+
+/// `out[i] = __vml_hash(in + i * stride, dim)`. The words are packed by scalar
+/// code, mixing and finalizing is done `S::width` vectors at a time.
+template <typename T>
+void hash(T const* in, size_t dim, size_t stride, size_t* out, size_t n) {
+    using S = __simd<std::uint64_t>;
+    using reg = typename S::reg;
+    constexpr size_t per_word = 8 / sizeof(T);
+    size_t const words = (dim + per_word - 1) / per_word;
+    reg const multiplier = S::set1(__vml_hash_multiplier);
+    auto const avalanche = [](reg h, std::uint64_t m) {
+        return S::mul(S::bit_xor(h, S::template shift_right<33>(h)),
+                      S::set1(m));
+    };
+    for (size_t i = 0; i < n; i += S::width) {
+        size_t const count = n - i < S::width ? n - i : S::width;
+        reg h = S::set1(__vml_hash_seed);
+        for (size_t w = 0; w < words; ++w) {
+            std::uint64_t buffer[S::width]{};
+            for (size_t j = 0; j < count; ++j) {
+                buffer[j] = __vml_hash_word(in + (i + j) * stride, dim, w);
+            }
+            h = S::mul(S::bit_xor(h, S::loadu(buffer)), multiplier);
+        }
+        // Same steps as `__vml_hash_finalize`
+        h = avalanche(h, 0xff51'afd7'ed55'8ccd);
+        h = avalanche(h, 0xc4ce'b9fe'1a85'ec53);
+        h = S::bit_xor(h, S::template shift_right<33>(h));
+        std::uint64_t result[S::width];
+        S::storeu(result, h);
+        for (size_t j = 0; j < count; ++j) {
+            out[i + j] = size_t(result[j]);
+        }
+    }
+}
+
+/// MARK: - Compensated Reductions
+
+/// `a + b` and its rounding error (Knuth's TwoSum)
+template <typename T>
+typename __simd<T>::reg __two_sum(typename __simd<T>::reg a,
+                                  typename __simd<T>::reg b,
+                                  typename __simd<T>::reg& err) {
+    using S = __simd<T>;
+    auto const s = S::add(a, b);
+    auto const z = S::sub(s, a);
+    err = S::add(S::sub(a, S::sub(s, z)), S::sub(b, z));
+    return s;
+}
+
+/// Returns \p x. GCC contracts multiplies and adds across statements by
+/// default, products passed through here are not fused into later additions.
+template <typename R>
+R __opaque(R x) {
+#if defined(__GNUC__) && !defined(__clang__)
+    asm("" : "+x"(x));
+#endif
+    return x;
+}
+
+/// `a * b` and its rounding error. If `S::fma` rounds twice the operands are
+/// split in halves whose products are exact (Dekker).
+template <typename T>
+typename __simd<T>::reg __two_product(typename __simd<T>::reg a,
+                                      typename __simd<T>::reg b,
+                                      typename __simd<T>::reg& err) {
+    using S = __simd<T>;
+    using reg = typename S::reg;
+    reg const p = S::mul(a, b);
+    if constexpr (S::fma_rounds_once) {
+        err = S::fma(a, b, S::sub(S::set1(0), p));
+    }
+    else {
+        reg const split =
+            S::set1(T((1ull << (std::numeric_limits<T>::digits + 1) / 2) + 1));
+        auto const halves = [&](reg x, reg& hi, reg& lo) {
+            reg const c = S::mul(split, x);
+            hi = S::sub(c, S::sub(c, x));
+            lo = S::sub(x, hi);
+        };
+        reg ah, al, bh, bl;
+        halves(a, ah, al);
+        halves(b, bh, bl);
+        err = S::add(S::add(S::add(S::sub(S::mul(ah, bh), p), S::mul(ah, bl)),
+                            S::mul(al, bh)),
+                     S::mul(al, bl));
+    }
+    return __opaque(p);
+}
+
+/// Sums `f(c, in[i]...)` over the `n` scalars of the inputs, where `f` may
+/// add rounding errors to `c`. The scalars are the components of vectors of
+/// \p lanes scalars, component `k` is summed to `sum[k] + err[k]`. We keep
+/// at least four chains of accumulators so the additions overlap, and
+/// enough that every accumulator lane sees a single component.
+///
+/// With `VML_DETERMINISTIC` the accumulators cover the same scalars on every
+/// instruction set: the smallest multiple of \p lanes and of the widest
+/// register (16 scalars) that is at least 64, so AVX-512 keeps four chains.
+/// That is 240 scalars at most. Every accumulator lane sums the same scalars
+/// in the same order and the lanes are combined in the same order. TwoSum
+/// and TwoProduct are exact, so the results are the same.
+template <typename T, typename F, typename... In>
+void __sum_compensated(size_t n, size_t lanes, T* sum, T* err, F f,
+                       In const*... in) {
+    using S = __simd<T>;
+    using reg = typename S::reg;
+#if VML_DETERMINISTIC
+    size_t const period = std::lcm(lanes, size_t(16));
+    size_t const count = period * ((64 + period - 1) / period) / S::width;
+    reg s[240 / S::width], c[240 / S::width];
+    __vml_expect(count <= 240 / S::width);
+#else
+    size_t const period = lanes / std::gcd(lanes, S::width);
+    size_t const count = period * ((4 + period - 1) / period);
+    reg s[16], c[16];
+#endif
+    size_t const block = count * S::width;
+    for (size_t r = 0; r < count; ++r) {
+        s[r] = c[r] = S::set1(0);
+    }
+    auto const accumulate = [&](size_t r, auto... x) {
+        reg e;
+        s[r] = __two_sum<T>(s[r], f(c[r], x...), e);
+        c[r] = S::add(c[r], e);
+    };
+    size_t i = 0;
+    for (; i + block <= n; i += block) {
+        for (size_t r = 0; r < count; ++r) {
+            accumulate(r, S::loadu(in + i + r * S::width)...);
+        }
+    }
+    if (i < n) {
+        // Zero padding does not change the sums
+        for (size_t r = 0; r < count; ++r) {
+            size_t const begin = i + r * S::width;
+            auto const load_rest = [&](T const* p) {
+                T buffer[S::width]{};
+                for (size_t j = 0; j < S::width && begin + j < n; ++j) {
+                    buffer[j] = p[begin + j];
+                }
+                return S::loadu(buffer);
+            };
+            accumulate(r, load_rest(in)...);
+        }
+    }
+    // Combine the accumulator lanes in a fixed order
+    for (size_t k = 0; k < lanes; ++k) {
+        sum[k] = err[k] = 0;
+    }
+    for (size_t r = 0; r < count; ++r) {
+        T hs[S::width], hc[S::width];
+        S::storeu(hs, s[r]);
+        S::storeu(hc, c[r]);
+        for (size_t j = 0; j < S::width; ++j) {
+            size_t const k = (r * S::width + j) % lanes;
+            T e;
+            sum[k] = __vml_two_sum(sum[k], hs[j], e);
+            err[k] += e + hc[j];
+        }
+    }
+}
+
+/// Component-wise sums of `n` scalars forming vectors of \p lanes scalars
+template <typename T>
+void sum_compensated(T const* in, size_t n, size_t lanes, T* sum, T* err) {
+    __sum_compensated(
+        n, lanes, sum, err, [](auto&, auto x) { return x; }, in);
+}
+
+/// Component-wise sums of `a[i] * b[i]`, the products are exact
+template <typename T>
+void dot_compensated(T const* a, T const* b, size_t n, size_t lanes, T* sum,
+                     T* err) {
+    __sum_compensated(
+        n, lanes, sum, err,
+        [](auto& c, auto x, auto y) {
+        typename __simd<T>::reg e;
+        auto const p = __two_product<T>(x, y, e);
+        c = __simd<T>::add(c, e);
+        return p;
+    },
+        a, b);
+}
+
+} // namespace _VVML::__VML_BATCH_ISA
@@ -0,0 +1,596 @@
+#ifndef __VML_BVH_HPP_INCLUDED__
+#define __VML_BVH_HPP_INCLUDED__
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "fwd.hpp"
+#include "shapes.hpp"
+#include "vector.hpp"
+
+/// # Bounding Volume Hierarchy
+///
+/// `bvh<T, Dim>` is a binary tree of `AABB`s over a set of primitives, built
+/// with the surface area heuristic (SAH). The nodes are stored depth first in
+/// one array: the left child of an inner node directly follows it, so a
+/// traversal mostly walks forward through memory. Two nodes of a `float`
+/// hierarchy share a cache line.
+///
+/// The hierarchy only stores the bounds and indices of the primitives. Queries
+/// report the indices of the primitives whose bounds pass the test, exact
+/// tests against the primitives themselves are up to the caller.
+
+namespace _VVML {
+
+/// Split strategy used to build a `bvh`
+enum class bvh_build {
+    /// Evaluates the SAH at every primitive along all axes. Best trees,
+    /// slowest build.
+    sah,
+    /// Evaluates the SAH at the boundaries of a fixed number of bins per axis
+    binned_sah,
+};
+
+/// Result of the nearest primitive and ray queries
+template <typename T>
+struct bvh_hit {
+    /// Index of the primitive in the array the hierarchy was built from
+    size_t index;
+    /// Distance to the point, or ray parameter of the hit
+    T distance;
+};
+
+/// MARK: - class bvh
+template <typename T = float, size_t Dim = 3,
+          vector_options O = vector_options{}>
+class bvh {
+    static_assert(std::is_floating_point_v<T>);
+    static_assert(Dim >= 2 && Dim <= 3,
+                  "surface_area() is only implemented up to 3 dimensions");
+
+    using packed_vector = vector<T, Dim, vector_options{}.packed(true)>;
+
+public:
+    using box_type = AABB<T, Dim, O>;
+    using vector_type = vector<T, Dim, O>;
+
+    /// Upper bound on the depth of the tree. Deeper subtrees are split at
+    /// the median, which bounds the size of the traversal stacks.
+    static constexpr size_t max_depth = 64;
+
+    /// Number of bins per axis of `bvh_build::binned_sah`
+    static constexpr size_t bin_count = 16;
+
+    /// 32 bytes for `float`, 2 nodes per cache line
+    struct node {
+        packed_vector lower;
+        /// First primitive of a leaf, right child of an inner node
+        std::uint32_t index;
+        packed_vector upper;
+        /// Number of primitives of a leaf, `0` for inner nodes
+        std::uint32_t count;
+
+        bool is_leaf() const { return count != 0; }
+    };
+
+    bvh() = default;
+
+    /// Builds the hierarchy over \p boxes. Leaves hold at most
+    /// \p max_leaf_size primitives, fewer if splitting is cheaper.
+    explicit bvh(std::span<box_type const> boxes,
+                 bvh_build method = bvh_build::binned_sah,
+                 size_t max_leaf_size = 4) {
+        std::vector<packed_vector> lower(boxes.size()), upper(boxes.size());
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            lower[i] = boxes[i].lower_bound();
+            upper[i] = boxes[i].upper_bound();
+        }
+        _build(std::move(lower), std::move(upper), method, max_leaf_size);
+    }
+
+    /// Builds the hierarchy over the bounds of \p triangles
+    explicit bvh(std::span<triangle<T, Dim, O> const> triangles,
+                 bvh_build method = bvh_build::binned_sah,
+                 size_t max_leaf_size = 4) {
+        std::vector<packed_vector> lower(triangles.size()),
+            upper(triangles.size());
+        for (size_t i = 0; i < triangles.size(); ++i) {
+            auto const& t = triangles[i];
+            lower[i] = _VVML::min(t[0], t[1], t[2]);
+            upper[i] = _VVML::max(t[0], t[1], t[2]);
+        }
+        _build(std::move(lower), std::move(upper), method, max_leaf_size);
+    }
+
+    /// Number of primitives
+    size_t size() const { return _indices.size(); }
+    bool empty() const { return _indices.empty(); }
+
+    /// The nodes in depth first order, the root comes first
+    std::span<node const> nodes() const { return _nodes; }
+
+    /// Bounds of all primitives
+    box_type bounds() const {
+        __vml_expect(!empty());
+        return box_type(vector_type(_nodes[0].lower),
+                        vector_type(_nodes[0].upper));
+    }
+
+    /// MARK: Queries
+
+    /// Calls \p f with the index of every primitive whose bounds overlap
+    /// \p box
+    template <vector_options P, std::invocable<size_t> F>
+    void query(AABB<T, Dim, P> const& box, F&& f) const {
+        packed_vector const lower = box.lower_bound();
+        packed_vector const upper = box.upper_bound();
+        auto const test = [&](packed_vector const& l, packed_vector const& u) {
+            return _overlap(l, u, lower, upper);
+        };
+        _query(test, f);
+    }
+
+    /// Calls \p f with the index of every primitive whose bounds overlap
+    /// \p s
+    template <vector_options P, std::invocable<size_t> F>
+    void query(sphere<T, Dim, P> const& s, F&& f) const {
+        packed_vector const center = s.origin();
+        T const radius_squared = s.radius() * s.radius();
+        auto const test = [&](packed_vector const& l, packed_vector const& u) {
+            return _distance_squared(center, l, u) <= radius_squared;
+        };
+        _query(test, f);
+    }
+
+    /// Calls \p f with the index of every primitive whose bounds contain
+    /// \p p
+    template <vector_options P, std::invocable<size_t> F>
+    void query(vector<T, Dim, P> const& p, F&& f) const {
+        packed_vector const point = p;
+        auto const test = [&](packed_vector const& l, packed_vector const& u) {
+            return _overlap(l, u, point, point);
+        };
+        _query(test, f);
+    }
+
+    /// Calls \p f with every pair of primitives `(i, j)` with `i < j` whose
+    /// bounds overlap. Replaces testing all pairs with one query per
+    /// primitive.
+    template <std::invocable<size_t, size_t> F>
+    void overlapping_pairs(F&& f) const {
+        for (size_t k = 0; k < _indices.size(); ++k) {
+            size_t const i = _indices[k];
+            auto const test = [&](packed_vector const& l,
+                                  packed_vector const& u) {
+                return _overlap(l, u, _lower[k], _upper[k]);
+            };
+            _query(test, [&](size_t j) {
+                if (i < j) {
+                    std::invoke(f, i, j);
+                }
+            });
+        }
+    }
+
+    /// The primitive nearest to \p p. \p distance_squared is called with the
+    /// index of a primitive and returns its squared distance to \p p, the
+    /// bounds of a primitive must enclose it. Subtrees farther away than the
+    /// nearest primitive found so far are skipped.
+    template <vector_options P, std::invocable<size_t> F>
+    std::optional<bvh_hit<T>> nearest(vector<T, Dim, P> const& p,
+                                      F&& distance_squared) const {
+        if (empty()) {
+            return std::nullopt;
+        }
+        packed_vector const point = p;
+        bvh_hit<T> best = { 0, std::numeric_limits<T>::infinity() };
+        auto const key = [&](node const& n) {
+            return _distance_squared(point, n.lower, n.upper);
+        };
+        auto const visit = [&](size_t k) {
+            T const d = std::invoke(distance_squared, size_t(_indices[k]));
+            if (d < best.distance) {
+                best = { _indices[k], d };
+            }
+            return best.distance;
+        };
+        _traverse_ordered(key, visit, best.distance);
+        if (best.distance == std::numeric_limits<T>::infinity()) {
+            return std::nullopt;
+        }
+        best.distance = std::sqrt(best.distance);
+        return best;
+    }
+
+    /// The primitive whose bounds are nearest to \p p
+    template <vector_options P>
+    std::optional<bvh_hit<T>> nearest(vector<T, Dim, P> const& p) const {
+        packed_vector const point = p;
+        return nearest(p, [&](size_t i) {
+            size_t const k = _position[i];
+            return _distance_squared(point, _lower[k], _upper[k]);
+        });
+    }
+
+    /// The nearest primitive hit by the ray `origin + t * direction`,
+    /// `0 <= t < t_max`. \p intersect is called with the index of a primitive
+    /// whose bounds the ray enters before the nearest hit found so far. It
+    /// returns the ray parameter of the hit, or infinity if the ray misses
+    /// the primitive. Children are visited front to back.
+    template <vector_options P, vector_options Q, std::invocable<size_t> F>
+    std::optional<bvh_hit<T>> intersect_ray(
+        vector<T, Dim, P> const& origin, vector<T, Dim, Q> const& direction,
+        T t_max, F&& intersect) const {
+        return _intersect_ray(origin, T(1) / direction, t_max, intersect);
+    }
+
+    /// Same as above for the ray \p r, uses its cached reciprocal direction
+    template <vector_options P, std::invocable<size_t> F>
+    std::optional<bvh_hit<T>> intersect_ray(ray<T, Dim, P> const& r, T t_max,
+                                            F&& intersect) const {
+        return _intersect_ray(r.origin(), r.inverse_direction(), t_max,
+                              intersect);
+    }
+
+private:
+    /// Implementation of both `intersect_ray()` overloads
+    template <typename F>
+    std::optional<bvh_hit<T>> _intersect_ray(
+        packed_vector const& o, packed_vector const& inverse_direction,
+        T t_max, F& intersect) const {
+        if (empty()) {
+            return std::nullopt;
+        }
+        bvh_hit<T> best = { 0, t_max };
+        bool found = false;
+        auto const key = [&](node const& n) {
+            return _slab(n.lower, n.upper, o, inverse_direction, best.distance);
+        };
+        auto const visit = [&](size_t k) {
+            T const t = std::invoke(intersect, size_t(_indices[k]));
+            if (t >= 0 && t < best.distance) {
+                best = { _indices[k], t };
+                found = true;
+            }
+            return best.distance;
+        };
+        _traverse_ordered(key, visit, best.distance);
+        return found ? std::optional(best) : std::nullopt;
+    }
+
+    /// MARK: Traversal
+
+    /// Visits all leaves whose bounds pass \p test, then the primitives of
+    /// those leaves whose own bounds pass \p test
+    template <typename Test, typename F>
+    void _query(Test const& test, F&& f) const {
+        if (empty()) {
+            return;
+        }
+        std::uint32_t stack[2 * max_depth];
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            node const& n = _nodes[stack[--top]];
+            if (!test(n.lower, n.upper)) {
+                continue;
+            }
+            if (!n.is_leaf()) {
+                stack[top++] = n.index;
+                stack[top++] = std::uint32_t(&n - _nodes.data() + 1);
+                continue;
+            }
+            for (size_t k = n.index; k < n.index + n.count; ++k) {
+                if (test(_lower[k], _upper[k])) {
+                    std::invoke(f, size_t(_indices[k]));
+                }
+            }
+        }
+    }
+
+    /// Best first traversal. \p key returns the distance of a node or
+    /// infinity to skip it, \p visit is called with the position of every
+    /// primitive in the leaves that are not skipped and returns the new
+    /// bound. Nodes farther away than \p bound are skipped.
+    template <typename Key, typename Visit>
+    void _traverse_ordered(Key const& key, Visit const& visit, T bound) const {
+        struct entry {
+            std::uint32_t node;
+            T distance;
+        };
+        entry stack[2 * max_depth];
+        size_t top = 0;
+        stack[top++] = { 0, key(_nodes[0]) };
+        while (top > 0) {
+            entry const e = stack[--top];
+            if (!(e.distance <= bound)) {
+                continue;
+            }
+            node const& n = _nodes[e.node];
+            if (n.is_leaf()) {
+                for (size_t k = n.index; k < n.index + n.count; ++k) {
+                    bound = visit(k);
+                }
+                continue;
+            }
+            entry a = { e.node + 1, key(_nodes[e.node + 1]) };
+            entry b = { n.index, key(_nodes[n.index]) };
+            if (a.distance < b.distance) {
+                std::swap(a, b);
+            }
+            // The nearer child is popped first
+            stack[top++] = a;
+            stack[top++] = b;
+        }
+    }
+
+    static bool _overlap(packed_vector const& lower_a,
+                         packed_vector const& upper_a,
+                         packed_vector const& lower_b,
+                         packed_vector const& upper_b) {
+        for (size_t k = 0; k < Dim; ++k) {
+            if (lower_a[k] > upper_b[k] || upper_a[k] < lower_b[k]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Squared distance from \p p to the box, `0` if the box contains \p p
+    static T _distance_squared(packed_vector const& p,
+                               packed_vector const& lower,
+                               packed_vector const& upper) {
+        return distance_squared(p, clamp(p, lower, upper));
+    }
+
+    /// Ray parameter where the ray enters the box, infinity if it misses the
+    /// box within `[0, t_max)`
+    static T _slab(packed_vector const& lower, packed_vector const& upper,
+                   packed_vector const& origin,
+                   packed_vector const& inverse_direction, T t_max) {
+        packed_vector const t0 = (lower - origin) * inverse_direction;
+        packed_vector const t1 = (upper - origin) * inverse_direction;
+        packed_vector const near = _VVML::min(t0, t1);
+        packed_vector const far = _VVML::max(t0, t1);
+        T enter = 0, exit = t_max;
+        for (size_t k = 0; k < Dim; ++k) {
+            enter = near[k] > enter ? near[k] : enter;
+            exit = far[k] < exit ? far[k] : exit;
+        }
+        return enter <= exit ? enter : std::numeric_limits<T>::infinity();
+    }
+
+    /// MARK: Build
+
+    struct _bounds {
+        packed_vector lower = packed_vector(std::numeric_limits<T>::max());
+        packed_vector upper = packed_vector(-std::numeric_limits<T>::max());
+
+        void grow(packed_vector const& l, packed_vector const& u) {
+            lower = _VVML::min(lower, l);
+            upper = _VVML::max(upper, u);
+        }
+        /// Empty bounds have no area
+        T area() const {
+            for (size_t k = 0; k < Dim; ++k) {
+                if (lower[k] > upper[k]) {
+                    return 0;
+                }
+            }
+            return surface_area(AABB<T, Dim>(vector<T, Dim>(lower),
+                                             vector<T, Dim>(upper)));
+        }
+    };
+
+    struct _split {
+        size_t axis = 0;
+        T position = 0;
+        T cost = std::numeric_limits<T>::infinity();
+    };
+
+    void _build(std::vector<packed_vector> lower,
+                std::vector<packed_vector> upper, bvh_build method,
+                size_t max_leaf_size) {
+        __vml_expect(max_leaf_size > 0);
+        __vml_expect(lower.size() < std::numeric_limits<std::uint32_t>::max());
+        size_t const count = lower.size();
+        _indices.resize(count);
+        std::iota(_indices.begin(), _indices.end(), std::uint32_t(0));
+        if (count == 0) {
+            return;
+        }
+        _centroids.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            _centroids[i] = (lower[i] + upper[i]) * T(0.5);
+        }
+        _lower = std::move(lower);
+        _upper = std::move(upper);
+        _nodes.reserve(2 * count);
+        _build_node(0, count, 0, method, max_leaf_size);
+        // Reorder the primitive bounds to match the leaves
+        std::vector<packed_vector> reordered_lower(count);
+        std::vector<packed_vector> reordered_upper(count);
+        _position.resize(count);
+        for (size_t k = 0; k < count; ++k) {
+            reordered_lower[k] = _lower[_indices[k]];
+            reordered_upper[k] = _upper[_indices[k]];
+            _position[_indices[k]] = std::uint32_t(k);
+        }
+        _lower = std::move(reordered_lower);
+        _upper = std::move(reordered_upper);
+        _centroids = {};
+        _nodes.shrink_to_fit();
+    }
+
+    void _build_node(size_t begin, size_t end, size_t depth, bvh_build method,
+                     size_t max_leaf_size) {
+        _bounds bounds, centroid_bounds;
+        for (size_t k = begin; k < end; ++k) {
+            size_t const i = _indices[k];
+            bounds.grow(_lower[i], _upper[i]);
+            centroid_bounds.grow(_centroids[i], _centroids[i]);
+        }
+        size_t const index = _nodes.size();
+        _nodes.push_back({ bounds.lower, std::uint32_t(begin), bounds.upper,
+                           std::uint32_t(end - begin) });
+        size_t const count = end - begin;
+        if (count == 1) {
+            return;
+        }
+        size_t middle = begin;
+        if (depth < max_depth / 2) {
+            _split const split =
+                method == bvh_build::sah
+                    ? _find_sah_split(begin, end)
+                    : _find_binned_split(begin, end, centroid_bounds);
+            // Traversing a node and intersecting a primitive are assumed to
+            // cost the same
+            T const area = bounds.area();
+            if (count <= max_leaf_size &&
+                !(split.cost + area < T(count) * area))
+            {
+                return;
+            }
+            if (split.cost < std::numeric_limits<T>::infinity()) {
+                auto const left = [&](std::uint32_t i) {
+                    return _centroids[i][split.axis] < split.position;
+                };
+                middle = size_t(std::partition(_indices.begin() + begin,
+                                               _indices.begin() + end, left) -
+                                _indices.begin());
+            }
+        }
+        else if (count <= max_leaf_size) {
+            return;
+        }
+        if (middle == begin || middle == end) {
+            // No useful split, e.g. all centroids coincide
+            middle = begin + count / 2;
+            size_t const axis = _largest_axis(centroid_bounds);
+            auto const less = [&](std::uint32_t a, std::uint32_t b) {
+                return _centroids[a][axis] < _centroids[b][axis];
+            };
+            std::nth_element(_indices.begin() + begin,
+                             _indices.begin() + middle, _indices.begin() + end,
+                             less);
+        }
+        _nodes[index].count = 0;
+        _build_node(begin, middle, depth + 1, method, max_leaf_size);
+        _nodes[index].index = std::uint32_t(_nodes.size());
+        _build_node(middle, end, depth + 1, method, max_leaf_size);
+    }
+
+    static size_t _largest_axis(_bounds const& b) {
+        size_t axis = 0;
+        for (size_t k = 1; k < Dim; ++k) {
+            if (b.upper[k] - b.lower[k] > b.upper[axis] - b.lower[axis]) {
+                axis = k;
+            }
+        }
+        return axis;
+    }
+
+    /// Sweeps over the primitives sorted by centroid along every axis
+    _split _find_sah_split(size_t begin, size_t end) {
+        size_t const count = end - begin;
+        std::vector<std::uint32_t> sorted(_indices.begin() + begin,
+                                          _indices.begin() + end);
+        std::vector<T> right_area(count);
+        _split best;
+        for (size_t axis = 0; axis < Dim; ++axis) {
+            auto const less = [&](std::uint32_t a, std::uint32_t b) {
+                return _centroids[a][axis] < _centroids[b][axis];
+            };
+            std::sort(sorted.begin(), sorted.end(), less);
+            _bounds right;
+            for (size_t k = count - 1; k > 0; --k) {
+                right.grow(_lower[sorted[k]], _upper[sorted[k]]);
+                right_area[k] = right.area();
+            }
+            _bounds left;
+            for (size_t k = 0; k + 1 < count; ++k) {
+                left.grow(_lower[sorted[k]], _upper[sorted[k]]);
+                T const position = _centroids[sorted[k + 1]][axis];
+                // Equal centroids cannot be separated by the partition
+                if (_centroids[sorted[k]][axis] == position) {
+                    continue;
+                }
+                T const cost = T(k + 1) * left.area() +
+                               T(count - k - 1) * right_area[k + 1];
+                if (cost < best.cost) {
+                    best = { axis, position, cost };
+                }
+            }
+        }
+        return best;
+    }
+
+    /// Evaluates the SAH at the boundaries of `bin_count` bins per axis
+    _split _find_binned_split(size_t begin, size_t end,
+                              _bounds const& centroid_bounds) {
+        _split best;
+        for (size_t axis = 0; axis < Dim; ++axis) {
+            T const lo = centroid_bounds.lower[axis];
+            T const extent = centroid_bounds.upper[axis] - lo;
+            if (!(extent > 0)) {
+                continue;
+            }
+            T const scale = T(bin_count) / extent;
+            _bounds bins[bin_count];
+            size_t counts[bin_count]{};
+            for (size_t k = begin; k < end; ++k) {
+                size_t const i = _indices[k];
+                size_t const b = std::min(
+                    size_t((_centroids[i][axis] - lo) * scale), bin_count - 1);
+                bins[b].grow(_lower[i], _upper[i]);
+                ++counts[b];
+            }
+            T right_area[bin_count];
+            size_t right_count[bin_count];
+            _bounds right;
+            size_t n = 0;
+            for (size_t b = bin_count - 1; b > 0; --b) {
+                right.grow(bins[b].lower, bins[b].upper);
+                n += counts[b];
+                right_area[b] = right.area();
+                right_count[b] = n;
+            }
+            _bounds left;
+            n = 0;
+            for (size_t b = 0; b + 1 < bin_count; ++b) {
+                left.grow(bins[b].lower, bins[b].upper);
+                n += counts[b];
+                if (n == 0 || right_count[b + 1] == 0) {
+                    continue;
+                }
+                T const cost = T(n) * left.area() +
+                               T(right_count[b + 1]) * right_area[b + 1];
+                if (cost < best.cost) {
+                    best = { axis, lo + T(b + 1) / scale, cost };
+                }
+            }
+        }
+        return best;
+    }
+
+    std::vector<node> _nodes;
+    /// Primitive indices in leaf order
+    std::vector<std::uint32_t> _indices;
+    /// Position of each primitive in leaf order
+    std::vector<std::uint32_t> _position;
+    /// Primitive bounds in leaf order
+    std::vector<packed_vector> _lower, _upper;
+    /// Only used during the build
+    std::vector<packed_vector> _centroids;
+};
+
+} // namespace _VVML
+
+#endif // __VML_BVH_HPP_INCLUDED__
@@ -1,9 +1,12 @@
 #ifndef __VML_COMMON_HPP_INCLUDED__
 #define __VML_COMMON_HPP_INCLUDED__
 
+#include <bit>
 #include <cmath>
 #include <concepts>
+#include <cstdint>
 #include <iosfwd>
+#include <limits>
 #include <utility>
 
 #include "fwd.hpp"
@@ -598,6 +601,72 @@ size_t __vml_hash_combine(size_t seed, T const& v) {
 
 constexpr size_t __vml_hash_seed = 0x5f23'ef3b'34b5'e321;
 
+/// Hashing of arrays of scalars. The elements are converted to canonical bits,
+/// packed into 64 bit words in order and the words are mixed with a multiply
+/// and a final avalanche. The batch kernels compute the same function.
+template <typename T>
+concept __vml_hashable =
+    std::integral<T> || std::same_as<T, float> || std::same_as<T, double>;
+
+constexpr std::uint64_t __vml_hash_multiplier = 0x9e37'79b9'7f4a'7c15;
+
+/// Equal values give equal bits, so `-0.0` and `0.0` hash alike and all NaNs
+/// hash alike
+template <__vml_hashable T>
+constexpr std::uint64_t __vml_hash_bits(T x) {
+    if constexpr (std::floating_point<T>) {
+        using U = std::conditional_t<sizeof(T) == 4, std::uint32_t,
+                                     std::uint64_t>;
+        if (x == 0) {
+            return 0;
+        }
+        if (x != x) {
+            return std::bit_cast<U>(std::numeric_limits<T>::quiet_NaN());
+        }
+        return std::bit_cast<U>(x);
+    }
+    else if constexpr (std::same_as<T, bool>) {
+        return x;
+    }
+    else {
+        return std::make_unsigned_t<T>(x);
+    }
+}
+
+/// Word \p index of the \p dim elements at \p data. For integers this is the
+/// little endian object representation.
+template <__vml_hashable T>
+constexpr std::uint64_t __vml_hash_word(T const* data, size_t dim,
+                                        size_t index) {
+    constexpr size_t per_word = 8 / sizeof(T);
+    std::uint64_t word = 0;
+    for (size_t k = 0; k < per_word && index * per_word + k < dim; ++k) {
+        word |= __vml_hash_bits(data[index * per_word + k])
+                << (k * 8 * sizeof(T));
+    }
+    return word;
+}
+
+/// MurmurHash3 finalizer
+constexpr std::uint64_t __vml_hash_finalize(std::uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51'afd7'ed55'8ccd;
+    h ^= h >> 33;
+    h *= 0xc4ce'b9fe'1a85'ec53;
+    h ^= h >> 33;
+    return h;
+}
+
+template <__vml_hashable T>
+constexpr std::uint64_t __vml_hash(T const* data, size_t dim) {
+    constexpr size_t per_word = 8 / sizeof(T);
+    std::uint64_t h = __vml_hash_seed;
+    for (size_t i = 0; i < (dim + per_word - 1) / per_word; ++i) {
+        h = (h ^ __vml_hash_word(data, dim, i)) * __vml_hash_multiplier;
+    }
+    return __vml_hash_finalize(h);
+}
+
 #define __vml_forward(...) ::std::forward<decltype(__VA_ARGS__)>(__VA_ARGS__)
 
 // __vml_with_index_sequence
@@ -828,6 +897,7 @@ VML_FOR_EACH_BUILTIN_ARITHMETIC_TYPE(VML_IPOW);
 template <_VVML::__vml_any_of<float, double, long double> T>
 __vml_mathfunction __vml_pure inline T fast_hypot(T a,
                                                   std::same_as<T> auto... b) {
+    __vml_no_contract;
     return std::sqrt(((a * a) + ... + (b * b)));
 }
 
@@ -840,6 +910,7 @@ __vml_mathfunction __vml_pure inline T __vml_safe_hypot(
 template <_VVML::__vml_any_of<float, double, long double> T>
 __vml_mathfunction __vml_pure inline T __vml_safe_hypot(
     T a, std::same_as<T> auto... b) {
+    __vml_no_contract;
     /// Make all arguments positive ...
     a = std::abs(a);
     ((b = std::abs(b)), ...);
@@ -862,6 +933,7 @@ __vml_mathfunction __vml_pure __vml_always_inline
 template <_VVML::__vml_any_of<float, double, long double> T>
 __vml_mathfunction __vml_pure inline T __vml_hypot(T a,
                                                    std::same_as<T> auto... b) {
+    __vml_no_contract;
     T sum_of_squares = ((a * a) + ... + (b * b));
     /// Only use __vml_safe_hypot if necessary. This is about 5 times faster on
     /// non-overflowing inputs and about 10% slower on always-overflowing inputs
@@ -2,6 +2,7 @@
 #define __VML_CORE_HPP_INCLUDED__
 
 #include "complex.hpp"
+#include "half.hpp"
 #include "matrix.hpp"
 #include "quaternion.hpp"
 #include "undef.hpp"
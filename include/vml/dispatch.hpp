@@ -0,0 +1,110 @@
+#ifndef __VML_DISPATCH_HPP_INCLUDED__
+#define __VML_DISPATCH_HPP_INCLUDED__
+
+#include <atomic>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#include "fwd.hpp"
+
+/// # Target Regions
+///
+/// Functions defined between `__VML_TARGET_PUSH(...)` and `__VML_TARGET_POP`
+/// are compiled for the given instruction set, regardless of the compiler
+/// flags. MSVC does not need this, it allows all intrinsics everywhere.
+
+#if defined(__clang__)
+#define __VML_PRIV_PRAGMA(...) _Pragma(#__VA_ARGS__)
+#define __VML_TARGET_PUSH(TARGET)                                              \
+    __VML_PRIV_PRAGMA(clang attribute push(                                    \
+        __attribute__((target(TARGET))), apply_to = function))
+#define __VML_TARGET_POP _Pragma("clang attribute pop")
+#elif defined(__GNUC__)
+#define __VML_PRIV_PRAGMA(...) _Pragma(#__VA_ARGS__)
+#define __VML_TARGET_PUSH(TARGET)                                              \
+    _Pragma("GCC push_options") __VML_PRIV_PRAGMA(GCC target(TARGET))
+#define __VML_TARGET_POP _Pragma("GCC pop_options")
+#else
+#define __VML_TARGET_PUSH(TARGET)
+#define __VML_TARGET_POP
+#endif
+
+namespace _VVML {
+
+/// Instruction sets the batch kernels are compiled for
+enum class simd_level { sse2, avx2, avx512 };
+
+/// Queries the instruction sets supported by the host CPU and OS
+inline simd_level __vml_detect_simd_level() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    bool const fma = info[2] & (1 << 12);
+    bool const f16c = info[2] & (1 << 29);
+    bool const osxsave = info[2] & (1 << 27);
+    if (!osxsave) {
+        return simd_level::sse2;
+    }
+    // XMM, YMM and ZMM state must be enabled by the OS
+    unsigned long long const xcr0 = _xgetbv(0);
+    bool const os_avx = (xcr0 & 0x06) == 0x06;
+    bool const os_avx512 = (xcr0 & 0xe6) == 0xe6;
+    __cpuidex(info, 7, 0);
+    bool const avx2 = info[1] & (1 << 5);
+    bool const avx512f = info[1] & (1 << 16);
+    if (os_avx512 && avx512f) {
+        return simd_level::avx512;
+    }
+    if (os_avx && avx2 && fma && f16c) {
+        return simd_level::avx2;
+    }
+    return simd_level::sse2;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return simd_level::avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+        __builtin_cpu_supports("f16c"))
+    {
+        return simd_level::avx2;
+    }
+    return simd_level::sse2;
+#endif
+}
+
+/// Detected once during static initialization. Before that it reads as
+/// `sse2`, which every x86-64 CPU supports.
+inline std::atomic<simd_level> __vml_simd_level = __vml_detect_simd_level();
+
+/// The instruction set selected for the batch kernels
+inline simd_level active_simd_level() {
+    return __vml_simd_level.load(std::memory_order_relaxed);
+}
+
+/// Restricts the batch kernels to \p level. Levels the CPU doesn't support
+/// are clamped to the supported ones.
+inline void set_simd_level(simd_level level) {
+    auto const supported = __vml_detect_simd_level();
+    __vml_simd_level.store(level < supported ? level : supported,
+                           std::memory_order_relaxed);
+}
+
+/// Selects the kernel compiled for the active instruction set
+template <typename F>
+F __vml_dispatch(F sse2, F avx2, F avx512) {
+    switch (active_simd_level()) {
+    case simd_level::avx512:
+        return avx512;
+    case simd_level::avx2:
+        return avx2;
+    default:
+        return sse2;
+    }
+}
+
+} // namespace _VVML
+
+#endif // __VML_DISPATCH_HPP_INCLUDED__
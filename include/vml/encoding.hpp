@@ -0,0 +1,219 @@
+#ifndef __VML_ENCODING_HPP_INCLUDED__
+#define __VML_ENCODING_HPP_INCLUDED__
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <type_traits>
+
+#include "batch.hpp"
+#include "common.hpp"
+#include "fwd.hpp"
+#include "quaternion.hpp"
+#include "vector.hpp"
+
+/// Compact encodings of unit vectors and rotations.
+///
+/// Octahedral encodings project unit 3-vectors onto the octahedron and
+/// unfold it into a square, which is stored as two 8 or 16 bit integers.
+/// Smallest three encodings drop the quaternion component with the largest
+/// magnitude, which is restored from the unit length, and store the other
+/// three in 10 or 15 bits each. The batch variants run the same math
+/// `S::width` elements at a time using the kernels in "batch_kernels.hpp".
+
+namespace _VVML {
+
+inline namespace short_types {
+
+using octahedral8 = vector<std::uint8_t, 2, vector_options{}.packed(true)>;
+using octahedral16 = vector<std::uint16_t, 2, vector_options{}.packed(true)>;
+using smallest_three32 = std::uint32_t;
+using smallest_three48 =
+    vector<std::uint16_t, 3, vector_options{}.packed(true)>;
+
+} // namespace short_types
+
+/// MARK: - Octahedral
+
+/// Encodes the unit vector \p n with `Bits` per coordinate. The maximum
+/// angular error is about 0.04 degrees with 16 bits and 1 degree with 8 bits.
+template <size_t Bits = 16, vector_options O>
+    requires(Bits == 8 || Bits == 16)
+__vml_mathfunction std::conditional_t<Bits == 8, octahedral8, octahedral16>
+    encode_octahedral(vector3<float, O> const& n) {
+    using U = std::conditional_t<Bits == 8, std::uint8_t, std::uint16_t>;
+    constexpr float scale = 0.5f * float(std::numeric_limits<U>::max());
+    float const l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    float x = n.x / l1;
+    float y = n.y / l1;
+    if (n.z < 0) {
+        // Fold the lower half over the diagonals
+        float const folded = std::copysign(1 - std::abs(y), x);
+        y = std::copysign(1 - std::abs(x), y);
+        x = folded;
+    }
+    return { U(x * scale + (scale + 0.5f)), U(y * scale + (scale + 0.5f)) };
+}
+
+template <typename U, vector_options O>
+    requires std::same_as<U, std::uint8_t> || std::same_as<U, std::uint16_t>
+__vml_mathfunction vector3<float> decode_octahedral(
+    vector<U, 2, O> const& code) {
+    constexpr float scale = 2.0f / float(std::numeric_limits<U>::max());
+    float x = float(code.x) * scale - 1;
+    float y = float(code.y) * scale - 1;
+    float const z = 1 - std::abs(x) - std::abs(y);
+    float const t = std::max(-z, 0.0f);
+    x -= std::copysign(t, x);
+    y -= std::copysign(t, y);
+    return normalize(vector3<float>(x, y, z));
+}
+
+/// MARK: - Smallest Three
+
+/// Encodes the unit quaternion \p q with 2 bits for the index of the dropped
+/// component and 10 (`Bits == 32`) or 15 (`Bits == 48`) bits for each of the
+/// others. The maximum error per component is about 2e-3 and 6e-5
+/// respectively. The decoded quaternion may be the negation of \p q.
+template <size_t Bits = 32>
+    requires(Bits == 32 || Bits == 48)
+__vml_mathfunction
+    std::conditional_t<Bits == 32, smallest_three32, smallest_three48>
+    encode_smallest_three(quaternion<float> const& q) {
+    constexpr unsigned bits = Bits == 32 ? 10 : 15;
+    constexpr float max = float((1u << bits) - 1);
+    size_t index = 0;
+    for (size_t k = 1; k < 4; ++k) {
+        if (std::abs(q[k]) > std::abs(q[index])) {
+            index = k;
+        }
+    }
+    // The others are within +-1/sqrt(2), their signs are flipped to make the
+    // dropped one positive
+    float const scale =
+        std::copysign(0.5f * max * constants<float>::sqrt2, q[index]);
+    std::uint64_t code = index;
+    for (size_t k = 0; k < 4; ++k) {
+        if (k != index) {
+            float const v = q[k] * scale + (0.5f * max + 0.5f);
+            code = code << bits | std::uint64_t(std::clamp(v, 0.0f,
+                                                           max + 0.5f));
+        }
+    }
+    if constexpr (Bits == 32) {
+        return smallest_three32(code);
+    }
+    else {
+        return { std::uint16_t(code), std::uint16_t(code >> 16),
+                 std::uint16_t(code >> 32) };
+    }
+}
+
+template <unsigned Bits>
+quaternion<float> __vml_decode_smallest_three(std::uint64_t code) {
+    constexpr std::uint64_t mask = (1u << Bits) - 1;
+    constexpr float scale = 2.0f / (float(mask) * constants<float>::sqrt2);
+    size_t const index = size_t(code >> (3 * Bits));
+    float r[3];
+    float n2 = 0;
+    for (size_t k = 0; k < 3; ++k) {
+        r[2 - k] = float((code >> (k * Bits)) & mask) * scale -
+                   0.5f * constants<float>::sqrt2;
+    }
+    for (float x: r) {
+        n2 += x * x;
+    }
+    quaternion<float> result;
+    for (size_t k = 0, j = 0; k < 4; ++k) {
+        result[k] = k == index ? std::sqrt(std::max(1 - n2, 0.0f)) : r[j++];
+    }
+    return result;
+}
+
+__vml_mathfunction inline quaternion<float> decode_smallest_three(
+    smallest_three32 code) {
+    return __vml_decode_smallest_three<10>(code);
+}
+
+template <vector_options O>
+__vml_mathfunction quaternion<float> decode_smallest_three(
+    vector<std::uint16_t, 3, O> const& code) {
+    return __vml_decode_smallest_three<15>(std::uint64_t(code.x) |
+                                           std::uint64_t(code.y) << 16 |
+                                           std::uint64_t(code.z) << 32);
+}
+
+/// MARK: - Batch
+
+namespace batch {
+
+template <typename R, typename... E>
+concept __vml_encoding_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    (std::same_as<__vml_batch_value_t<R>, E> || ...);
+
+/// `out[i] = encode_octahedral<Bits>(in[i])` where `Bits` is taken from the
+/// element type of \p out
+template <typename In, typename Out>
+    requires __vml_vector3_range<In, float> &&
+             __vml_encoding_range<Out, octahedral8, octahedral16>
+void encode_octahedral(In const& in, Out&& out) {
+    using U = typename __vml_batch_value_t<Out>::value_type;
+    constexpr size_t stride = __vml_batch_value_t<In>::data_size();
+    __vml_expect(std::ranges::size(in) == std::ranges::size(out));
+    __vml_batch_kernel(encode_octahedral, U)(
+        { __vml_batch_in(in), stride, 1 },
+        reinterpret_cast<U*>(std::ranges::data(out)), std::ranges::size(out));
+}
+
+/// `out[i] = decode_octahedral(in[i])`
+template <typename In, typename Out>
+    requires __vml_encoding_range<In, octahedral8, octahedral16> &&
+             __vml_vector3_range<Out, float>
+void decode_octahedral(In const& in, Out&& out) {
+    using U = typename __vml_batch_value_t<In>::value_type;
+    constexpr size_t stride = __vml_batch_value_t<Out>::data_size();
+    __vml_expect(std::ranges::size(in) == std::ranges::size(out));
+    __vml_batch_kernel(decode_octahedral, U)(
+        reinterpret_cast<U const*>(std::ranges::data(in)),
+        { __vml_batch_out(out), stride, 1 }, std::ranges::size(out));
+}
+
+/// `out[i] = encode_smallest_three<Bits>(in[i])` where `Bits` is taken from
+/// the element type of \p out
+template <typename In, typename Out>
+    requires __vml_encoding_range<In, quaternion<float>> &&
+             __vml_encoding_range<Out, smallest_three32, smallest_three48>
+void encode_smallest_three(In const& in, Out&& out) {
+    using U = std::conditional_t<
+        std::same_as<__vml_batch_value_t<Out>, smallest_three32>,
+        std::uint32_t, std::uint16_t>;
+    __vml_expect(std::ranges::size(in) == std::ranges::size(out));
+    __vml_batch_kernel(encode_smallest_three, U)(
+        reinterpret_cast<float const*>(std::ranges::data(in)),
+        reinterpret_cast<U*>(std::ranges::data(out)), std::ranges::size(out));
+}
+
+/// `out[i] = decode_smallest_three(in[i])`
+template <typename In, typename Out>
+    requires __vml_encoding_range<In, smallest_three32, smallest_three48> &&
+             __vml_encoding_range<Out, quaternion<float>>
+void decode_smallest_three(In const& in, Out&& out) {
+    using U = std::conditional_t<
+        std::same_as<__vml_batch_value_t<In>, smallest_three32>,
+        std::uint32_t, std::uint16_t>;
+    __vml_expect(std::ranges::size(in) == std::ranges::size(out));
+    __vml_batch_kernel(decode_smallest_three, U)(
+        reinterpret_cast<U const*>(std::ranges::data(in)),
+        reinterpret_cast<float*>(std::ranges::data(out)),
+        std::ranges::size(out));
+}
+
+} // namespace batch
+
+} // namespace _VVML
+
+#endif // __VML_ENCODING_HPP_INCLUDED__
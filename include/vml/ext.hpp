@@ -4,6 +4,8 @@
 #include <cmath>
 #include <concepts>
 #include <cstring>
+#include <limits>
+#include <utility>
 
 #include "common.hpp"
 #include "fwd.hpp"
@@ -348,6 +350,158 @@ __vml_mathfunction __vml_interface_export constexpr std::tuple<
     return { translation, decompose_rotation(dimension_cast<3, 3>(t)), scale };
 }
 
+/// MARK: - Symmetric Eigen Decomposition and SVD
+
+/// Jacobi sweeps over 3x3 matrices. Convergence is quadratic, after this many
+/// sweeps the off-diagonal elements are below the rounding error.
+template <typename T>
+inline constexpr int __vml_jacobi_sweeps = sizeof(T) <= 4 ? 4 : 5;
+
+/// Applies the Jacobi rotation in the \p p, \p q plane that zeroes `a[p][q]`
+/// to both sides of the symmetric matrix \p a and to the columns of \p v
+template <typename T>
+void __vml_jacobi_rotate(T (&a)[3][3], T (&v)[3][3], int p, int q) {
+    int const r = 3 - p - q;
+    T const d = a[q][q] - a[p][p];
+    T const o = a[p][q];
+    // Tangent of the rotation angle, the smaller root of
+    // `t^2 + 2 t d / (2 o) - 1`. The tiny summand makes it zero if `o` is.
+    T const t = std::copysign(T(2), d) * o /
+                (std::abs(d) + std::sqrt(d * d + 4 * o * o) +
+                 std::numeric_limits<T>::min());
+    T const c = 1 / std::sqrt(1 + t * t);
+    T const s = t * c;
+    a[p][p] -= t * o;
+    a[q][q] += t * o;
+    a[p][q] = a[q][p] = 0;
+    T const arp = a[r][p], arq = a[r][q];
+    a[r][p] = a[p][r] = c * arp - s * arq;
+    a[r][q] = a[q][r] = s * arp + c * arq;
+    for (int k = 0; k < 3; ++k) {
+        T const vp = v[k][p], vq = v[k][q];
+        v[k][p] = c * vp - s * vq;
+        v[k][q] = s * vp + c * vq;
+    }
+}
+
+/// `A = vectors * diag(values) * transpose(vectors)`
+template <typename T, vector_options O = vector_options{}>
+struct eigen_decomposition {
+    /// In descending order
+    vector3<T, O> values;
+    /// Column `i` is the unit eigenvector of `values[i]`. This is a rotation,
+    /// i.e. its determinant is `1`.
+    matrix3x3<T, O> vectors;
+};
+
+/// Eigen decomposition of the symmetric matrix \p m by a fixed number of
+/// cyclic Jacobi sweeps. Only the upper triangle of \p m is read.
+template <std::floating_point T, vector_options O>
+__vml_mathfunction __vml_interface_export eigen_decomposition<T, O>
+    eigen_symmetric(matrix3x3<T, O> const& m) {
+    T a[3][3], v[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            a[i][j] = m.__vml_at(std::min(i, j), std::max(i, j));
+            v[i][j] = T(i == j);
+        }
+    }
+    for (int sweep = 0; sweep < __vml_jacobi_sweeps<T>; ++sweep) {
+        __vml_jacobi_rotate(a, v, 0, 1);
+        __vml_jacobi_rotate(a, v, 0, 2);
+        __vml_jacobi_rotate(a, v, 1, 2);
+    }
+    T values[3] = { a[0][0], a[1][1], a[2][2] };
+    // Sorting network, negating one of the swapped columns keeps `v` a
+    // rotation
+    auto const order = [&](int i, int j) {
+        if (values[i] < values[j]) {
+            std::swap(values[i], values[j]);
+            for (int k = 0; k < 3; ++k) {
+                T const x = v[k][i];
+                v[k][i] = v[k][j];
+                v[k][j] = -x;
+            }
+        }
+    };
+    order(0, 1);
+    order(1, 2);
+    order(0, 1);
+    return { { values[0], values[1], values[2] },
+             { v[0][0], v[0][1], v[0][2], v[1][0], v[1][1], v[1][2], v[2][0],
+               v[2][1], v[2][2] } };
+}
+
+/// `A = u * diag(sigma) * transpose(v)`
+template <typename T, vector_options O = vector_options{}>
+struct singular_value_decomposition {
+    /// A rotation
+    matrix3x3<T, O> u;
+    /// Ordered by descending magnitude. `sigma[2]` has the sign of `det(A)`,
+    /// the others are not negative.
+    vector3<T, O> sigma;
+    /// A rotation
+    matrix3x3<T, O> v;
+};
+
+/// Applies the Givens rotation of rows \p p and \p r that zeroes element
+/// `(r, k)` of \p b to the rows of \p b and \p q
+template <typename T, vector_options O>
+void __vml_givens_rotate(matrix3x3<T, O>& b, matrix3x3<T, O>& q, size_t p,
+                         size_t r, size_t k) {
+    T const x = b.__vml_at(p, k), y = b.__vml_at(r, k);
+    T const rho = std::sqrt(x * x + y * y);
+    bool const zero = !(rho > std::numeric_limits<T>::min());
+    T const c = zero ? T(1) : x / rho;
+    T const s = zero ? T(0) : y / rho;
+    for (matrix3x3<T, O>* m: { &b, &q }) {
+        for (size_t j = 0; j < 3; ++j) {
+            T const mp = m->__vml_at(p, j), mr = m->__vml_at(r, j);
+            m->__vml_at(p, j) = c * mp + s * mr;
+            m->__vml_at(r, j) = c * mr - s * mp;
+        }
+    }
+}
+
+/// Singular value decomposition of \p m. `v` diagonalizes
+/// `transpose(m) * m` and the columns of `m * v` are orthogonalized by
+/// Givens rotations, which also handles rank deficient matrices. Singular
+/// values much smaller than the largest one have an absolute error of about
+/// the rounding error of the largest one.
+template <std::floating_point T, vector_options O>
+__vml_mathfunction __vml_interface_export singular_value_decomposition<T, O>
+    svd(matrix3x3<T, O> const& m) {
+    matrix3x3<T, O> const v = eigen_symmetric(transpose(m) * m).vectors;
+    // The QR decomposition of `m * v` has a diagonal `R` because the
+    // columns are orthogonal
+    matrix3x3<T, O> b = m * v;
+    matrix3x3<T, O> q(T(1));
+    __vml_givens_rotate(b, q, 0, 1, 0);
+    __vml_givens_rotate(b, q, 0, 2, 0);
+    __vml_givens_rotate(b, q, 1, 2, 1);
+    return { transpose(q),
+             { b.__vml_at(0, 0), b.__vml_at(1, 1), b.__vml_at(2, 2) },
+             v };
+}
+
+/// `A = rotation * stretch`
+template <typename T, vector_options O = vector_options{}>
+struct polar_decomposition {
+    matrix3x3<T, O> rotation;
+    /// Symmetric, positive semidefinite unless `det(A) < 0`
+    matrix3x3<T, O> stretch;
+};
+
+/// Polar decomposition of \p m computed from its SVD. `rotation` is the
+/// rotation closest to \p m, as used by shape matching.
+template <std::floating_point T, vector_options O>
+__vml_mathfunction __vml_interface_export polar_decomposition<T, O>
+    polar_decompose(matrix3x3<T, O> const& m) {
+    auto const [u, sigma, v] = svd(m);
+    matrix3x3<T, O> const vt = transpose(v);
+    return { u * vt, v * matrix3x3<T, O>::diag(sigma) * vt };
+}
+
 template <std::size_t Dim, std::floating_point T, vector_options O,
           std::floating_point U, vector_options P, real_scalar V>
 __vml_mathfunction __vml_interface_export constexpr vector<
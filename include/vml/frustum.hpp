@@ -0,0 +1,208 @@
+#ifndef __VML_FRUSTUM_HPP_INCLUDED__
+#define __VML_FRUSTUM_HPP_INCLUDED__
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <ranges>
+#include <span>
+
+#include "batch.hpp"
+#include "fwd.hpp"
+#include "matrix.hpp"
+#include "shapes.hpp"
+#include "vector.hpp"
+
+/// # Frustum
+///
+/// `frustum<T>` holds the 6 planes of a view-projection matrix, extracted
+/// from its rows as described by Gribb and Hartmann. The shape tests are
+/// conservative: a shape is only culled if it lies entirely outside of one
+/// plane, so large shapes near the corners of the frustum can pass although
+/// they are not visible.
+///
+/// The batch variants test `S::width` shapes at a time using the kernels in
+/// "batch_kernels.hpp", that is 8 `float` shapes with AVX2, 16 with AVX-512
+/// and 4 with SSE2.
+
+namespace _VVML {
+
+/// Depth range of clip space. `perspective()` and `ortho()` map to
+/// `zero_to_one`, `infinite_perspective()` to `negative_one_to_one`.
+enum class clip_depth { zero_to_one, negative_one_to_one };
+
+/// MARK: - class frustum
+template <typename T = float>
+class frustum {
+    static_assert(std::is_floating_point_v<T>);
+
+public:
+    using plane_type = vector4<T>;
+
+    /// Extracts the planes of \p view_projection, which maps world space to
+    /// clip space as `view_projection * (p, 1)`. Planes with a zero normal,
+    /// like the far plane of infinite projections, accept every point.
+    template <vector_options O>
+    explicit frustum(matrix4x4<T, O> const& view_projection,
+                     clip_depth depth = clip_depth::zero_to_one) {
+        plane_type const r0 = view_projection.row(0);
+        plane_type const r1 = view_projection.row(1);
+        plane_type const r2 = view_projection.row(2);
+        plane_type const r3 = view_projection.row(3);
+        _planes = { r3 + r0, r3 - r0, r3 + r1, r3 - r1,
+                    depth == clip_depth::zero_to_one ? r2 : r3 + r2,
+                    r3 - r2 };
+        for (plane_type& p: _planes) {
+            T const length = norm(p.xyz);
+            if (length > 0) {
+                p /= length;
+            }
+            else {
+                p = { 0, 0, 0, 1 };
+            }
+        }
+    }
+
+    /// The normalized planes in the order left, right, bottom, top, near,
+    /// far. Each is `(n, d)` with the inside where `dot(n, p) + d >= 0`.
+    std::array<plane_type, 6> const& planes() const { return _planes; }
+
+    /// Signed distance of \p p to plane \p i, positive inside
+    template <vector_options O>
+    T distance(size_t i, vector3<T, O> const& p) const {
+        __vml_expect(i < 6);
+        plane_type const& plane = _planes[i];
+        return dot(plane.xyz, vector3<T>(p)) + plane.w;
+    }
+
+    template <vector_options O>
+    bool contains(vector3<T, O> const& p) const {
+        for (size_t i = 0; i < 6; ++i) {
+            if (distance(i, p) < 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// `false` if \p b is entirely outside of the frustum. Tests the corner
+    /// of \p b that is farthest along each plane normal.
+    template <vector_options O>
+    bool intersects(AABB<T, 3, O> const& b) const {
+        vector3<T> const e = vector3<T>(b.size()) / 2;
+        vector3<T> const c = vector3<T>(b.lower_bound()) + e;
+        for (size_t i = 0; i < 6; ++i) {
+            if (distance(i, c) + dot(abs(_planes[i].xyz), e) < 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// `false` if \p s is entirely outside of the frustum
+    template <vector_options O>
+    bool intersects(sphere<T, 3, O> const& s) const {
+        for (size_t i = 0; i < 6; ++i) {
+            if (distance(i, s.origin()) + s.radius() < 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::array<plane_type, 6> _planes;
+};
+
+/// MARK: - Batch Culling
+
+template <typename>
+struct __vml_cull_shape: std::false_type {};
+
+/// The boxes are read as the scalars of their origin followed by their size
+template <typename T, vector_options O>
+struct __vml_cull_shape<AABB<T, 3, O>>: std::true_type {
+    using scalar_type = T;
+    static constexpr bool boxes = true;
+    static constexpr size_t extent = vector3<T, O>::data_size();
+    static constexpr size_t stride = sizeof(AABB<T, 3, O>) / sizeof(T);
+    static_assert(sizeof(AABB<T, 3, O>) == 2 * sizeof(vector3<T, O>));
+};
+
+/// The spheres are read as the scalars of their origin followed by their
+/// radius
+template <typename T, vector_options O>
+struct __vml_cull_shape<sphere<T, 3, O>>: std::true_type {
+    using scalar_type = T;
+    static constexpr bool boxes = false;
+    static constexpr size_t extent = vector3<T, O>::data_size();
+    static constexpr size_t stride = sizeof(sphere<T, 3, O>) / sizeof(T);
+    static_assert(sizeof(sphere<T, 3, O>) % sizeof(T) == 0);
+};
+
+/// Contiguous ranges of `AABB<T, 3>` or `sphere<T, 3>`
+template <typename R, typename T>
+concept __vml_cull_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    __vml_cull_shape<batch::__vml_batch_value_t<R>>::value &&
+    std::same_as<
+        typename __vml_cull_shape<batch::__vml_batch_value_t<R>>::scalar_type,
+        T>;
+
+template <typename T, typename R>
+void __vml_cull(frustum<T> const& f, R const& shapes, size_t offset,
+                size_t count, std::uint64_t* visible) {
+    using Shape = __vml_cull_shape<batch::__vml_batch_value_t<R>>;
+    T const* const planes = reinterpret_cast<T const*>(f.planes().data());
+    T const* const data =
+        reinterpret_cast<T const*>(std::ranges::data(shapes)) +
+        offset * Shape::stride;
+    __vml_batch_kernel(cull, T)(planes, Shape::boxes,
+                                { data, Shape::stride, 1 }, Shape::extent,
+                                visible, count);
+}
+
+/// Sets bit `i % 64` of `visible[i / 64]` if `f.intersects(shapes[i])`. The
+/// `(size(shapes) + 63) / 64` words of \p visible are overwritten.
+template <typename T, typename R>
+    requires __vml_cull_range<R, T>
+void cull(frustum<T> const& f, R const& shapes,
+          std::span<std::uint64_t> visible) {
+    size_t const n = std::ranges::size(shapes);
+    __vml_expect(visible.size() >= (n + 63) / 64);
+    __vml_cull(f, shapes, 0, n, visible.data());
+}
+
+/// Writes the indices `i` with `f.intersects(shapes[i])` to the front of
+/// \p indices in ascending order and returns their number. \p indices must
+/// be as large as \p shapes.
+template <typename T, typename R>
+    requires __vml_cull_range<R, T>
+size_t cull_indices(frustum<T> const& f, R const& shapes,
+                    std::span<std::uint32_t> indices) {
+    size_t const n = std::ranges::size(shapes);
+    __vml_expect(indices.size() >= n);
+    // Culls blocks into a small bit mask and compacts it right away
+    constexpr size_t block_words = 16;
+    std::uint64_t visible[block_words];
+    size_t result = 0;
+    for (size_t begin = 0; begin < n; begin += 64 * block_words) {
+        size_t const count = std::min(n - begin, 64 * block_words);
+        __vml_cull(f, shapes, begin, count, visible);
+        for (size_t w = 0; w < (count + 63) / 64; ++w) {
+            for (std::uint64_t bits = visible[w]; bits != 0;
+                 bits &= bits - 1) {
+                indices[result++] = std::uint32_t(begin + 64 * w +
+                                                  std::countr_zero(bits));
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace _VVML
+
+#endif // __VML_FRUSTUM_HPP_INCLUDED__
@@ -25,6 +25,14 @@
 #define VML_SAFE_MATH 1
 #endif
 
+#ifndef VML_DETERMINISTIC
+#define VML_DETERMINISTIC 0
+#endif
+
+#ifndef VML_FP_CONTRACT_OFF
+#define VML_FP_CONTRACT_OFF 0
+#endif
+
 #ifndef VML_DEFAULT_PACKED
 #define VML_DEFAULT_PACKED 0
 #endif
@@ -33,6 +41,10 @@
 #define VML_AVX 0
 #endif
 
+#ifndef VML_RUNTIME_DISPATCH
+#define VML_RUNTIME_DISPATCH 0
+#endif
+
 #ifndef VML_NAMESPACE_NAME
 #define VML_NAMESPACE_NAME vml
 #endif
@@ -132,6 +144,30 @@
 #define __vml_safe_math_if(...) if constexpr ((0))
 #endif
 
+/// # Deterministic Math
+
+#if VML_DETERMINISTIC
+#if defined(__FAST_MATH__)
+#error VML_DETERMINISTIC cannot be combined with -ffast-math
+#endif
+/// Placed at the start of function bodies whose multiplies and adds must not
+/// be contracted to FMA. GCC has no scoped equivalent and contracts across
+/// statements by default, also with `-std=c++20`. It needs
+/// `-ffp-contract=off`, and since that can't be detected from the source,
+/// `VML_FP_CONTRACT_OFF` confirms it. The CMake option `VML_DETERMINISTIC`
+/// sets both.
+#if defined(__clang__)
+#define __vml_no_contract _Pragma("clang fp contract(off)")
+#else
+#if defined(__GNUC__) && !VML_FP_CONTRACT_OFF
+#error GCC needs -ffp-contract=off and VML_FP_CONTRACT_OFF for VML_DETERMINISTIC
+#endif
+#define __vml_no_contract
+#endif
+#else
+#define __vml_no_contract
+#endif
+
 namespace _VVML {
 
 /**
@@ -182,6 +218,15 @@ struct complex;
 template <typename T>
 struct quaternion;
 
+struct half;
+struct bfloat16;
+
+template <typename T, size_t W>
+struct simd_lane;
+
+template <typename T, size_t W>
+struct simd_mask;
+
 inline namespace short_types {
 
 using complex_float = complex<float>;
@@ -274,6 +319,12 @@ using double4 = vector4<double>;
 using ldouble2 = vector2<long double>;
 using ldouble3 = vector3<long double>;
 using ldouble4 = vector4<long double>;
+using half2 = vector2<half>;
+using half3 = vector3<half>;
+using half4 = vector4<half>;
+using bfloat2 = vector2<bfloat16>;
+using bfloat3 = vector3<bfloat16>;
+using bfloat4 = vector4<bfloat16>;
 
 using packed_bool2 = vector2<bool, vector_options{}.packed(true)>;
 using packed_bool3 = vector3<bool, vector_options{}.packed(true)>;
@@ -320,6 +371,12 @@ using packed_double4 = vector4<double, vector_options{}.packed(true)>;
 using packed_ldouble2 = vector2<long double, vector_options{}.packed(true)>;
 using packed_ldouble3 = vector3<long double, vector_options{}.packed(true)>;
 using packed_ldouble4 = vector4<long double, vector_options{}.packed(true)>;
+using packed_half2 = vector2<half, vector_options{}.packed(true)>;
+using packed_half3 = vector3<half, vector_options{}.packed(true)>;
+using packed_half4 = vector4<half, vector_options{}.packed(true)>;
+using packed_bfloat2 = vector2<bfloat16, vector_options{}.packed(true)>;
+using packed_bfloat3 = vector3<bfloat16, vector_options{}.packed(true)>;
+using packed_bfloat4 = vector4<bfloat16, vector_options{}.packed(true)>;
 
 using aligned_bool2 = vector2<bool, vector_options{}.packed(false)>;
 using aligned_bool3 = vector3<bool, vector_options{}.packed(false)>;
@@ -366,6 +423,42 @@ using aligned_double4 = vector4<double, vector_options{}.packed(false)>;
 using aligned_ldouble2 = vector2<long double, vector_options{}.packed(false)>;
 using aligned_ldouble3 = vector3<long double, vector_options{}.packed(false)>;
 using aligned_ldouble4 = vector4<long double, vector_options{}.packed(false)>;
+using aligned_half2 = vector2<half, vector_options{}.packed(false)>;
+using aligned_half3 = vector3<half, vector_options{}.packed(false)>;
+using aligned_half4 = vector4<half, vector_options{}.packed(false)>;
+using aligned_bfloat2 = vector2<bfloat16, vector_options{}.packed(false)>;
+using aligned_bfloat3 = vector3<bfloat16, vector_options{}.packed(false)>;
+using aligned_bfloat4 = vector4<bfloat16, vector_options{}.packed(false)>;
+
+} // namespace short_types
+
+/// Packet types, see "simd_lane.hpp". `float3_lane8` holds eight `float3`
+/// in structure-of-arrays layout.
+inline namespace short_types {
+
+using float_lane4 = simd_lane<float, 4>;
+using float_lane8 = simd_lane<float, 8>;
+using double_lane2 = simd_lane<double, 2>;
+using double_lane4 = simd_lane<double, 4>;
+using int_lane4 = simd_lane<int, 4>;
+using int_lane8 = simd_lane<int, 8>;
+using uint_lane4 = simd_lane<unsigned int, 4>;
+using uint_lane8 = simd_lane<unsigned int, 8>;
+
+using float_mask4 = simd_mask<float, 4>;
+using float_mask8 = simd_mask<float, 8>;
+using double_mask2 = simd_mask<double, 2>;
+using double_mask4 = simd_mask<double, 4>;
+
+using float2_lane4 = vector2<float_lane4>;
+using float3_lane4 = vector3<float_lane4>;
+using float4_lane4 = vector4<float_lane4>;
+using float2_lane8 = vector2<float_lane8>;
+using float3_lane8 = vector3<float_lane8>;
+using float4_lane8 = vector4<float_lane8>;
+using double2_lane4 = vector2<double_lane4>;
+using double3_lane4 = vector3<double_lane4>;
+using double4_lane4 = vector4<double_lane4>;
 
 } // namespace short_types
 
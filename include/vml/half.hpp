@@ -0,0 +1,274 @@
+#ifndef __VML_HALF_HPP_INCLUDED__
+#define __VML_HALF_HPP_INCLUDED__
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include <immintrin.h>
+
+#include "common.hpp"
+#include "fwd.hpp"
+
+/// 16 bit floating point types.
+///
+/// `half` is IEEE 754 binary16, `bfloat16` the upper 16 bits of a `float`.
+/// Both are storage types: arithmetic converts the operands to `float` and
+/// the result is rounded back when it is assigned to a 16 bit type.
+/// Conversions from `float` round to nearest even, conversions from `double`
+/// go through `float`.
+
+namespace _VVML {
+
+/// MARK: - Conversions
+
+constexpr std::uint16_t __vml_float_to_half(float value) {
+#if defined(__F16C__)
+    if (!std::is_constant_evaluated()) {
+        return std::uint16_t(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+    }
+#endif
+    std::uint32_t const x = std::bit_cast<std::uint32_t>(value);
+    std::uint32_t const sign = (x >> 16) & 0x8000;
+    std::uint32_t const abs = x & 0x7fffffff;
+    if (abs >= 0x7f800000) {
+        // Infinity or NaN, NaNs stay quiet NaNs
+        std::uint32_t const nan = abs > 0x7f800000 ? 0x200 : 0;
+        return std::uint16_t(sign | 0x7c00 | nan | ((abs >> 13) & 0x3ff));
+    }
+    if (abs >= 0x477ff000) {
+        // Rounds to 65520 or above
+        return std::uint16_t(sign | 0x7c00);
+    }
+    if (abs < 0x38800000) {
+        // Subnormal, the ulp of 0.5 is the ulp of subnormal halfs so the
+        // addition rounds the mantissa for us
+        float const shifted = std::bit_cast<float>(abs) + 0.5f;
+        return std::uint16_t(sign | (std::bit_cast<std::uint32_t>(shifted) -
+                                     std::bit_cast<std::uint32_t>(0.5f)));
+    }
+    std::uint32_t const rounded = abs + 0xfff + ((abs >> 13) & 1);
+    return std::uint16_t(sign | ((rounded - 0x38000000) >> 13));
+}
+
+constexpr float __vml_half_to_float(std::uint16_t bits) {
+#if defined(__F16C__)
+    if (!std::is_constant_evaluated()) {
+        return _cvtsh_ss(bits);
+    }
+#endif
+    std::uint32_t const sign = std::uint32_t(bits & 0x8000) << 16;
+    std::uint32_t const exponent = (bits >> 10) & 0x1f;
+    std::uint32_t const mantissa = bits & 0x3ff;
+    if (exponent == 0x1f) {
+        return std::bit_cast<float>(sign | 0x7f800000 | (mantissa << 13));
+    }
+    if (exponent == 0) {
+        float const result = float(mantissa) * 0x1p-24f;
+        return sign ? -result : result;
+    }
+    return std::bit_cast<float>(sign | ((exponent + 112) << 23) |
+                                (mantissa << 13));
+}
+
+constexpr std::uint16_t __vml_float_to_bfloat16(float value) {
+    std::uint32_t const x = std::bit_cast<std::uint32_t>(value);
+    if ((x & 0x7fffffff) > 0x7f800000) {
+        // Truncating could turn a NaN into infinity
+        return std::uint16_t((x >> 16) | 0x40);
+    }
+    return std::uint16_t((x + 0x7fff + ((x >> 16) & 1)) >> 16);
+}
+
+constexpr float __vml_bfloat16_to_float(std::uint16_t bits) {
+    return std::bit_cast<float>(std::uint32_t(bits) << 16);
+}
+
+/// MARK: - half
+
+/// IEEE 754 half precision float: 1 sign, 5 exponent and 10 mantissa bits
+struct half {
+    half() = default;
+
+    constexpr half(float value): __bits(__vml_float_to_half(value)) {}
+
+    constexpr operator float() const { return __vml_half_to_float(__bits); }
+
+    static constexpr half from_bits(std::uint16_t bits) {
+        half result;
+        result.__bits = bits;
+        return result;
+    }
+
+    constexpr std::uint16_t bits() const { return __bits; }
+
+    constexpr half& operator+=(float rhs) { return *this = *this + rhs; }
+    constexpr half& operator-=(float rhs) { return *this = *this - rhs; }
+    constexpr half& operator*=(float rhs) { return *this = *this * rhs; }
+    constexpr half& operator/=(float rhs) { return *this = *this / rhs; }
+
+    std::uint16_t __bits;
+};
+
+/// MARK: - bfloat16
+
+/// Brain float: 1 sign, 8 exponent and 7 mantissa bits. Same range as
+/// `float` with less precision.
+struct bfloat16 {
+    bfloat16() = default;
+
+    constexpr bfloat16(float value): __bits(__vml_float_to_bfloat16(value)) {}
+
+    constexpr operator float() const {
+        return __vml_bfloat16_to_float(__bits);
+    }
+
+    static constexpr bfloat16 from_bits(std::uint16_t bits) {
+        bfloat16 result;
+        result.__bits = bits;
+        return result;
+    }
+
+    constexpr std::uint16_t bits() const { return __bits; }
+
+    constexpr bfloat16& operator+=(float rhs) { return *this = *this + rhs; }
+    constexpr bfloat16& operator-=(float rhs) { return *this = *this - rhs; }
+    constexpr bfloat16& operator*=(float rhs) { return *this = *this * rhs; }
+    constexpr bfloat16& operator/=(float rhs) { return *this = *this / rhs; }
+
+    std::uint16_t __bits;
+};
+
+static_assert(sizeof(half) == 2 && std::is_trivially_copyable_v<half>);
+static_assert(sizeof(bfloat16) == 2 &&
+              std::is_trivially_copyable_v<bfloat16>);
+
+/// MARK: - Traits
+
+template <>
+struct is_real_scalar<half>: std::true_type {};
+template <>
+struct is_real_scalar<bfloat16>: std::true_type {};
+
+template <>
+struct __vml_to_float<half> {
+    using type = float;
+};
+template <>
+struct __vml_to_float<bfloat16> {
+    using type = float;
+};
+
+template <typename T>
+concept __vml_float16 = __vml_any_of<std::remove_cv_t<T>, half, bfloat16>;
+
+} // namespace _VVML
+
+/// Mixed expressions compute in `float`, or wider if the other operand is
+/// wider
+template <_VVML::__vml_float16 T, typename U>
+    requires std::is_arithmetic_v<U>
+struct std::common_type<T, U> {
+    using type = std::common_type_t<float, U>;
+};
+
+template <typename T, _VVML::__vml_float16 U>
+    requires std::is_arithmetic_v<T>
+struct std::common_type<T, U> {
+    using type = std::common_type_t<T, float>;
+};
+
+template <>
+struct std::common_type<_VVML::half, _VVML::bfloat16> {
+    using type = float;
+};
+
+template <>
+struct std::common_type<_VVML::bfloat16, _VVML::half> {
+    using type = float;
+};
+
+/// MARK: - numeric_limits
+
+template <>
+struct std::numeric_limits<_VVML::half> {
+    using half = _VVML::half;
+
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr bool has_signaling_NaN = true;
+    static constexpr bool is_iec559 = true;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = false;
+    static constexpr std::float_round_style round_style = std::round_to_nearest;
+    static constexpr int radix = 2;
+    static constexpr int digits = 11;
+    static constexpr int digits10 = 3;
+    static constexpr int max_digits10 = 5;
+    static constexpr int min_exponent = -13;
+    static constexpr int min_exponent10 = -4;
+    static constexpr int max_exponent = 16;
+    static constexpr int max_exponent10 = 4;
+
+    static constexpr half min() { return half::from_bits(0x0400); }
+    static constexpr half lowest() { return half::from_bits(0xfbff); }
+    static constexpr half max() { return half::from_bits(0x7bff); }
+    static constexpr half epsilon() { return half::from_bits(0x1400); }
+    static constexpr half round_error() { return half::from_bits(0x3800); }
+    static constexpr half infinity() { return half::from_bits(0x7c00); }
+    static constexpr half quiet_NaN() { return half::from_bits(0x7e00); }
+    static constexpr half signaling_NaN() { return half::from_bits(0x7d00); }
+    static constexpr half denorm_min() { return half::from_bits(0x0001); }
+};
+
+template <>
+struct std::numeric_limits<_VVML::bfloat16> {
+    using bfloat16 = _VVML::bfloat16;
+
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr bool has_signaling_NaN = true;
+    static constexpr bool is_iec559 = false;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = false;
+    static constexpr std::float_round_style round_style = std::round_to_nearest;
+    static constexpr int radix = 2;
+    static constexpr int digits = 8;
+    static constexpr int digits10 = 2;
+    static constexpr int max_digits10 = 4;
+    static constexpr int min_exponent = -125;
+    static constexpr int min_exponent10 = -37;
+    static constexpr int max_exponent = 128;
+    static constexpr int max_exponent10 = 38;
+
+    static constexpr bfloat16 min() { return bfloat16::from_bits(0x0080); }
+    static constexpr bfloat16 lowest() { return bfloat16::from_bits(0xff7f); }
+    static constexpr bfloat16 max() { return bfloat16::from_bits(0x7f7f); }
+    static constexpr bfloat16 epsilon() { return bfloat16::from_bits(0x3c00); }
+    static constexpr bfloat16 round_error() {
+        return bfloat16::from_bits(0x3f00);
+    }
+    static constexpr bfloat16 infinity() {
+        return bfloat16::from_bits(0x7f80);
+    }
+    static constexpr bfloat16 quiet_NaN() {
+        return bfloat16::from_bits(0x7fc0);
+    }
+    static constexpr bfloat16 signaling_NaN() {
+        return bfloat16::from_bits(0x7fa0);
+    }
+    static constexpr bfloat16 denorm_min() {
+        return bfloat16::from_bits(0x0001);
+    }
+};
+
+#endif // __VML_HALF_HPP_INCLUDED__
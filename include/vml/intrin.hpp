@@ -1,6 +1,7 @@
 #ifndef __VML_INTRIN_HPP_INCLUDED__
 #define __VML_INTRIN_HPP_INCLUDED__
 
+#include <cmath>
 #include <cstddef>
 
 #include <immintrin.h>
@@ -9,26 +10,148 @@
 
 namespace vml {
 
+/// Generic backend, operates element-wise on plain arrays.
+/// All operations work in place on their first argument, since arrays can't
+/// be returned from functions. Comparisons write a mask into the first
+/// argument with nonzero lanes where the comparison holds.
 template <typename T, size_t Size, bool Packed>
 struct __simd_type {
     using type = T[Size];
     static T get(type const& array, size_t index) { return array[index]; }
+    static void splat(type& a, T value) {
+        for (size_t i = 0; i < Size; ++i) {
+            a[i] = value;
+        }
+    }
+    /// Unaligned load and store
+    static void load(type& a, T const* p) {
+        for (size_t i = 0; i < Size; ++i) {
+            a[i] = p[i];
+        }
+    }
+    static void store(type const& a, T* p) {
+        for (size_t i = 0; i < Size; ++i) {
+            p[i] = a[i];
+        }
+    }
 
+    static void add(type& a, type const& b) {
+        for (size_t i = 0; i < Size; ++i) {
+            a[i] += b[i];
+        }
+    }
+    static void sub(type& a, type const& b) {
+        for (size_t i = 0; i < Size; ++i) {
+            a[i] -= b[i];
+        }
+    }
     static void mul(type& a, type const& b) {
-        for (int i = 0; i < Size; ++i) {
+        for (size_t i = 0; i < Size; ++i) {
             a[i] *= b[i];
         }
     }
     static void div(type& a, type const& b) {
-        for (int i = 0; i < Size; ++i) {
+        for (size_t i = 0; i < Size; ++i) {
             a[i] /= b[i];
         }
     }
+    /// `a = a * b + c`
+    static void fma(type& a, type const& b, type const& c) {
+        __vml_no_contract;
+        for (size_t i = 0; i < Size; ++i) {
+            a[i] = a[i] * b[i] + c[i];
+        }
+    }
+    static void min(type& a, type const& b) {
+        for (size_t i = 0; i < Size; ++i) {
+            a[i] = b[i] < a[i] ? b[i] : a[i];
+        }
+    }
+    static void max(type& a, type const& b) {
+        for (size_t i = 0; i < Size; ++i) {
+            a[i] = a[i] < b[i] ? b[i] : a[i];
+        }
+    }
+    static void abs(type& a) {
+        for (size_t i = 0; i < Size; ++i) {
+            using std::abs;
+            a[i] = abs(a[i]);
+        }
+    }
+    static void sqrt(type& a) {
+        for (size_t i = 0; i < Size; ++i) {
+            using std::sqrt;
+            a[i] = sqrt(a[i]);
+        }
+    }
+
+    static void cmp_eq(type& a, type const& b) {
+        for (size_t i = 0; i < Size; ++i) {
+            a[i] = T(a[i] == b[i]);
+        }
+    }
+    static void cmp_lt(type& a, type const& b) {
+        for (size_t i = 0; i < Size; ++i) {
+            a[i] = T(a[i] < b[i]);
+        }
+    }
+    static void cmp_le(type& a, type const& b) {
+        for (size_t i = 0; i < Size; ++i) {
+            a[i] = T(a[i] <= b[i]);
+        }
+    }
+    /// Bit `i` of the result is set if lane `i` of \p mask is set
+    static unsigned movemask(type const& mask) {
+        static_assert(Size <= 32, "The mask does not fit into `unsigned`");
+        unsigned result = 0;
+        for (size_t i = 0; i < Size; ++i) {
+            result |= unsigned(mask[i] != T(0)) << i;
+        }
+        return result;
+    }
+    /// `a = mask ? b : a`
+    static void blend(type& a, type const& b, type const& mask) {
+        for (size_t i = 0; i < Size; ++i) {
+            a[i] = mask[i] != T(0) ? b[i] : a[i];
+        }
+    }
+
+    static T hsum(type const& a) {
+        T result = a[0];
+        for (size_t i = 1; i < Size; ++i) {
+            result += a[i];
+        }
+        return result;
+    }
+    /// Lane `k` of the result is lane `I_k` of \p a
+    template <size_t... I>
+        requires(sizeof...(I) == Size)
+    static void shuffle(type& a) {
+        T const tmp[Size]{ a[I]... };
+        for (size_t i = 0; i < Size; ++i) {
+            a[i] = tmp[i];
+        }
+    }
+    /// The lower half of the result is taken from \p a and the upper half
+    /// from \p b, like `_mm_shuffle_ps`
+    template <size_t... I>
+        requires(sizeof...(I) == Size && Size % 2 == 0)
+    static void shuffle2(type& a, type const& b) {
+        size_t const index[Size]{ I... };
+        T tmp[Size];
+        for (size_t i = 0; i < Size; ++i) {
+            tmp[i] = i < Size / 2 ? a[index[i]] : b[index[i]];
+        }
+        for (size_t i = 0; i < Size; ++i) {
+            a[i] = tmp[i];
+        }
+    }
 };
 
 template <typename T, size_t Size, bool Packed>
 using __simd_type_t = typename __simd_type<T, Size, Packed>::type;
 
+/// MARK: float4
 template <>
 struct __simd_type<float, 4, false> {
     using type = __m128;
@@ -40,12 +163,283 @@ struct __simd_type<float, 4, false> {
         return array[index];
 #endif
     }
+    static void splat(type& a, float value) { a = _mm_set1_ps(value); }
+    static void load(type& a, float const* p) { a = _mm_loadu_ps(p); }
+    static void store(type const& a, float* p) { _mm_storeu_ps(p, a); }
 
+    static void add(type& a, type const& b) { a = _mm_add_ps(a, b); }
+    static void sub(type& a, type const& b) { a = _mm_sub_ps(a, b); }
     static void mul(type& a, type const& b) { a = _mm_mul_ps(a, b); }
     static void div(type& a, type const& b) { a = _mm_div_ps(a, b); }
+    static void fma(type& a, type const& b, type const& c) {
+#if defined(__FMA__) && !VML_DETERMINISTIC
+        a = _mm_fmadd_ps(a, b, c);
+#else
+        a = _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+    }
+    /// Operands are swapped to match the NaN behaviour of `vml::min/max`
+    static void min(type& a, type const& b) { a = _mm_min_ps(b, a); }
+    static void max(type& a, type const& b) { a = _mm_max_ps(b, a); }
+    static void abs(type& a) { a = _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static void sqrt(type& a) { a = _mm_sqrt_ps(a); }
+
+    static void cmp_eq(type& a, type const& b) { a = _mm_cmpeq_ps(a, b); }
+    static void cmp_lt(type& a, type const& b) { a = _mm_cmplt_ps(a, b); }
+    static void cmp_le(type& a, type const& b) { a = _mm_cmple_ps(a, b); }
+    static unsigned movemask(type const& mask) {
+        return unsigned(_mm_movemask_ps(mask));
+    }
+    static void blend(type& a, type const& b, type const& mask) {
+#if defined(__SSE4_1__)
+        a = _mm_blendv_ps(a, b, mask);
+#else
+        a = _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+#endif
+    }
+
+    static float hsum(type const& a) {
+        type shuf = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+        type sums = _mm_add_ps(a, shuf);
+        shuf = _mm_movehl_ps(shuf, sums);
+        return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+    }
+    template <size_t I0, size_t I1, size_t I2, size_t I3>
+    static void shuffle(type& a) {
+        a = _mm_shuffle_ps(a, a, _MM_SHUFFLE(I3, I2, I1, I0));
+    }
+    template <size_t I0, size_t I1, size_t I2, size_t I3>
+    static void shuffle2(type& a, type const& b) {
+        a = _mm_shuffle_ps(a, b, _MM_SHUFFLE(I3, I2, I1, I0));
+    }
+};
+
+/// MARK: float3
+/// Aligned `float3` is padded to 16 bytes and shares the `float4` operations.
+/// The padding lane is unspecified and never observed.
+template <>
+struct __simd_type<float, 3, false>: private __simd_type<float, 4, false> {
+    using __vml_base = __simd_type<float, 4, false>;
+    using type = __m128;
+
+    using __vml_base::get;
+    using __vml_base::splat;
+    static void load(type& a, float const* p) {
+        a = _mm_setr_ps(p[0], p[1], p[2], 0.0f);
+    }
+    static void store(type const& a, float* p) {
+        _mm_storel_pi((__m64*)p, a);
+        _mm_store_ss(p + 2, _mm_movehl_ps(a, a));
+    }
+
+    using __vml_base::abs;
+    using __vml_base::add;
+    using __vml_base::blend;
+    using __vml_base::cmp_eq;
+    using __vml_base::cmp_le;
+    using __vml_base::cmp_lt;
+    using __vml_base::div;
+    using __vml_base::fma;
+    using __vml_base::max;
+    using __vml_base::min;
+    using __vml_base::mul;
+    using __vml_base::sqrt;
+    using __vml_base::sub;
+
+    static unsigned movemask(type const& mask) {
+        return __vml_base::movemask(mask) & 0b111;
+    }
+    static float hsum(type const& a) {
+        type const y = _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1));
+        type const z = _mm_movehl_ps(a, a);
+        return _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(a, y), z));
+    }
+};
+
+/// MARK: int4
+template <>
+struct __simd_type<int, 4, false> {
+    using type = __m128i;
+
+    static int get(type const& array, size_t index) {
+#if defined(_MSC_VER)
+        return array.m128i_i32[index];
+#else
+        return ((__v4si)array)[index];
+#endif
+    }
+    static void splat(type& a, int value) { a = _mm_set1_epi32(value); }
+    static void load(type& a, int const* p) {
+        a = _mm_loadu_si128((type const*)p);
+    }
+    static void store(type const& a, int* p) { _mm_storeu_si128((type*)p, a); }
+
+    static void add(type& a, type const& b) { a = _mm_add_epi32(a, b); }
+    static void sub(type& a, type const& b) { a = _mm_sub_epi32(a, b); }
+    static void mul(type& a, type const& b) {
+#if defined(__SSE4_1__)
+        a = _mm_mullo_epi32(a, b);
+#else
+        // The low 32 bits of the product are the same for signed and unsigned
+        // operands
+        type const even = _mm_mul_epu32(a, b);
+        type const odd =
+            _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        a = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                               _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+    }
+    /// There is no SIMD integer division
+    static void div(type& a, type const& b) {
+        alignas(16) int x[4], y[4];
+        _mm_store_si128((type*)x, a);
+        _mm_store_si128((type*)y, b);
+        for (size_t i = 0; i < 4; ++i) {
+            x[i] /= y[i];
+        }
+        a = _mm_load_si128((type const*)x);
+    }
+    static void fma(type& a, type const& b, type const& c) {
+        mul(a, b);
+        add(a, c);
+    }
+    static void min(type& a, type const& b) {
+#if defined(__SSE4_1__)
+        a = _mm_min_epi32(a, b);
+#else
+        type const mask = _mm_cmplt_epi32(b, a);
+        a = _mm_or_si128(_mm_and_si128(mask, b), _mm_andnot_si128(mask, a));
+#endif
+    }
+    static void max(type& a, type const& b) {
+#if defined(__SSE4_1__)
+        a = _mm_max_epi32(a, b);
+#else
+        type const mask = _mm_cmplt_epi32(a, b);
+        a = _mm_or_si128(_mm_and_si128(mask, b), _mm_andnot_si128(mask, a));
+#endif
+    }
+    static void abs(type& a) {
+#if defined(__SSSE3__)
+        a = _mm_abs_epi32(a);
+#else
+        type const sign = _mm_srai_epi32(a, 31);
+        a = _mm_sub_epi32(_mm_xor_si128(a, sign), sign);
+#endif
+    }
+
+    static void cmp_eq(type& a, type const& b) { a = _mm_cmpeq_epi32(a, b); }
+    static void cmp_lt(type& a, type const& b) { a = _mm_cmplt_epi32(a, b); }
+    static void cmp_le(type& a, type const& b) {
+        a = _mm_andnot_si128(_mm_cmpgt_epi32(a, b), _mm_set1_epi32(-1));
+    }
+    static unsigned movemask(type const& mask) {
+        return unsigned(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+    }
+    static void blend(type& a, type const& b, type const& mask) {
+        a = _mm_or_si128(_mm_and_si128(mask, b), _mm_andnot_si128(mask, a));
+    }
+
+    static int hsum(type const& a) {
+        type sums =
+            _mm_add_epi32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(2, 3, 0, 1)));
+        sums = _mm_add_epi32(sums,
+                             _mm_shuffle_epi32(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtsi128_si32(sums);
+    }
+    template <size_t I0, size_t I1, size_t I2, size_t I3>
+    static void shuffle(type& a) {
+        a = _mm_shuffle_epi32(a, _MM_SHUFFLE(I3, I2, I1, I0));
+    }
+    template <size_t I0, size_t I1, size_t I2, size_t I3>
+    static void shuffle2(type& a, type const& b) {
+        a = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a),
+                                            _mm_castsi128_ps(b),
+                                            _MM_SHUFFLE(I3, I2, I1, I0)));
+    }
+};
+
+/// MARK: uint4
+/// Shares the bitwise identical operations with `int4`
+template <>
+struct __simd_type<unsigned, 4, false>: private __simd_type<int, 4, false> {
+    using __vml_base = __simd_type<int, 4, false>;
+    using type = __m128i;
+
+    static unsigned get(type const& array, size_t index) {
+#if defined(_MSC_VER)
+        return array.m128i_u32[index];
+#else
+        return ((__v4su)array)[index];
+#endif
+    }
+    static void splat(type& a, unsigned value) {
+        a = _mm_set1_epi32(int(value));
+    }
+    static void load(type& a, unsigned const* p) {
+        a = _mm_loadu_si128((type const*)p);
+    }
+    static void store(type const& a, unsigned* p) {
+        _mm_storeu_si128((type*)p, a);
+    }
+
+    using __vml_base::add;
+    using __vml_base::blend;
+    using __vml_base::cmp_eq;
+    using __vml_base::fma;
+    using __vml_base::movemask;
+    using __vml_base::mul;
+    using __vml_base::shuffle;
+    using __vml_base::shuffle2;
+    using __vml_base::sub;
+
+    static void div(type& a, type const& b) {
+        alignas(16) unsigned x[4], y[4];
+        _mm_store_si128((type*)x, a);
+        _mm_store_si128((type*)y, b);
+        for (size_t i = 0; i < 4; ++i) {
+            x[i] /= y[i];
+        }
+        a = _mm_load_si128((type const*)x);
+    }
+    static void min(type& a, type const& b) {
+#if defined(__SSE4_1__)
+        a = _mm_min_epu32(a, b);
+#else
+        type mask = b;
+        cmp_lt(mask, a);
+        blend(a, b, mask);
+#endif
+    }
+    static void max(type& a, type const& b) {
+#if defined(__SSE4_1__)
+        a = _mm_max_epu32(a, b);
+#else
+        type mask = a;
+        cmp_lt(mask, b);
+        blend(a, b, mask);
+#endif
+    }
+    /// Unsigned integers are their own absolute value
+    static void abs(type&) {}
+
+    /// Unsigned comparisons are signed comparisons with flipped sign bits
+    static void cmp_lt(type& a, type const& b) {
+        type const sign = _mm_set1_epi32(int(0x8000'0000));
+        a = _mm_cmplt_epi32(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign));
+    }
+    static void cmp_le(type& a, type const& b) {
+        type const sign = _mm_set1_epi32(int(0x8000'0000));
+        a = _mm_andnot_si128(
+            _mm_cmpgt_epi32(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign)),
+            _mm_set1_epi32(-1));
+    }
+
+    static unsigned hsum(type const& a) { return unsigned(__vml_base::hsum(a)); }
 };
 
 #if VML_AVX
+/// MARK: double4
 template <>
 struct __simd_type<double, 4, false> {
     using type = __m256d;
@@ -57,9 +451,127 @@ struct __simd_type<double, 4, false> {
         return array[index];
 #endif
     }
+    static void splat(type& a, double value) { a = _mm256_set1_pd(value); }
+    static void load(type& a, double const* p) { a = _mm256_loadu_pd(p); }
+    static void store(type const& a, double* p) { _mm256_storeu_pd(p, a); }
 
+    static void add(type& a, type const& b) { a = _mm256_add_pd(a, b); }
+    static void sub(type& a, type const& b) { a = _mm256_sub_pd(a, b); }
     static void mul(type& a, type const& b) { a = _mm256_mul_pd(a, b); }
     static void div(type& a, type const& b) { a = _mm256_div_pd(a, b); }
+    static void fma(type& a, type const& b, type const& c) {
+#if defined(__FMA__) && !VML_DETERMINISTIC
+        a = _mm256_fmadd_pd(a, b, c);
+#else
+        a = _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+    }
+    /// Operands are swapped to match the NaN behaviour of `vml::min/max`
+    static void min(type& a, type const& b) { a = _mm256_min_pd(b, a); }
+    static void max(type& a, type const& b) { a = _mm256_max_pd(b, a); }
+    static void abs(type& a) { a = _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static void sqrt(type& a) { a = _mm256_sqrt_pd(a); }
+
+    static void cmp_eq(type& a, type const& b) {
+        a = _mm256_cmp_pd(a, b, _CMP_EQ_OQ);
+    }
+    static void cmp_lt(type& a, type const& b) {
+        a = _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+    }
+    static void cmp_le(type& a, type const& b) {
+        a = _mm256_cmp_pd(a, b, _CMP_LE_OQ);
+    }
+    static unsigned movemask(type const& mask) {
+        return unsigned(_mm256_movemask_pd(mask));
+    }
+    static void blend(type& a, type const& b, type const& mask) {
+        a = _mm256_blendv_pd(a, b, mask);
+    }
+
+    static double hsum(type const& a) {
+        __m128d sums = _mm_add_pd(_mm256_castpd256_pd128(a),
+                                  _mm256_extractf128_pd(a, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(sums, _mm_unpackhi_pd(sums, sums)));
+    }
+    template <size_t I0, size_t I1, size_t I2, size_t I3>
+    static void shuffle(type& a) {
+#if defined(__AVX2__)
+        a = _mm256_permute4x64_pd(a, _MM_SHUFFLE(I3, I2, I1, I0));
+#else
+        a = _mm256_setr_pd(get(a, I0), get(a, I1), get(a, I2), get(a, I3));
+#endif
+    }
+    template <size_t I0, size_t I1, size_t I2, size_t I3>
+    static void shuffle2(type& a, type const& b) {
+#if defined(__AVX2__)
+        a = _mm256_blend_pd(_mm256_permute4x64_pd(a, _MM_SHUFFLE(0, 0, I1, I0)),
+                            _mm256_permute4x64_pd(b, _MM_SHUFFLE(I3, I2, 0, 0)),
+                            0b1100);
+#else
+        a = _mm256_setr_pd(get(a, I0), get(a, I1), get(b, I2), get(b, I3));
+#endif
+    }
+};
+
+/// MARK: float8
+template <>
+struct __simd_type<float, 8, false> {
+    using type = __m256;
+
+    static float get(type const& array, size_t index) {
+#if defined(_MSC_VER)
+        return array.m256_f32[index];
+#else
+        return array[index];
+#endif
+    }
+    static void splat(type& a, float value) { a = _mm256_set1_ps(value); }
+    static void load(type& a, float const* p) { a = _mm256_loadu_ps(p); }
+    static void store(type const& a, float* p) { _mm256_storeu_ps(p, a); }
+
+    static void add(type& a, type const& b) { a = _mm256_add_ps(a, b); }
+    static void sub(type& a, type const& b) { a = _mm256_sub_ps(a, b); }
+    static void mul(type& a, type const& b) { a = _mm256_mul_ps(a, b); }
+    static void div(type& a, type const& b) { a = _mm256_div_ps(a, b); }
+    static void fma(type& a, type const& b, type const& c) {
+#if defined(__FMA__) && !VML_DETERMINISTIC
+        a = _mm256_fmadd_ps(a, b, c);
+#else
+        a = _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+    }
+    /// Operands are swapped to match the NaN behaviour of `vml::min/max`
+    static void min(type& a, type const& b) { a = _mm256_min_ps(b, a); }
+    static void max(type& a, type const& b) { a = _mm256_max_ps(b, a); }
+    static void abs(type& a) { a = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static void sqrt(type& a) { a = _mm256_sqrt_ps(a); }
+
+    static void cmp_eq(type& a, type const& b) {
+        a = _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+    }
+    static void cmp_lt(type& a, type const& b) {
+        a = _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+    }
+    static void cmp_le(type& a, type const& b) {
+        a = _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+    }
+    static unsigned movemask(type const& mask) {
+        return unsigned(_mm256_movemask_ps(mask));
+    }
+    static void blend(type& a, type const& b, type const& mask) {
+        a = _mm256_blendv_ps(a, b, mask);
+    }
+
+    static float hsum(type const& a) {
+        __m128 const sums = _mm_add_ps(_mm256_castps256_ps128(a),
+                                       _mm256_extractf128_ps(a, 1));
+        return __simd_type<float, 4, false>::hsum(sums);
+    }
+    template <size_t... I>
+        requires(sizeof...(I) == 8)
+    static void shuffle(type& a) {
+        a = _mm256_setr_ps(get(a, I)...);
+    }
 };
 
 #endif
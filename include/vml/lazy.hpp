@@ -0,0 +1,373 @@
+#ifndef __VML_LAZY_HPP_INCLUDED__
+#define __VML_LAZY_HPP_INCLUDED__
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include "common.hpp"
+#include "fwd.hpp"
+#include "matrix.hpp"
+#include "vector.hpp"
+
+/// # Lazy Expressions
+///
+/// `lazy(x)` wraps a vector or matrix in an expression that records
+/// element-wise operations instead of evaluating them. The expression is
+/// evaluated in a single pass when it is converted to a vector or matrix, so
+///
+///     float4 r = lazy(a) * s + lazy(b) * t - c;
+///
+/// creates no temporaries. An operator without a lazy operand is evaluated
+/// eagerly as usual, `b * t` above would create a temporary. Products that
+/// are added or subtracted are contracted to `fma` if the target supports
+/// FMA, so results may differ from the eager operators in the last bit. With `VML_DETERMINISTIC` they are
+/// not contracted and match the eager operators.
+///
+/// Expressions store references to their operands. They must be evaluated
+/// before the end of the full-expression that creates them, i.e. they should
+/// not be stored in `auto` variables.
+///
+/// `*` and `/` of two matrices are not element-wise and are not supported.
+
+namespace _VVML {
+
+/// MARK: - Traits
+template <typename>
+struct __lazy_tensor_traits;
+
+template <typename T>
+struct __lazy_tensor_traits<T const>: __lazy_tensor_traits<T> {};
+
+template <typename T, size_t N, vector_options O>
+struct __lazy_tensor_traits<vector<T, N, O>> {
+    using value_type = T;
+    static constexpr size_t size = N;
+    static constexpr vector_options options = O;
+    template <typename U, vector_options P>
+    using rebind = vector<U, N, P>;
+};
+
+template <typename T, size_t R, size_t C, vector_options O>
+struct __lazy_tensor_traits<matrix<T, R, C, O>> {
+    using value_type = T;
+    static constexpr size_t size = R * C;
+    static constexpr vector_options options = O;
+    template <typename U, vector_options P>
+    using rebind = matrix<U, R, C, P>;
+};
+
+/// Whether tensors \p A and \p B have the same shape. `void` stands for a
+/// scalar and is compatible with every shape.
+template <typename A, typename B>
+inline constexpr bool __lazy_same_shape = [] {
+    if constexpr (std::is_void_v<A> || std::is_void_v<B>) {
+        return true;
+    }
+    else {
+        constexpr vector_options O{};
+        return std::is_same_v<
+            typename __lazy_tensor_traits<A>::template rebind<int, O>,
+            typename __lazy_tensor_traits<B>::template rebind<int, O>>;
+    }
+}();
+
+/// Tensor type of an element-wise operation on \p A and \p B with elements
+/// of type \p T
+template <typename T, typename A, typename B>
+struct __lazy_combine {
+    using type = typename __lazy_tensor_traits<A>::template rebind<
+        T, combine(__lazy_tensor_traits<A>::options,
+                   __lazy_tensor_traits<B>::options)>;
+};
+template <typename T, typename A>
+struct __lazy_combine<T, A, void> {
+    using type = typename __lazy_tensor_traits<A>::template rebind<
+        T, __lazy_tensor_traits<A>::options>;
+};
+template <typename T, typename B>
+struct __lazy_combine<T, void, B> {
+    using type = typename __lazy_tensor_traits<B>::template rebind<
+        T, __lazy_tensor_traits<B>::options>;
+};
+
+/// `a * b + c`, rounded once if the target has FMA instructions and
+/// `VML_DETERMINISTIC` is disabled
+template <typename T>
+__vml_always_inline __vml_interface_export constexpr T __vml_lazy_fma(T a, T b,
+                                                                      T c) {
+    __vml_no_contract;
+#if (defined(__FMA__) || defined(__ARM_FEATURE_FMA)) && !VML_DETERMINISTIC
+    if (!std::is_constant_evaluated()) {
+        return std::fma(a, b, c);
+    }
+#endif
+    return a * b + c;
+}
+
+/// MARK: - Nodes
+/// Every node has a `tensor_type`, which is `void` for scalars, and evaluates
+/// element `i` of the flattened result with `__vml_eval(i)`.
+
+template <typename Tensor>
+struct __lazy_leaf {
+    using tensor_type = Tensor;
+
+    __vml_always_inline __vml_interface_export constexpr auto __vml_eval(
+        size_t i) const {
+        return __ref.__vml_at(i);
+    }
+
+    Tensor const& __ref;
+};
+
+template <typename T>
+struct __lazy_scalar {
+    using tensor_type = void;
+
+    __vml_always_inline __vml_interface_export constexpr T __vml_eval(
+        size_t) const {
+        return __value;
+    }
+
+    T __value;
+};
+
+template <typename Op, typename A>
+struct __lazy_unary {
+    using tensor_type = typename A::tensor_type;
+
+    __vml_always_inline __vml_interface_export constexpr auto __vml_eval(
+        size_t i) const {
+        return Op{}(__a.__vml_eval(i));
+    }
+
+    A __a;
+};
+
+template <typename Op, typename A, typename B>
+struct __lazy_binary;
+
+template <typename>
+inline constexpr bool __lazy_is_product = false;
+template <typename A, typename B>
+inline constexpr bool
+    __lazy_is_product<__lazy_binary<__vml_multiplies_t, A, B>> = true;
+
+template <typename Op, typename A, typename B>
+struct __lazy_binary {
+    using value_type =
+        __vml_promote(decltype(std::declval<A const&>().__vml_eval(0)),
+                      decltype(std::declval<B const&>().__vml_eval(0)));
+    using tensor_type =
+        typename __lazy_combine<value_type, typename A::tensor_type,
+                                typename B::tensor_type>::type;
+
+    __vml_always_inline __vml_interface_export constexpr value_type
+        __vml_eval(size_t i) const {
+        constexpr bool is_add = std::is_same_v<Op, __vml_plus_t>;
+        constexpr bool is_sub = std::is_same_v<Op, __vml_minus_t>;
+        if constexpr (!std::is_floating_point_v<value_type> ||
+                      !(is_add || is_sub))
+        {
+            return value_type(Op{}(__a.__vml_eval(i), __b.__vml_eval(i)));
+        }
+        // `x * y ± c`
+        else if constexpr (__lazy_is_product<A>) {
+            value_type const c = __b.__vml_eval(i);
+            return _VVML::__vml_lazy_fma<value_type>(__a.__a.__vml_eval(i),
+                                                     __a.__b.__vml_eval(i),
+                                                     is_add ? c : -c);
+        }
+        // `c ± x * y`
+        else if constexpr (__lazy_is_product<B>) {
+            value_type const x = __b.__a.__vml_eval(i);
+            return _VVML::__vml_lazy_fma<value_type>(is_add ? x : -x,
+                                                     __b.__b.__vml_eval(i),
+                                                     __a.__vml_eval(i));
+        }
+        else {
+            return value_type(Op{}(__a.__vml_eval(i), __b.__vml_eval(i)));
+        }
+    }
+
+    A __a;
+    B __b;
+};
+
+/// MARK: - class lazy_expression
+template <typename Node>
+class lazy_expression {
+    using __traits = __lazy_tensor_traits<typename Node::tensor_type>;
+
+public:
+    /// The vector or matrix type the expression evaluates to
+    using tensor_type = typename Node::tensor_type;
+    using value_type = typename __traits::value_type;
+
+    __vml_always_inline __vml_interface_export explicit constexpr
+        lazy_expression(Node node):
+        __node(node) {}
+
+    /// Element \p i of the flattened result
+    __vml_always_inline __vml_interface_export constexpr value_type operator[](
+        size_t i) const {
+        __vml_bounds_check(i, 0, __traits::size);
+        return value_type(__node.__vml_eval(i));
+    }
+
+    /// Evaluates all elements in a single pass
+    __vml_always_inline __vml_interface_export constexpr tensor_type eval()
+        const {
+        return __vml_eval_into<tensor_type>();
+    }
+
+    /// Evaluates into vectors and matrices of the same shape
+    template <typename Tensor>
+        requires(is_vector<Tensor>::value || is_matrix<Tensor>::value) &&
+                __lazy_same_shape<Tensor, tensor_type>
+    __vml_always_inline __vml_interface_export constexpr operator Tensor()
+        const {
+        return __vml_eval_into<std::remove_cv_t<Tensor>>();
+    }
+
+    Node __node;
+
+private:
+    template <typename Tensor>
+    __vml_always_inline constexpr Tensor __vml_eval_into() const {
+        using T = typename __lazy_tensor_traits<Tensor>::value_type;
+        if (std::is_constant_evaluated()) {
+            return Tensor([this](size_t i) { return T(__node.__vml_eval(i)); });
+        }
+        Tensor result;
+        for (size_t i = 0; i < __lazy_tensor_traits<Tensor>::size; ++i) {
+            result.__vml_at(i) = T(__node.__vml_eval(i));
+        }
+        return result;
+    }
+};
+
+/// MARK: - lazy
+template <typename T, size_t N, vector_options O>
+__vml_always_inline __vml_interface_export constexpr lazy_expression<
+    __lazy_leaf<vector<T, N, O>>>
+    lazy(vector<T, N, O> const& v) {
+    return lazy_expression<__lazy_leaf<vector<T, N, O>>>({ v });
+}
+
+template <typename T, size_t R, size_t C, vector_options O>
+__vml_always_inline __vml_interface_export constexpr lazy_expression<
+    __lazy_leaf<matrix<T, R, C, O>>>
+    lazy(matrix<T, R, C, O> const& m) {
+    return lazy_expression<__lazy_leaf<matrix<T, R, C, O>>>({ m });
+}
+
+/// Expressions would outlive their operands
+template <typename T, size_t N, vector_options O>
+void lazy(vector<T, N, O>&&) = delete;
+template <typename T, size_t R, size_t C, vector_options O>
+void lazy(matrix<T, R, C, O>&&) = delete;
+
+/// MARK: - Operators
+template <typename T>
+inline constexpr bool __vml_is_lazy = false;
+template <typename Node>
+inline constexpr bool __vml_is_lazy<lazy_expression<Node>> = true;
+
+/// Converts an operand to the node that represents it
+template <typename T>
+__vml_always_inline __vml_interface_export constexpr auto __vml_lazy_node(
+    T const& x) {
+    if constexpr (__vml_is_lazy<T>) {
+        return x.__node;
+    }
+    else if constexpr (is_vector<T>::value || is_matrix<T>::value) {
+        return __lazy_leaf<T>{ x };
+    }
+    else {
+        return __lazy_scalar<T>{ x };
+    }
+}
+
+template <typename T>
+using __lazy_node_t = decltype(_VVML::__vml_lazy_node(std::declval<T>()));
+
+template <typename T>
+concept __lazy_operand = __vml_is_lazy<T> || is_vector<T>::value ||
+                         is_matrix<T>::value || scalar<T>;
+
+/// At least one of \p A and \p B is lazy and their shapes agree
+template <typename A, typename B>
+concept __lazy_operands =
+    (__vml_is_lazy<A> || __vml_is_lazy<B>) && __lazy_operand<A> &&
+    __lazy_operand<B> &&
+    __lazy_same_shape<typename __lazy_node_t<A>::tensor_type,
+                      typename __lazy_node_t<B>::tensor_type>;
+
+/// Whether \p A and \p B are both matrices, whose product is not element-wise
+template <typename A, typename B>
+concept __lazy_matrix_operands =
+    is_matrix<typename __lazy_node_t<A>::tensor_type>::value &&
+    is_matrix<typename __lazy_node_t<B>::tensor_type>::value;
+
+template <typename Op, typename A, typename B>
+__vml_always_inline __vml_interface_export constexpr auto __vml_lazy_binary(
+    A const& a, B const& b) {
+    using node = __lazy_binary<Op, __lazy_node_t<A>, __lazy_node_t<B>>;
+    return lazy_expression<node>(
+        node{ _VVML::__vml_lazy_node(a), _VVML::__vml_lazy_node(b) });
+}
+
+template <typename A, typename B>
+    requires __lazy_operands<A, B>
+__vml_mathfunction __vml_always_inline __vml_interface_export constexpr auto
+    operator+(A const& a, B const& b) {
+    return _VVML::__vml_lazy_binary<__vml_plus_t>(a, b);
+}
+
+template <typename A, typename B>
+    requires __lazy_operands<A, B>
+__vml_mathfunction __vml_always_inline __vml_interface_export constexpr auto
+    operator-(A const& a, B const& b) {
+    return _VVML::__vml_lazy_binary<__vml_minus_t>(a, b);
+}
+
+template <typename A, typename B>
+    requires __lazy_operands<A, B> && (!__lazy_matrix_operands<A, B>)
+__vml_mathfunction __vml_always_inline __vml_interface_export constexpr auto
+    operator*(A const& a, B const& b) {
+    return _VVML::__vml_lazy_binary<__vml_multiplies_t>(a, b);
+}
+
+template <typename A, typename B>
+    requires __lazy_operands<A, B> && (!__lazy_matrix_operands<A, B>)
+__vml_mathfunction __vml_always_inline __vml_interface_export constexpr auto
+    operator/(A const& a, B const& b) {
+    return _VVML::__vml_lazy_binary<__vml_divides_t>(a, b);
+}
+
+template <typename Node>
+__vml_mathfunction __vml_always_inline __vml_interface_export constexpr auto
+    operator-(lazy_expression<Node> const& a) {
+    using node = __lazy_unary<__vml_minus_t, Node>;
+    return lazy_expression<node>(node{ a.__node });
+}
+
+template <typename Node>
+__vml_mathfunction __vml_always_inline
+    __vml_interface_export constexpr lazy_expression<Node>
+    operator+(lazy_expression<Node> const& a) {
+    return a;
+}
+
+/// Evaluates \p e, for use where the target type is not spelled out
+template <typename Node>
+__vml_mathfunction __vml_always_inline __vml_interface_export constexpr auto
+    eval(lazy_expression<Node> const& e) {
+    return e.eval();
+}
+
+} // namespace _VVML
+
+#endif // __VML_LAZY_HPP_INCLUDED__
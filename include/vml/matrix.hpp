@@ -5,6 +5,7 @@
 #include <iomanip>
 #include <iosfwd>
 #include <sstream>
+#include <utility>
 
 #include "arithmetic.hpp"
 #include "common.hpp"
@@ -163,7 +164,13 @@ struct __matrix_data {
 
     __vml_always_inline constexpr T __vml_vec_at(size_t i) const {
         __vml_assert_audit(i < Rows * Columns);
-        return __vec[i / Columns][i % Columns];
+        if (std::is_constant_evaluated()) {
+            return __data[i];
+        }
+        else {
+            return __simd_type<T, Columns, Packed>::get(__vec[i / Columns],
+                                                        i % Columns);
+        }
     }
 
     __vml_always_inline constexpr T& __vml_at(size_t i, size_t j) & {
@@ -191,7 +198,12 @@ struct __matrix_data {
     __vml_always_inline constexpr T __vml_vec_at(size_t i, size_t j) const {
         __vml_assert_audit(i < Rows);
         __vml_assert_audit(j < Columns);
-        return __vec[i][j];
+        if (std::is_constant_evaluated()) {
+            return __data[i * Columns + j];
+        }
+        else {
+            return __simd_type<T, Columns, Packed>::get(__vec[i], j);
+        }
     }
 };
 
@@ -230,7 +242,12 @@ struct __matrix_data<T, Rows, 3, false> {
 
     __vml_always_inline constexpr T __vml_vec_at(size_t index) const {
         __vml_assert_audit(index < Rows * 3);
-        return __vec[index / 3][index % 3];
+        if (std::is_constant_evaluated()) {
+            return __data[__index(index / 3, index % 3)];
+        }
+        else {
+            return __simd_type<T, 4, false>::get(__vec[index / 3], index % 3);
+        }
     }
 
     __vml_always_inline constexpr T& __vml_at(size_t i, size_t j) & {
@@ -258,7 +275,12 @@ struct __matrix_data<T, Rows, 3, false> {
     __vml_always_inline constexpr T __vml_vec_at(size_t i, size_t j) const {
         __vml_assert_audit(i < Rows);
         __vml_assert_audit(j < 3);
-        return __vec[i][j];
+        if (std::is_constant_evaluated()) {
+            return __data[__index(i, j)];
+        }
+        else {
+            return __simd_type<T, 4, false>::get(__vec[i], j);
+        }
     }
 
     __matrix_data() = default;
@@ -958,15 +980,19 @@ constexpr matrix<bool, Rows, Columns, O> isnormal(
 /// Row Sum Norm
 template <typename T, size_t Rows, size_t Columns, vector_options O>
 constexpr auto row_sum_norm(matrix<T, Rows, Columns, O> const& m) {
-    return __vml_with_index_sequence((I, Columns),
-                                     { return max(sum_norm(m.row(I))...); });
+    return __vml_with_index_sequence((I, Columns), {
+        auto const result = max(sum_norm(m.row(I))...);
+        return result;
+    });
 }
 
 /// Column Sum Norm
 template <typename T, size_t Rows, size_t Columns, vector_options O>
 constexpr auto column_sum_norm(matrix<T, Rows, Columns, O> const& m) {
-    return __vml_with_index_sequence((I, Columns),
-                                     { return max(sum_norm(m.column(I))...); });
+    return __vml_with_index_sequence((I, Columns), {
+        auto const result = max(sum_norm(m.column(I))...);
+        return result;
+    });
 }
 
 /// Maximum Norm
@@ -974,10 +1000,158 @@ template <typename T, size_t Rows, size_t Columns, vector_options O>
 constexpr auto max_norm(matrix<T, Rows, Columns, O> const& m) {
     return __vml_with_index_sequence((I, Rows * Columns), {
         using std::abs;
-        return max(abs(m.__vml_at(I))...);
+        auto const result = max(abs(m.__vml_at(I))...);
+        return result;
     });
 }
 
+/// LU decomposition with partial pivoting, `P * A = L * U`
+template <typename T, size_t N, vector_options O = vector_options{}>
+struct lu_decomposition {
+    /// `L` below the diagonal with its unit diagonal implied, `U` on and above
+    /// the diagonal
+    matrix<T, N, N, O> lu;
+    /// Row `i` of `P * A` is row `permutation[i]` of `A`
+    std::array<size_t, N> permutation;
+    /// `det(P)`, either `1` or `-1`
+    T sign;
+    /// `A` is singular if a column has no nonzero pivot
+    bool singular;
+};
+
+template <real_scalar T, size_t N, vector_options O>
+__vml_mathfunction __vml_interface_export constexpr lu_decomposition<
+    __vml_floatify(T), N, O>
+    lu_decompose(matrix<T, N, N, O> const& A) {
+    using F = __vml_floatify(T);
+    auto const magnitude = [](F x) { return x < 0 ? -x : x; };
+    std::array<std::array<F, N>, N> a{};
+    std::array<size_t, N> permutation{};
+    for (size_t i = 0; i < N; ++i) {
+        permutation[i] = i;
+        for (size_t j = 0; j < N; ++j) {
+            a[i][j] = F(A.__vml_at(i, j));
+        }
+    }
+    F sign = 1;
+    bool singular = false;
+    for (size_t k = 0; k < N; ++k) {
+        size_t pivot = k;
+        for (size_t i = k + 1; i < N; ++i) {
+            if (magnitude(a[i][k]) > magnitude(a[pivot][k])) {
+                pivot = i;
+            }
+        }
+        if (a[pivot][k] == 0) {
+            singular = true;
+            continue;
+        }
+        if (pivot != k) {
+            std::swap(a[pivot], a[k]);
+            std::swap(permutation[pivot], permutation[k]);
+            sign = -sign;
+        }
+        for (size_t i = k + 1; i < N; ++i) {
+            F const l = a[i][k] /= a[k][k];
+            for (size_t j = k + 1; j < N; ++j) {
+                a[i][j] -= l * a[k][j];
+            }
+        }
+    }
+    return { matrix<F, N, N, O>([&](size_t i, size_t j) { return a[i][j]; }),
+             permutation, sign, singular };
+}
+
+/// Solves `L * U * x = b` in place, \p x holds `P * b` on entry
+template <typename T, size_t N, vector_options O>
+constexpr void __vml_lu_solve(lu_decomposition<T, N, O> const& d,
+                              std::array<T, N>& x) {
+    for (size_t i = 1; i < N; ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            x[i] -= d.lu.__vml_at(i, j) * x[j];
+        }
+    }
+    for (size_t i = N; i-- > 0;) {
+        for (size_t j = i + 1; j < N; ++j) {
+            x[i] -= d.lu.__vml_at(i, j) * x[j];
+        }
+        x[i] /= d.lu.__vml_at(i, i);
+    }
+}
+
+/// Determinant by fraction-free elimination (Bareiss), exact for integers
+template <typename T, size_t N, vector_options O>
+constexpr T __vml_bareiss_det(matrix<T, N, N, O> const& m) {
+    std::array<std::array<T, N>, N> a{};
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = 0; j < N; ++j) {
+            a[i][j] = m.__vml_at(i, j);
+        }
+    }
+    T sign = 1;
+    T previous = 1;
+    for (size_t k = 0; k + 1 < N; ++k) {
+        if (a[k][k] == 0) {
+            size_t pivot = k + 1;
+            while (pivot < N && a[pivot][k] == 0) {
+                ++pivot;
+            }
+            if (pivot == N) {
+                return T(0);
+            }
+            std::swap(a[pivot], a[k]);
+            sign = -sign;
+        }
+        for (size_t i = k + 1; i < N; ++i) {
+            for (size_t j = k + 1; j < N; ++j) {
+                // Exact division, the quotient is a minor of m
+                a[i][j] = (a[i][j] * a[k][k] - a[i][k] * a[k][j]) / previous;
+            }
+        }
+        previous = a[k][k];
+    }
+    return sign * a[N - 1][N - 1];
+}
+
+/// Determinant by Gaussian elimination with partial pivoting, for complex
+/// matrices
+template <typename T, size_t N, vector_options O>
+constexpr T __vml_complex_det(matrix<T, N, N, O> const& m) {
+    auto const magnitude = [](T const& x) {
+        return real(x) * real(x) + imag(x) * imag(x);
+    };
+    std::array<std::array<T, N>, N> a{};
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = 0; j < N; ++j) {
+            a[i][j] = m.__vml_at(i, j);
+        }
+    }
+    T result = 1;
+    for (size_t k = 0; k < N; ++k) {
+        size_t pivot = k;
+        for (size_t i = k + 1; i < N; ++i) {
+            if (magnitude(a[i][k]) > magnitude(a[pivot][k])) {
+                pivot = i;
+            }
+        }
+        if (a[pivot][k] == T(0)) {
+            return T(0);
+        }
+        if (pivot != k) {
+            std::swap(a[pivot], a[k]);
+            result = -result;
+        }
+        result *= a[k][k];
+        for (size_t i = k + 1; i < N; ++i) {
+            T const l = a[i][k] / a[k][k];
+            for (size_t j = k + 1; j < N; ++j) {
+                a[i][j] -= l * a[k][j];
+            }
+        }
+    }
+    return result;
+}
+
 /// Determinant
 template <scalar T, vector_options O>
 __vml_mathfunction __vml_always_inline __vml_interface_export constexpr T det(
@@ -997,14 +1171,38 @@ __vml_mathfunction __vml_interface_export constexpr T det(
 template <scalar T, size_t N, vector_options O>
 __vml_mathfunction __vml_interface_export constexpr T det(
     matrix<T, N, N, O> const& m) {
-    auto constexpr sign = [](size_t i, size_t j) {
-        return (int)((i + j + 1) % 2) * 2 - 1;
-    };
-    return __vml_with_index_sequence((I, N), {
-        return (
-            (m.__vml_at(I, 0) * sign(I, 0) * _VVML::det(submatrix(m, I, 0))) +
-            ...);
-    });
+    // The cofactor expansion is O(N!), larger matrices are eliminated
+    if constexpr (N > 4 && std::is_floating_point_v<T>) {
+        auto const d = lu_decompose(m);
+        T result = d.sign;
+        for (size_t i = 0; i < N; ++i) {
+            result *= d.lu.__vml_at(i, i);
+        }
+        return result;
+    }
+    else if constexpr (N > 4 && std::is_integral_v<T> &&
+                       !std::same_as<T, bool>)
+    {
+        // Unsigned determinants wrap around like the cofactor expansion does
+        using S = std::make_signed_t<T>;
+        return T(__vml_bareiss_det(matrix<S, N, N, O>(m)));
+    }
+    else if constexpr (N > 4 && is_complex<T>::value) {
+        return __vml_complex_det(m);
+    }
+    else {
+        static_assert(N <= 4, "The cofactor expansion of larger matrices is "
+                              "O(N!), det supports them for real, integer "
+                              "and complex scalars only");
+        auto constexpr sign = [](size_t i, size_t j) {
+            return (int)((i + j + 1) % 2) * 2 - 1;
+        };
+        return __vml_with_index_sequence((I, N), {
+            return ((m.__vml_at(I, 0) * sign(I, 0) *
+                     _VVML::det(submatrix(m, I, 0))) +
+                    ...);
+        });
+    }
 }
 
 /// Trace
@@ -1083,8 +1281,114 @@ __vml_mathfunction __vml_interface_export constexpr matrix3x3<__vml_floatify(T),
     integral_inverse(matrix3x3<T, O> const& m) {
     return __vml_inverse(m);
 }
+/// Block-wise 4x4 inverse on the SIMD rows. The matrix is split into the 2x2
+/// blocks `A B / C D`, each stored in one register as `(x00, x01, x10, x11)`,
+/// and the inverse is assembled from their adjugates.
+template <typename T>
+struct __vml_simd_inverse4x4 {
+    using simd_type = __simd_type<T, 4, false>;
+    using V = typename simd_type::type;
+
+    __vml_always_inline static V add(V a, V const& b) {
+        simd_type::add(a, b);
+        return a;
+    }
+    __vml_always_inline static V sub(V a, V const& b) {
+        simd_type::sub(a, b);
+        return a;
+    }
+    __vml_always_inline static V mul(V a, V const& b) {
+        simd_type::mul(a, b);
+        return a;
+    }
+    __vml_always_inline static V mul(V a, T b) {
+        V s;
+        simd_type::splat(s, b);
+        simd_type::mul(a, s);
+        return a;
+    }
+    template <size_t I0, size_t I1, size_t I2, size_t I3>
+    __vml_always_inline static V swizzle(V a) {
+        simd_type::template shuffle<I0, I1, I2, I3>(a);
+        return a;
+    }
+    template <size_t I0, size_t I1, size_t I2, size_t I3>
+    __vml_always_inline static V shuffle(V a, V const& b) {
+        simd_type::template shuffle2<I0, I1, I2, I3>(a, b);
+        return a;
+    }
+
+    /// `A * B`
+    __vml_always_inline static V mat2_mul(V const& a, V const& b) {
+        return add(mul(a, swizzle<0, 3, 0, 3>(b)),
+                   mul(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+    }
+    /// `adj(A) * B`
+    __vml_always_inline static V mat2_adj_mul(V const& a, V const& b) {
+        return sub(mul(swizzle<3, 3, 0, 0>(a), b),
+                   mul(swizzle<1, 1, 2, 2>(a), swizzle<2, 3, 0, 1>(b)));
+    }
+    /// `A * adj(B)`
+    __vml_always_inline static V mat2_mul_adj(V const& a, V const& b) {
+        return sub(mul(a, swizzle<3, 0, 3, 0>(b)),
+                   mul(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+    }
+
+    template <vector_options O>
+    static matrix4x4<T, O> invert(matrix4x4<T, O> const& m) {
+        V const A = shuffle<0, 1, 0, 1>(m.__vec[0], m.__vec[1]);
+        V const B = shuffle<2, 3, 2, 3>(m.__vec[0], m.__vec[1]);
+        V const C = shuffle<0, 1, 0, 1>(m.__vec[2], m.__vec[3]);
+        V const D = shuffle<2, 3, 2, 3>(m.__vec[2], m.__vec[3]);
+        // (|A|, |B|, |C|, |D|)
+        V const det_sub =
+            sub(mul(shuffle<0, 2, 0, 2>(m.__vec[0], m.__vec[2]),
+                    shuffle<1, 3, 1, 3>(m.__vec[1], m.__vec[3])),
+                mul(shuffle<1, 3, 1, 3>(m.__vec[0], m.__vec[2]),
+                    shuffle<0, 2, 0, 2>(m.__vec[1], m.__vec[3])));
+        T const det_a = simd_type::get(det_sub, 0);
+        T const det_b = simd_type::get(det_sub, 1);
+        T const det_c = simd_type::get(det_sub, 2);
+        T const det_d = simd_type::get(det_sub, 3);
+
+        V const D_C = mat2_adj_mul(D, C);
+        V const A_B = mat2_adj_mul(A, B);
+        // The adjugates of the blocks of the inverse `X Y / Z W`
+        V const X = sub(mul(A, det_d), mat2_mul(B, D_C));
+        V const W = sub(mul(D, det_a), mat2_mul(C, A_B));
+        V const Y = sub(mul(C, det_b), mat2_mul_adj(D, A_B));
+        V const Z = sub(mul(B, det_c), mat2_mul_adj(A, D_C));
+
+        // |M| = |A| |D| + |B| |C| - tr(adj(A) B adj(D) C)
+        T const d = det_a * det_d + det_b * det_c -
+                    simd_type::hsum(mul(A_B, swizzle<0, 2, 1, 3>(D_C)));
+        __vml_expect(__vml_is_unit(d));
+        V r, minus_r;
+        simd_type::splat(r, T(1) / d);
+        simd_type::splat(minus_r, T(-1) / d);
+        // (1, -1, -1, 1) / |M| undoes the adjugates of the blocks
+        V const sign_r = swizzle<0, 2, 3, 1>(shuffle<0, 0, 0, 0>(r, minus_r));
+        V const X_ = mul(X, sign_r);
+        V const Y_ = mul(Y, sign_r);
+        V const Z_ = mul(Z, sign_r);
+        V const W_ = mul(W, sign_r);
+        // Transpose the blocks back into rows
+        matrix4x4<T, O> result;
+        result.__vec[0] = shuffle<3, 1, 3, 1>(X_, Y_);
+        result.__vec[1] = shuffle<2, 0, 2, 0>(X_, Y_);
+        result.__vec[2] = shuffle<3, 1, 3, 1>(Z_, W_);
+        result.__vec[3] = shuffle<2, 0, 2, 0>(Z_, W_);
+        return result;
+    }
+};
+
 template <scalar T, vector_options O>
 constexpr matrix4x4<T, O> __vml_inverse(matrix4x4<T, O> const& m) {
+    if constexpr (__vml_has_simd_rows<T, O>) {
+        if (!std::is_constant_evaluated()) {
+            return __vml_simd_inverse4x4<T>::invert(m);
+        }
+    }
     matrix4x4<T, O> const int_result = {
         m.__vml_at(5) * m.__vml_at(10) * m.__vml_at(15) -
             m.__vml_at(5) * m.__vml_at(11) * m.__vml_at(14) -
@@ -1227,6 +1531,97 @@ __vml_mathfunction __vml_interface_export constexpr matrix4x4<__vml_floatify(T),
     return __vml_inverse(m);
 }
 
+/// Inverse of an affine transform, i.e. of a matrix whose last row is
+/// `(0, 0, 0, 1)`. The rows of the inverse linear part are the cross products
+/// of the columns of \p m, the translation is mapped through them.
+template <scalar T, vector_options O>
+__vml_mathfunction __vml_interface_export constexpr matrix4x4<__vml_floatify(T),
+                                                              O>
+    affine_inverse(matrix4x4<T, O> const& m) {
+    using F = __vml_floatify(T);
+    __vml_expect(m.__vml_at(3, 0) == 0 && m.__vml_at(3, 1) == 0 &&
+                 m.__vml_at(3, 2) == 0 && m.__vml_at(3, 3) == 1);
+    auto const column = [&](size_t j) {
+        return vector3<F, O>(m.__vml_at(0, j), m.__vml_at(1, j),
+                             m.__vml_at(2, j));
+    };
+    vector3<F, O> const c0 = column(0), c1 = column(1), c2 = column(2);
+    vector3<F, O> const t = column(3);
+    vector3<F, O> r0 = cross(c1, c2);
+    F const d = dot(c0, r0);
+    __vml_expect(__vml_is_unit(d));
+    F const r = F(1) / d;
+    r0 *= r;
+    vector3<F, O> const r1 = cross(c2, c0) * r;
+    vector3<F, O> const r2 = cross(c0, c1) * r;
+    return { r0.__vml_at(0), r0.__vml_at(1), r0.__vml_at(2), -dot(r0, t),
+             r1.__vml_at(0), r1.__vml_at(1), r1.__vml_at(2), -dot(r1, t),
+             r2.__vml_at(0), r2.__vml_at(1), r2.__vml_at(2), -dot(r2, t),
+             F(0),           F(0),           F(0),           F(1) };
+}
+
+/// Inverse of a rigid transform, i.e. a rotation followed by a translation.
+/// The linear part of \p m must be orthonormal, it is inverted by transposing.
+template <std::floating_point T, vector_options O>
+__vml_mathfunction __vml_interface_export constexpr matrix4x4<T, O>
+    rigid_inverse(matrix4x4<T, O> const& m) {
+    __vml_expect(m.__vml_at(3, 0) == 0 && m.__vml_at(3, 1) == 0 &&
+                 m.__vml_at(3, 2) == 0 && m.__vml_at(3, 3) == 1);
+    auto const t = [&](size_t j) {
+        return -(m.__vml_at(0, j) * m.__vml_at(0, 3) +
+                 m.__vml_at(1, j) * m.__vml_at(1, 3) +
+                 m.__vml_at(2, j) * m.__vml_at(2, 3));
+    };
+    return { m.__vml_at(0, 0), m.__vml_at(1, 0), m.__vml_at(2, 0), t(0),
+             m.__vml_at(0, 1), m.__vml_at(1, 1), m.__vml_at(2, 1), t(1),
+             m.__vml_at(0, 2), m.__vml_at(1, 2), m.__vml_at(2, 2), t(2),
+             T(0),             T(0),             T(0),             T(1) };
+}
+
+/// Inverse of matrices larger than 4x4 via LU decomposition
+template <real_scalar T, size_t N, vector_options O>
+    requires(N > 4)
+__vml_mathfunction __vml_interface_export constexpr matrix<__vml_floatify(T), N,
+                                                           N, O>
+    inverse(matrix<T, N, N, O> const& m) {
+    using F = __vml_floatify(T);
+    auto const d = lu_decompose(m);
+    __vml_expect(!d.singular);
+    std::array<std::array<F, N>, N> columns{};
+    for (size_t j = 0; j < N; ++j) {
+        for (size_t i = 0; i < N; ++i) {
+            columns[j][i] = F(d.permutation[i] == j);
+        }
+        __vml_lu_solve(d, columns[j]);
+    }
+    return matrix<F, N, N, O>(
+        [&](size_t i, size_t j) { return columns[j][i]; });
+}
+
+/// Solves `A * x = b` for a decomposition \p d of `A`
+template <typename T, size_t N, vector_options O, real_scalar U,
+          vector_options P>
+__vml_mathfunction __vml_interface_export constexpr vector<T, N, combine(O, P)>
+    solve(lu_decomposition<T, N, O> const& d, vector<U, N, P> const& b) {
+    __vml_expect(!d.singular);
+    std::array<T, N> x{};
+    for (size_t i = 0; i < N; ++i) {
+        x[i] = T(b.__vml_at(d.permutation[i]));
+    }
+    __vml_lu_solve(d, x);
+    return vector<T, N, combine(O, P)>([&](size_t i) { return x[i]; });
+}
+
+/// Solves `A * x = b`
+template <real_scalar T, real_scalar U, size_t N, vector_options O,
+          vector_options P>
+__vml_mathfunction __vml_interface_export constexpr vector<
+    __vml_floatify(__vml_promote(T, U)), N, combine(O, P)>
+    solve(matrix<T, N, N, O> const& A, vector<U, N, P> const& b) {
+    using F = __vml_floatify(__vml_promote(T, U));
+    return solve(lu_decompose(type_cast<F>(A)), b);
+}
+
 template <scalar T, scalar U, vector_options O, vector_options P, size_t N>
 __vml_mathfunction __vml_interface_export constexpr matrix<__vml_promote(T, U),
                                                            N, N, combine(O, P)>
@@ -0,0 +1,380 @@
+#ifndef __VML_PAR_HPP_INCLUDED__
+#define __VML_PAR_HPP_INCLUDED__
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "fwd.hpp"
+
+/// # Parallel Algorithms
+///
+/// Bulk operations over contiguous ranges of vectors, matrices, quaternions
+/// or any other type, run on a `thread_pool`.
+///
+/// The pool splits the indices of a loop into chunks and hands every thread
+/// a contiguous range of chunks. A thread takes chunks from the front of its
+/// own range and, once that is empty, steals the back half of the range of
+/// another thread. Each range is a single atomic word, so taking and
+/// stealing are one compare-and-swap each. The calling thread takes part in
+/// the loop.
+///
+/// Chunks are about 64 KiB of elements, a multiple of the 16 lanes of the
+/// widest SIMD registers, independent of the number of threads. `reduce()`
+/// combines the results of the chunks in order, so its result does not
+/// depend on the pool.
+
+namespace _VVML::par {
+
+/// Elements per chunk for elements of type `T`
+template <typename T>
+inline constexpr size_t default_grain =
+    std::max<size_t>(16, 65536 / sizeof(T) / 16 * 16);
+
+/// Set on threads while they run chunks
+inline thread_local bool __vml_par_inside_chunk = false;
+
+/// MARK: - class thread_pool
+class thread_pool {
+public:
+    /// Runs loops on \p threads threads including the calling one, `0`
+    /// uses all hardware threads
+    explicit thread_pool(size_t threads = 0) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        _queues = std::make_unique<_queue[]>(threads);
+        for (size_t i = 1; i < threads; ++i) {
+            _workers.emplace_back([this, i] { _work(i); });
+        }
+    }
+
+    thread_pool(thread_pool const&) = delete;
+    thread_pool& operator=(thread_pool const&) = delete;
+
+    ~thread_pool() {
+        {
+            std::lock_guard lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto& w: _workers) {
+            w.join();
+        }
+    }
+
+    /// Number of threads running loops, including the calling one
+    size_t size() const { return _workers.size() + 1; }
+
+    /// Calls `f(begin, end)` for chunks of at most \p grain indices covering
+    /// `[0, n)` and returns when all have finished. If `f` throws, the
+    /// remaining chunks are skipped and the first exception is rethrown.
+    /// Loops started from inside a chunk run on the calling thread.
+    template <std::invocable<size_t, size_t> F>
+    void for_each_chunk(size_t n, size_t grain, F&& f) {
+        __vml_expect(grain > 0);
+        size_t const chunks = (n + grain - 1) / grain;
+        // Chunk indices must fit into half a word
+        __vml_expect(chunks < 0xffff'ffff);
+        if (chunks <= 1 || size() == 1 || __vml_par_inside_chunk) {
+            for (size_t begin = 0; begin < n; begin += grain) {
+                std::invoke(f, begin, std::min(begin + grain, n));
+            }
+            return;
+        }
+        std::lock_guard call_lock(_call_mutex);
+        _job = { [](void* context, size_t begin, size_t end) {
+            std::invoke(*static_cast<std::remove_reference_t<F>*>(context),
+                        begin, end);
+        }, const_cast<void*>(static_cast<void const*>(std::addressof(f))), n,
+                 grain };
+        _pending = chunks;
+        _failed = false;
+        _exception = nullptr;
+        for (size_t i = 0; i < size(); ++i) {
+            _queues[i].range = _pack(chunks * i / size(),
+                                     chunks * (i + 1) / size());
+        }
+        {
+            std::lock_guard lock(_mutex);
+            _active = true;
+            ++_generation;
+        }
+        _wake.notify_all();
+        _participate(0);
+        {
+            // Workers may still be looking for chunks, `f` must outlive them
+            std::unique_lock lock(_mutex);
+            _done.wait(lock, [&] { return _pending == 0; });
+            _active = false;
+            _done.wait(lock, [&] { return _busy == 0; });
+        }
+        if (_exception) {
+            std::rethrow_exception(_exception);
+        }
+    }
+
+private:
+    /// Chunks `[begin, end)` in the low and high half of one word
+    struct alignas(64) _queue {
+        std::atomic<std::uint64_t> range = 0;
+    };
+
+    struct _job_type {
+        void (*run)(void*, size_t, size_t);
+        void* context;
+        size_t n;
+        size_t grain;
+    };
+
+    static std::uint64_t _pack(size_t begin, size_t end) {
+        return std::uint64_t(begin) | std::uint64_t(end) << 32;
+    }
+
+    /// Takes the first chunk of queue \p i
+    std::optional<size_t> _pop(size_t i) {
+        std::uint64_t r = _queues[i].range;
+        while (true) {
+            size_t const begin = r & 0xffff'ffff, end = r >> 32;
+            if (begin >= end) {
+                return std::nullopt;
+            }
+            if (_queues[i].range.compare_exchange_weak(r,
+                                                       _pack(begin + 1, end)))
+            {
+                return begin;
+            }
+        }
+    }
+
+    /// Moves the back half of the chunks of another queue to queue \p i,
+    /// which must be empty, and takes the first of them
+    std::optional<size_t> _steal(size_t i) {
+        for (size_t k = 1; k < size(); ++k) {
+            size_t const victim = (i + k) % size();
+            std::uint64_t r = _queues[victim].range;
+            while (true) {
+                size_t const begin = r & 0xffff'ffff, end = r >> 32;
+                if (begin >= end) {
+                    break;
+                }
+                size_t const middle = begin + (end - begin) / 2;
+                if (_queues[victim].range.compare_exchange_weak(
+                        r, _pack(begin, middle)))
+                {
+                    _queues[i].range = _pack(middle + 1, end);
+                    return middle;
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    void _participate(size_t i) {
+        __vml_par_inside_chunk = true;
+        while (true) {
+            std::optional<size_t> chunk = _pop(i);
+            if (!chunk) {
+                chunk = _steal(i);
+            }
+            if (!chunk) {
+                break;
+            }
+            if (!_failed) {
+                size_t const begin = *chunk * _job.grain;
+                try {
+                    _job.run(_job.context, begin,
+                             std::min(begin + _job.grain, _job.n));
+                }
+                catch (...) {
+                    std::lock_guard lock(_mutex);
+                    if (!_failed.exchange(true)) {
+                        _exception = std::current_exception();
+                    }
+                }
+            }
+            if (_pending.fetch_sub(1) == 1) {
+                std::lock_guard lock(_mutex);
+                _done.notify_all();
+            }
+        }
+        __vml_par_inside_chunk = false;
+    }
+
+    void _work(size_t i) {
+        std::uint64_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock lock(_mutex);
+                _wake.wait(lock, [&] { return _stop || _generation != seen; });
+                if (_stop) {
+                    return;
+                }
+                seen = _generation;
+                if (!_active) {
+                    continue;
+                }
+                ++_busy;
+            }
+            _participate(i);
+            std::lock_guard lock(_mutex);
+            if (--_busy == 0) {
+                _done.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::thread> _workers;
+    std::unique_ptr<_queue[]> _queues;
+    /// Serializes loops started by different threads
+    std::mutex _call_mutex;
+    _job_type _job{};
+    std::atomic<size_t> _pending = 0;
+    std::atomic<bool> _failed = false;
+    std::exception_ptr _exception;
+    /// Guards the members below
+    std::mutex _mutex;
+    std::condition_variable _wake, _done;
+    std::uint64_t _generation = 0;
+    size_t _busy = 0;
+    bool _active = false;
+    bool _stop = false;
+};
+
+/// The pool used by the algorithms below unless one is passed, it has one
+/// thread per hardware thread
+inline thread_pool& default_pool() {
+    static thread_pool pool;
+    return pool;
+}
+
+/// MARK: - Algorithms
+
+template <typename R>
+concept __vml_par_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R>;
+
+/// Calls \p f with every index in `[0, n)` in chunks of \p grain
+template <std::invocable<size_t> F>
+void for_each_index(thread_pool& pool, size_t n, F f, size_t grain = 4096) {
+    pool.for_each_chunk(n, grain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            std::invoke(f, i);
+        }
+    });
+}
+
+template <std::invocable<size_t> F>
+void for_each_index(size_t n, F f, size_t grain = 4096) {
+    par::for_each_index(default_pool(), n, std::move(f), grain);
+}
+
+/// `out[i] = f(in[i])`. \p in and \p out may be the same range.
+template <__vml_par_range In, __vml_par_range Out, typename F>
+    requires std::invocable<F&, std::ranges::range_reference_t<In const>>
+void transform(thread_pool& pool, In const& in, Out&& out, F f) {
+    using T = std::ranges::range_value_t<In>;
+    __vml_expect(std::ranges::size(in) == std::ranges::size(out));
+    auto const* const src = std::ranges::data(in);
+    auto* const dst = std::ranges::data(out);
+    pool.for_each_chunk(std::ranges::size(in), default_grain<T>,
+                        [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            dst[i] = std::invoke(f, src[i]);
+        }
+    });
+}
+
+template <__vml_par_range In, __vml_par_range Out, typename F>
+    requires std::invocable<F&, std::ranges::range_reference_t<In const>>
+void transform(In const& in, Out&& out, F f) {
+    par::transform(default_pool(), in, out, std::move(f));
+}
+
+/// `out[i] = f(a[i], b[i])`
+template <__vml_par_range A, __vml_par_range B, __vml_par_range Out,
+          typename F>
+    requires std::invocable<F&, std::ranges::range_reference_t<A const>,
+                            std::ranges::range_reference_t<B const>>
+void transform(thread_pool& pool, A const& a, B const& b, Out&& out, F f) {
+    using T = std::ranges::range_value_t<A>;
+    __vml_expect(std::ranges::size(a) == std::ranges::size(out));
+    __vml_expect(std::ranges::size(b) == std::ranges::size(out));
+    auto const* const x = std::ranges::data(a);
+    auto const* const y = std::ranges::data(b);
+    auto* const dst = std::ranges::data(out);
+    pool.for_each_chunk(std::ranges::size(a), default_grain<T>,
+                        [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            dst[i] = std::invoke(f, x[i], y[i]);
+        }
+    });
+}
+
+template <__vml_par_range A, __vml_par_range B, __vml_par_range Out,
+          typename F>
+    requires std::invocable<F&, std::ranges::range_reference_t<A const>,
+                            std::ranges::range_reference_t<B const>>
+void transform(A const& a, B const& b, Out&& out, F f) {
+    par::transform(default_pool(), a, b, out, std::move(f));
+}
+
+/// Folds `f(in[i])` with the associative \p op, starting with \p init. Each
+/// chunk is folded left to right, then the chunk results are folded in
+/// order.
+template <__vml_par_range In, typename T, typename Op, typename F>
+    requires std::invocable<F&, std::ranges::range_reference_t<In const>>
+T transform_reduce(thread_pool& pool, In const& in, T init, Op op, F f) {
+    using V = std::ranges::range_value_t<In>;
+    size_t const n = std::ranges::size(in);
+    size_t const grain = default_grain<V>;
+    auto const* const src = std::ranges::data(in);
+    std::vector<std::optional<T>> partial((n + grain - 1) / grain);
+    pool.for_each_chunk(n, grain, [&](size_t begin, size_t end) {
+        T result = std::invoke(f, src[begin]);
+        for (size_t i = begin + 1; i < end; ++i) {
+            result = std::invoke(op, std::move(result),
+                                 std::invoke(f, src[i]));
+        }
+        partial[begin / grain] = std::move(result);
+    });
+    for (auto& p: partial) {
+        init = std::invoke(op, std::move(init), std::move(*p));
+    }
+    return init;
+}
+
+template <__vml_par_range In, typename T, typename Op, typename F>
+    requires std::invocable<F&, std::ranges::range_reference_t<In const>>
+T transform_reduce(In const& in, T init, Op op, F f) {
+    return par::transform_reduce(default_pool(), in, std::move(init),
+                                 std::move(op), std::move(f));
+}
+
+/// Folds the elements of \p in with the associative \p op, starting with
+/// \p init
+template <__vml_par_range In, typename T, typename Op = std::plus<>>
+T reduce(thread_pool& pool, In const& in, T init, Op op = {}) {
+    return par::transform_reduce(pool, in, std::move(init), std::move(op),
+                                 std::identity{});
+}
+
+template <__vml_par_range In, typename T, typename Op = std::plus<>>
+T reduce(In const& in, T init, Op op = {}) {
+    return par::reduce(default_pool(), in, std::move(init), std::move(op));
+}
+
+} // namespace _VVML::par
+
+#endif // __VML_PAR_HPP_INCLUDED__
@@ -320,6 +320,7 @@ template <real_scalar T, real_scalar U>
 __vml_mathfunction __vml_always_inline
     __vml_interface_export constexpr quaternion<__vml_promote(T, U)>
     operator*(quaternion<T> const& a, quaternion<U> const& b) {
+    __vml_no_contract;
     return quaternion<__vml_promote(T, U)>(
         a.__vml_at(0) * b.__vml_at(0) - a.__vml_at(1) * b.__vml_at(1) -
             a.__vml_at(2) * b.__vml_at(2) - a.__vml_at(3) * b.__vml_at(3), // 1
@@ -336,6 +337,7 @@ template <real_scalar T, real_scalar U>
 __vml_mathfunction __vml_always_inline
     __vml_interface_export constexpr quaternion<__vml_promote(T, U)>
     operator*(quaternion<T> const& a, complex<U> const& b) {
+    __vml_no_contract;
     return quaternion<__vml_promote(T, U)>(
         a.__vml_at(0) * b.__vml_at(0) - a.__vml_at(1) * b.__vml_at(1), // 1
         a.__vml_at(0) * b.__vml_at(1) + a.__vml_at(1) * b.__vml_at(0), // i
@@ -348,6 +350,7 @@ template <real_scalar T, real_scalar U>
 __vml_mathfunction __vml_always_inline
     __vml_interface_export constexpr quaternion<__vml_promote(T, U)>
     operator*(complex<T> const& a, quaternion<U> const& b) {
+    __vml_no_contract;
     return quaternion<__vml_promote(T, U)>(
         a.__vml_at(0) * b.__vml_at(0) - a.__vml_at(1) * b.__vml_at(1), // 1
         a.__vml_at(0) * b.__vml_at(1) + a.__vml_at(1) * b.__vml_at(0), // i
@@ -2,7 +2,11 @@
 #define __VML_SHAPES_HPP_INCLUDED__
 
 #include <algorithm>
+#include <cmath>
 #include <iosfwd>
+#include <limits>
+#include <optional>
+#include <span>
 
 #include "fwd.hpp"
 #include "vector.hpp"
@@ -203,6 +207,105 @@ using line_segment_2D = line_segment<T, 2, O>;
 template <typename T = double, vector_options O = vector_options{}>
 using line_segment_3D = line_segment<T, 3, O>;
 
+/// MARK: - Ray
+/// The half line `origin + t * direction`, `t >= 0`. The reciprocal of the
+/// direction is computed once on construction for the slab tests.
+template <typename T = double, size_t Dim = 3,
+          vector_options O = vector_options{}>
+class ray {
+    static_assert(std::is_floating_point<T>::value,
+                  "T needs to be floating point");
+
+public:
+    constexpr ray(vector<T, Dim, O> const& origin,
+                  vector<T, Dim, O> const& direction):
+        _origin(origin),
+        _direction(direction),
+        _inverse_direction(T(1) / direction) {}
+
+    constexpr vector<T, Dim, O> origin() const { return _origin; }
+    constexpr vector<T, Dim, O> direction() const { return _direction; }
+    constexpr vector<T, Dim, O> inverse_direction() const {
+        return _inverse_direction;
+    }
+
+    /// The point at parameter \p t
+    constexpr vector<T, Dim, O> at(T t) const {
+        return _origin + t * _direction;
+    }
+
+private:
+    vector<T, Dim, O> _origin;
+    vector<T, Dim, O> _direction;
+    vector<T, Dim, O> _inverse_direction;
+};
+
+/// The parameters where a ray enters and leaves a shape. The interval is
+/// empty if the ray misses the shape. For `T = simd_lane<...>` every lane
+/// holds the interval of a different shape.
+template <typename T>
+struct ray_interval {
+    T t_min;
+    T t_max;
+
+    /// `bool` for scalars, `simd_mask` for lanes
+    auto hit() const { return t_min <= t_max; }
+};
+
+/// Intersection of a ray with a triangle
+template <typename T>
+struct ray_triangle_hit {
+    /// Ray parameter of the intersection point
+    T t;
+    /// Weights of the second and third vertex, the point is
+    /// `(1 - u - v) * p0 + u * p1 + v * p2`
+    T u, v;
+};
+
+/// MARK: - AABB Packet
+/// Up to `W` boxes in structure-of-arrays layout, so one ray is tested
+/// against all of them at once by `intersect()`. Use `W = 4` for SSE and
+/// `W = 8` for AVX.
+template <typename T, size_t W, size_t Dim = 3>
+class aabb_packet {
+public:
+    using lane_type = simd_lane<T, W>;
+
+    aabb_packet() = default;
+
+    /// Packs the first `min(W, boxes.size())` boxes of \p boxes, unused
+    /// lanes are never hit
+    explicit aabb_packet(std::span<AABB<T, Dim> const> boxes) {
+        size_t const count = std::min(W, boxes.size());
+        T lower[Dim][W]{}, upper[Dim][W]{}, index[W];
+        for (size_t i = 0; i < W; ++i) {
+            index[i] = T(i);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t k = 0; k < Dim; ++k) {
+                lower[k][i] = boxes[i].lower_bound()[k];
+                upper[k][i] = boxes[i].upper_bound()[k];
+            }
+        }
+        for (size_t k = 0; k < Dim; ++k) {
+            _lower.__vml_at(k) = lane_type::load(lower[k]);
+            _upper.__vml_at(k) = lane_type::load(upper[k]);
+        }
+        _valid = lane_type::load(index) < lane_type(T(count));
+    }
+
+    vector<lane_type, Dim> const& lower_bound() const { return _lower; }
+    vector<lane_type, Dim> const& upper_bound() const { return _upper; }
+
+    /// Lanes that hold a box
+    simd_mask<T, W> valid() const { return _valid; }
+
+private:
+    vector<lane_type, Dim> _lower;
+    vector<lane_type, Dim> _upper;
+    simd_mask<T, W> _valid{};
+};
+
 template <typename T, typename U, size_t Dim, vector_options O,
           vector_options P>
 auto distance(line_segment<T, Dim, O> const& l, vector<U, Dim, P> const& p) {
@@ -305,6 +408,112 @@ constexpr bool do_intersect(AABB<U, Dim, P> a, sphere<T, Dim, O> b) {
     return do_intersect(b, a);
 }
 
+/// MARK: - Ray Intersections
+/// Ray - Box
+/// Slab test without branches. A direction component of zero yields infinite
+/// slab parameters, which the min and max handle correctly unless the origin
+/// lies exactly on a slab plane.
+template <typename T, size_t Dim, vector_options O, vector_options P>
+constexpr ray_interval<T> intersect(ray<T, Dim, O> const& r,
+                                    AABB<T, Dim, P> const& box) {
+    auto const t0 = (box.lower_bound() - r.origin()) * r.inverse_direction();
+    auto const t1 = (box.upper_bound() - r.origin()) * r.inverse_direction();
+    auto const near = _VVML::min(t0, t1);
+    auto const far = _VVML::max(t0, t1);
+    T const t_min = fold(near, [](T a, T b) { return std::max(a, b); });
+    T const t_max = fold(far, [](T a, T b) { return std::min(a, b); });
+    return { std::max(t_min, T(0)), t_max };
+}
+
+template <typename T, size_t Dim, vector_options O, vector_options P>
+constexpr bool do_intersect(ray<T, Dim, O> const& r,
+                            AABB<T, Dim, P> const& box) {
+    return intersect(r, box).hit();
+}
+
+/// Ray - Box Packet
+/// Tests \p r against all boxes of \p packet at once. Lane `i` of the result
+/// is the interval of box `i`.
+template <typename T, size_t W, size_t Dim, vector_options O>
+ray_interval<simd_lane<T, W>> intersect(ray<T, Dim, O> const& r,
+                                        aabb_packet<T, W, Dim> const& packet) {
+    using L = simd_lane<T, W>;
+    auto const broadcast = [](vector<T, Dim, O> const& v) {
+        return vector<L, Dim>([&](size_t k) { return L(v.__vml_at(k)); });
+    };
+    auto const origin = broadcast(r.origin());
+    auto const inverse_direction = broadcast(r.inverse_direction());
+    auto const t0 = (packet.lower_bound() - origin) * inverse_direction;
+    auto const t1 = (packet.upper_bound() - origin) * inverse_direction;
+    auto const near = _VVML::min(t0, t1);
+    auto const far = _VVML::max(t0, t1);
+    L const t_min = fold(near, [](L a, L b) { return _VVML::max(a, b); });
+    L const t_max = fold(far, [](L a, L b) { return _VVML::min(a, b); });
+    L const empty = std::numeric_limits<T>::infinity();
+    return { select(packet.valid(), _VVML::max(t_min, L(T(0))), empty),
+             t_max };
+}
+
+/// Ray - Sphere
+template <typename T, size_t Dim, vector_options O, vector_options P>
+constexpr ray_interval<T> intersect(ray<T, Dim, O> const& r,
+                                    sphere<T, Dim, P> const& s) {
+    vector<T, Dim, O> const oc = r.origin() - vector<T, Dim, O>(s.origin());
+    T const a = dot(r.direction(), r.direction());
+    T const b = dot(oc, r.direction());
+    T const c = dot(oc, oc) - s.radius() * s.radius();
+    T const discriminant = b * b - a * c;
+    if (discriminant < 0) {
+        return { std::numeric_limits<T>::infinity(),
+                 -std::numeric_limits<T>::infinity() };
+    }
+    T const root = std::sqrt(discriminant);
+    return { std::max((-b - root) / a, T(0)), (-b + root) / a };
+}
+
+template <typename T, size_t Dim, vector_options O, vector_options P>
+constexpr bool do_intersect(ray<T, Dim, O> const& r,
+                            sphere<T, Dim, P> const& s) {
+    return intersect(r, s).hit();
+}
+
+/// Ray - Triangle
+/// Möller–Trumbore. Rays parallel to the plane of the triangle miss it.
+template <typename T, vector_options O, vector_options P>
+constexpr std::optional<ray_triangle_hit<T>> intersect(
+    ray<T, 3, O> const& r, triangle<T, 3, P> const& tri) {
+    vector3<T, O> const p0 = tri[0];
+    vector3<T, O> const e1 = vector3<T, O>(tri[1]) - p0;
+    vector3<T, O> const e2 = vector3<T, O>(tri[2]) - p0;
+    vector3<T, O> const p = cross(r.direction(), e2);
+    T const det = dot(e1, p);
+    if (det == 0) {
+        return std::nullopt;
+    }
+    T const inverse_det = T(1) / det;
+    vector3<T, O> const s = r.origin() - p0;
+    T const u = dot(s, p) * inverse_det;
+    if (u < 0 || u > 1) {
+        return std::nullopt;
+    }
+    vector3<T, O> const q = cross(s, e1);
+    T const v = dot(r.direction(), q) * inverse_det;
+    if (v < 0 || u + v > 1) {
+        return std::nullopt;
+    }
+    T const t = dot(e2, q) * inverse_det;
+    if (t < 0) {
+        return std::nullopt;
+    }
+    return ray_triangle_hit<T>{ t, u, v };
+}
+
+template <typename T, vector_options O, vector_options P>
+constexpr bool do_intersect(ray<T, 3, O> const& r,
+                            triangle<T, 3, P> const& tri) {
+    return intersect(r, tri).has_value();
+}
+
 } // namespace _VVML
 
 #endif // __VML_SHAPES_HPP_INCLUDED__
@@ -0,0 +1,308 @@
+#ifndef __VML_SIMD_LANE_HPP_INCLUDED__
+#define __VML_SIMD_LANE_HPP_INCLUDED__
+
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+
+#include "common.hpp"
+#include "fwd.hpp"
+#include "intrin.hpp"
+
+/// # Packet Types
+///
+/// `simd_lane<T, W>` holds `W` values of type `T` in one SIMD register and
+/// behaves like a scalar whose operations act on all lanes at once. Vectors,
+/// matrices and quaternions of lanes, e.g. `vector<simd_lane<float, 8>, 3>`,
+/// process `W` elements per instruction with the same templates that are
+/// written for `float3`.
+///
+/// Comparisons yield a `simd_mask`. Code that branches on scalars needs to be
+/// rewritten with `select`.
+
+namespace _VVML {
+
+/// MARK: - struct simd_mask
+template <typename T, size_t W>
+struct simd_mask {
+    using simd_type = __simd_type<T, W, false>;
+
+    /// Bit `i` is set if the mask is set in lane `i`
+    __vml_always_inline __vml_interface_export unsigned bits() const {
+        return simd_type::movemask(__vec);
+    }
+    __vml_always_inline __vml_interface_export bool operator[](
+        size_t i) const {
+        __vml_bounds_check(i, 0, W);
+        return (bits() >> i) & 1;
+    }
+    __vml_always_inline __vml_interface_export bool any() const {
+        return bits() != 0;
+    }
+    __vml_always_inline __vml_interface_export bool all() const {
+        return bits() == (1u << W) - 1;
+    }
+    __vml_always_inline __vml_interface_export bool none() const {
+        return !any();
+    }
+
+    __vml_always_inline __vml_interface_export friend simd_mask operator&(
+        simd_mask const& a, simd_mask const& b) {
+        simd_mask result;
+        simd_type::splat(result.__vec, T(0));
+        simd_type::blend(result.__vec, b.__vec, a.__vec);
+        return result;
+    }
+    __vml_always_inline __vml_interface_export friend simd_mask operator|(
+        simd_mask const& a, simd_mask const& b) {
+        simd_mask result = b;
+        simd_type::blend(result.__vec, a.__vec, a.__vec);
+        return result;
+    }
+    __vml_always_inline __vml_interface_export friend simd_mask operator!(
+        simd_mask const& a) {
+        simd_mask result = a;
+        typename simd_type::type zero;
+        simd_type::splat(zero, T(0));
+        simd_type::cmp_eq(result.__vec, zero);
+        return result;
+    }
+
+    typename simd_type::type __vec;
+};
+
+/// MARK: - struct simd_lane
+template <typename T, size_t W>
+struct simd_lane {
+    using simd_type = __simd_type<T, W, false>;
+    using value_type = T;
+    using mask_type = simd_mask<T, W>;
+    static constexpr size_t width = W;
+
+    simd_lane() = default;
+    /// Broadcasts \p value to all lanes
+    __vml_always_inline __vml_interface_export simd_lane(T value) {
+        simd_type::splat(__vec, value);
+    }
+
+    /// Loads `W` values from the unaligned address \p p
+    __vml_always_inline __vml_interface_export static simd_lane load(
+        T const* p) {
+        simd_lane result;
+        simd_type::load(result.__vec, p);
+        return result;
+    }
+    /// Stores the lanes to the unaligned address \p p
+    __vml_always_inline __vml_interface_export void store(T* p) const {
+        simd_type::store(__vec, p);
+    }
+
+    __vml_always_inline __vml_interface_export T operator[](size_t i) const {
+        __vml_bounds_check(i, 0, W);
+        return simd_type::get(__vec, i);
+    }
+    __vml_interface_export void set(size_t i, T value) {
+        __vml_bounds_check(i, 0, W);
+        T lanes[W];
+        store(lanes);
+        lanes[i] = value;
+        simd_type::load(__vec, lanes);
+    }
+
+    /// MARK: Arithmetic
+    __vml_always_inline __vml_interface_export simd_lane& operator+=(
+        simd_lane const& rhs) {
+        simd_type::add(__vec, rhs.__vec);
+        return *this;
+    }
+    __vml_always_inline __vml_interface_export simd_lane& operator-=(
+        simd_lane const& rhs) {
+        simd_type::sub(__vec, rhs.__vec);
+        return *this;
+    }
+    __vml_always_inline __vml_interface_export simd_lane& operator*=(
+        simd_lane const& rhs) {
+        simd_type::mul(__vec, rhs.__vec);
+        return *this;
+    }
+    __vml_always_inline __vml_interface_export simd_lane& operator/=(
+        simd_lane const& rhs) {
+        simd_type::div(__vec, rhs.__vec);
+        return *this;
+    }
+
+    __vml_always_inline __vml_interface_export friend simd_lane operator+(
+        simd_lane a, simd_lane const& b) {
+        return a += b;
+    }
+    __vml_always_inline __vml_interface_export friend simd_lane operator-(
+        simd_lane a, simd_lane const& b) {
+        return a -= b;
+    }
+    __vml_always_inline __vml_interface_export friend simd_lane operator*(
+        simd_lane a, simd_lane const& b) {
+        return a *= b;
+    }
+    __vml_always_inline __vml_interface_export friend simd_lane operator/(
+        simd_lane a, simd_lane const& b) {
+        return a /= b;
+    }
+    __vml_always_inline __vml_interface_export friend simd_lane operator+(
+        simd_lane const& a) {
+        return a;
+    }
+    /// Multiplying by `-1` flips the sign of zeros, unlike `0 - a`
+    __vml_always_inline __vml_interface_export friend simd_lane operator-(
+        simd_lane a) {
+        return a *= simd_lane(T(-1));
+    }
+
+    /// MARK: Comparison
+    __vml_always_inline __vml_interface_export friend mask_type operator==(
+        simd_lane const& a, simd_lane const& b) {
+        auto result = std::bit_cast<mask_type>(a);
+        simd_type::cmp_eq(result.__vec, b.__vec);
+        return result;
+    }
+    __vml_always_inline __vml_interface_export friend mask_type operator!=(
+        simd_lane const& a, simd_lane const& b) {
+        return !(a == b);
+    }
+    __vml_always_inline __vml_interface_export friend mask_type operator<(
+        simd_lane const& a, simd_lane const& b) {
+        auto result = std::bit_cast<mask_type>(a);
+        simd_type::cmp_lt(result.__vec, b.__vec);
+        return result;
+    }
+    __vml_always_inline __vml_interface_export friend mask_type operator<=(
+        simd_lane const& a, simd_lane const& b) {
+        auto result = std::bit_cast<mask_type>(a);
+        simd_type::cmp_le(result.__vec, b.__vec);
+        return result;
+    }
+    __vml_always_inline __vml_interface_export friend mask_type operator>(
+        simd_lane const& a, simd_lane const& b) {
+        return b < a;
+    }
+    __vml_always_inline __vml_interface_export friend mask_type operator>=(
+        simd_lane const& a, simd_lane const& b) {
+        return b <= a;
+    }
+
+    typename simd_type::type __vec;
+};
+
+/// Lane `i` of the result is `mask[i] ? a[i] : b[i]`
+template <typename T, size_t W>
+__vml_always_inline __vml_interface_export simd_lane<T, W> select(
+    simd_mask<T, W> const& mask, simd_lane<T, W> const& a,
+    simd_lane<T, W> b) {
+    simd_lane<T, W>::simd_type::blend(b.__vec, a.__vec, mask.__vec);
+    return b;
+}
+
+/// MARK: - Math Functions
+template <typename T, size_t W>
+__vml_always_inline __vml_interface_export simd_lane<T, W> min(
+    simd_lane<T, W> a, std::same_as<simd_lane<T, W>> auto const&... b) {
+    (simd_lane<T, W>::simd_type::min(a.__vec, b.__vec), ...);
+    return a;
+}
+
+template <typename T, size_t W>
+__vml_always_inline __vml_interface_export simd_lane<T, W> max(
+    simd_lane<T, W> a, std::same_as<simd_lane<T, W>> auto const&... b) {
+    (simd_lane<T, W>::simd_type::max(a.__vec, b.__vec), ...);
+    return a;
+}
+
+template <typename T, size_t W>
+__vml_always_inline __vml_interface_export simd_lane<T, W> abs(
+    simd_lane<T, W> a) {
+    simd_lane<T, W>::simd_type::abs(a.__vec);
+    return a;
+}
+
+template <typename T, size_t W>
+__vml_always_inline __vml_interface_export simd_lane<T, W> sqrt(
+    simd_lane<T, W> a) {
+    simd_lane<T, W>::simd_type::sqrt(a.__vec);
+    return a;
+}
+
+/// `a * b + c`, rounded once if the target supports FMA
+template <typename T, size_t W>
+__vml_always_inline __vml_interface_export simd_lane<T, W> fma(
+    simd_lane<T, W> a, simd_lane<T, W> const& b, simd_lane<T, W> const& c) {
+    simd_lane<T, W>::simd_type::fma(a.__vec, b.__vec, c.__vec);
+    return a;
+}
+
+template <typename T, size_t W>
+__vml_always_inline __vml_interface_export simd_lane<T, W> norm_squared(
+    simd_lane<T, W> const& a) {
+    return a * a;
+}
+
+/// Lanes have no overflow fallback, the sum of squares must be finite
+template <typename T, size_t W>
+__vml_always_inline __vml_interface_export simd_lane<T, W> __vml_hypot(
+    simd_lane<T, W> const& a, std::same_as<simd_lane<T, W>> auto const&... b) {
+    if constexpr (sizeof...(b) == 0) {
+        return _VVML::abs(a);
+    }
+    else {
+        return _VVML::sqrt(((a * a) + ... + (b * b)));
+    }
+}
+
+/// MARK: - Packing
+/// Element \p i of a vector of lanes, e.g. the `i`-th `float3` of a
+/// `vector<simd_lane<float, 8>, 3>`
+template <typename T, size_t W, size_t N, vector_options O>
+__vml_interface_export vector<T, N, O> extract_lane(
+    vector<simd_lane<T, W>, N, O> const& v, size_t i) {
+    return vector<T, N, O>([&](size_t k) { return v.__vml_at(k)[i]; });
+}
+
+/// Replaces element \p i of a vector of lanes by \p value
+template <typename T, size_t W, size_t N, vector_options O, vector_options P>
+__vml_interface_export void insert_lane(vector<simd_lane<T, W>, N, O>& v,
+                                        size_t i,
+                                        vector<T, N, P> const& value) {
+    for (size_t k = 0; k < N; ++k) {
+        v.__vml_at(k).set(i, value.__vml_at(k));
+    }
+}
+
+/// MARK: - Traits
+template <typename T>
+inline constexpr bool __vml_is_simd_lane = false;
+template <typename T, size_t W>
+inline constexpr bool __vml_is_simd_lane<simd_lane<T, W>> = true;
+
+template <typename T, size_t W>
+struct is_real_scalar<simd_lane<T, W>>: std::true_type {};
+template <typename T, size_t W>
+struct is_real_scalar<simd_lane<T, W> const>: std::true_type {};
+
+template <typename T, size_t W>
+struct __vml_to_float<simd_lane<T, W>> {
+    using type = simd_lane<__vml_to_float_t<T>, W>;
+};
+
+} // namespace _VVML
+
+/// Lanes absorb the arithmetic types they are combined with
+template <typename T, size_t W, typename U>
+    requires std::is_arithmetic_v<U>
+struct std::common_type<_VVML::simd_lane<T, W>, U> {
+    using type = _VVML::simd_lane<T, W>;
+};
+template <typename T, size_t W, typename U>
+    requires std::is_arithmetic_v<U>
+struct std::common_type<U, _VVML::simd_lane<T, W>> {
+    using type = _VVML::simd_lane<T, W>;
+};
+
+#endif // __VML_SIMD_LANE_HPP_INCLUDED__
@@ -0,0 +1,480 @@
+#ifndef __VML_SOA_HPP_INCLUDED__
+#define __VML_SOA_HPP_INCLUDED__
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "batch.hpp"
+#include "fwd.hpp"
+#include "simd_lane.hpp"
+#include "vector.hpp"
+
+/// Structure-of-arrays storage for vectors.
+///
+/// `soa_array<vector<T, N, O>>` stores component `k` of all elements in its
+/// own contiguous, cache line aligned stream. Unlike an array of
+/// `vector<T, 3>`, no padding lanes are stored or loaded, and the bulk
+/// functions below run the batch kernels over whole streams.
+
+namespace _VVML {
+
+template <typename>
+class soa_array;
+
+template <typename T, size_t N, vector_options O>
+    requires std::same_as<T, float> || std::same_as<T, double>
+class soa_array<vector<T, N, O>> {
+public:
+    using value_type = vector<T, N, O>;
+    using scalar_type = T;
+    /// Elements of one native SIMD register per component, see `map`
+    using packet_type =
+        vector<simd_lane<T, (VML_AVX ? 32 : 16) / sizeof(T)>, N, O>;
+
+    /// Alignment of every stream in bytes
+    static constexpr size_t alignment = 64;
+
+    /// Proxy for one element, converts to and assigns from `value_type`
+    class reference {
+        friend class soa_array;
+        reference(soa_array& array, size_t index):
+            _array(array), _index(index) {}
+
+    public:
+        __vml_interface_export operator value_type() const {
+            return std::as_const(_array)[_index];
+        }
+        __vml_interface_export reference& operator=(value_type const& value) {
+            for (size_t k = 0; k < N; ++k) {
+                _array.data(k)[_index] = value.__vml_at(k);
+            }
+            return *this;
+        }
+        __vml_interface_export reference& operator=(reference const& rhs) {
+            return *this = value_type(rhs);
+        }
+        /// Component \p k of the element
+        __vml_interface_export T& operator[](size_t k) const {
+            __vml_bounds_check(k, 0, N);
+            return _array.data(k)[_index];
+        }
+
+    private:
+        soa_array& _array;
+        size_t _index;
+    };
+
+public:
+    soa_array() = default;
+    /// \p size zero initialized elements
+    __vml_interface_export explicit soa_array(size_t size):
+        _data(_allocate(_padded(size))), _size(size), _stride(_padded(size)) {}
+    /// Transposes the array of structures \p aos
+    __vml_interface_export explicit soa_array(
+        std::span<value_type const> aos):
+        soa_array(aos.size()) {
+        for (size_t k = 0; k < N; ++k) {
+            T* const stream = data(k);
+            for (size_t i = 0; i < _size; ++i) {
+                stream[i] = aos[i].__vml_at(k);
+            }
+        }
+    }
+    __vml_interface_export soa_array(soa_array const& rhs):
+        soa_array(rhs._size) {
+        std::copy_n(rhs._data.get(), N * _stride, _data.get());
+    }
+    __vml_interface_export soa_array(soa_array&& rhs) noexcept:
+        _data(std::move(rhs._data)),
+        _size(std::exchange(rhs._size, 0)),
+        _stride(std::exchange(rhs._stride, 0)) {}
+    __vml_interface_export soa_array& operator=(soa_array rhs) noexcept {
+        std::swap(_data, rhs._data);
+        std::swap(_size, rhs._size);
+        std::swap(_stride, rhs._stride);
+        return *this;
+    }
+
+    /// Writes the elements into the array of structures \p aos
+    __vml_interface_export void to_aos(std::span<value_type> aos) const {
+        __vml_expect(aos.size() == _size);
+        for (size_t i = 0; i < _size; ++i) {
+            aos[i] = (*this)[i];
+        }
+    }
+
+    /// Resizes the array, new elements are zero initialized
+    __vml_interface_export void resize(size_t size) {
+        soa_array result(size);
+        size_t const count = std::min(size, _size);
+        for (size_t k = 0; k < N; ++k) {
+            std::copy_n(data(k), count, result.data(k));
+        }
+        *this = std::move(result);
+    }
+
+    __vml_interface_export size_t size() const { return _size; }
+    __vml_interface_export bool empty() const { return _size == 0; }
+    /// Distance between two streams in scalars
+    __vml_interface_export size_t stride() const { return _stride; }
+
+    /// The stream of component \p k
+    __vml_interface_export T* data(size_t k) {
+        __vml_bounds_check(k, 0, N);
+        return _data.get() + k * _stride;
+    }
+    __vml_interface_export T const* data(size_t k) const {
+        __vml_bounds_check(k, 0, N);
+        return _data.get() + k * _stride;
+    }
+    __vml_interface_export std::span<T> component(size_t k) {
+        return { data(k), _size };
+    }
+    __vml_interface_export std::span<T const> component(size_t k) const {
+        return { data(k), _size };
+    }
+
+    __vml_interface_export reference operator[](size_t i) {
+        __vml_bounds_check(i, 0, _size);
+        return reference(*this, i);
+    }
+    __vml_interface_export value_type operator[](size_t i) const {
+        __vml_bounds_check(i, 0, _size);
+        return value_type([&](size_t k) { return data(k)[i]; });
+    }
+
+private:
+    struct _deleter {
+        void operator()(T* p) const {
+            ::operator delete(p, std::align_val_t(alignment));
+        }
+    };
+
+    /// Streams are padded to whole cache lines
+    static size_t _padded(size_t size) {
+        constexpr size_t lanes = alignment / sizeof(T);
+        return (size + lanes - 1) / lanes * lanes;
+    }
+
+    static std::unique_ptr<T[], _deleter> _allocate(size_t stride) {
+        if (stride == 0) {
+            return nullptr;
+        }
+        T* const data = static_cast<T*>(::operator new(
+            N * stride * sizeof(T), std::align_val_t(alignment)));
+        std::fill_n(data, N * stride, T(0));
+        return std::unique_ptr<T[], _deleter>(data);
+    }
+
+    std::unique_ptr<T[], _deleter> _data;
+    size_t _size = 0;
+    size_t _stride = 0;
+};
+
+/// MARK: - Bulk Arithmetic
+
+/// Element-wise `a OP b`, runs `KERNEL` over every pair of streams
+#define __VML_PRIV_SOA_BINARY(OP, KERNEL)                                      \
+    template <typename T, size_t N, vector_options O>                          \
+    soa_array<vector<T, N, O>>& operator OP##=(                                \
+        soa_array<vector<T, N, O>>& a, soa_array<vector<T, N, O>> const& b) {  \
+        __vml_expect(a.size() == b.size());                                    \
+        auto const kernel = __vml_batch_kernel(KERNEL, T);                     \
+        for (size_t k = 0; k < N; ++k) {                                       \
+            kernel(a.data(k), b.data(k), a.data(k), a.size());                 \
+        }                                                                      \
+        return a;                                                              \
+    }                                                                          \
+    template <typename T, size_t N, vector_options O>                          \
+    soa_array<vector<T, N, O>> operator OP(                                    \
+        soa_array<vector<T, N, O>> const& a,                                   \
+        soa_array<vector<T, N, O>> const& b) {                                 \
+        __vml_expect(a.size() == b.size());                                    \
+        soa_array<vector<T, N, O>> result(a.size());                           \
+        auto const kernel = __vml_batch_kernel(KERNEL, T);                     \
+        for (size_t k = 0; k < N; ++k) {                                       \
+            kernel(a.data(k), b.data(k), result.data(k), a.size());            \
+        }                                                                      \
+        return result;                                                         \
+    }
+
+__VML_PRIV_SOA_BINARY(+, add)
+__VML_PRIV_SOA_BINARY(-, sub)
+__VML_PRIV_SOA_BINARY(*, mul)
+__VML_PRIV_SOA_BINARY(/, div)
+
+#undef __VML_PRIV_SOA_BINARY
+
+template <typename T, size_t N, vector_options O>
+soa_array<vector<T, N, O>>& operator*=(soa_array<vector<T, N, O>>& a, T s) {
+    auto const kernel = __vml_batch_kernel(scale, T);
+    for (size_t k = 0; k < N; ++k) {
+        kernel(a.data(k), s, a.data(k), a.size());
+    }
+    return a;
+}
+
+template <typename T, size_t N, vector_options O>
+soa_array<vector<T, N, O>> operator*(soa_array<vector<T, N, O>> a, T s) {
+    return a *= s;
+}
+
+template <typename T, size_t N, vector_options O>
+soa_array<vector<T, N, O>> operator*(T s, soa_array<vector<T, N, O>> a) {
+    return a *= s;
+}
+
+/// MARK: - Bulk Math Functions
+
+/// `out[i] = dot(a[i], b[i])`
+template <typename T, size_t N, vector_options O>
+void dot(soa_array<vector<T, N, O>> const& a,
+         soa_array<vector<T, N, O>> const& b,
+         std::type_identity_t<std::span<T>> out) {
+    __vml_expect(a.size() == b.size());
+    __vml_expect(a.size() == out.size());
+    __vml_batch_kernel(mul, T)(a.data(0), b.data(0), out.data(), out.size());
+    auto const fma = __vml_batch_kernel(fma, T);
+    for (size_t k = 1; k < N; ++k) {
+        fma(a.data(k), b.data(k), out.data(), out.data(), out.size());
+    }
+}
+
+/// `out[i] = norm(a[i])`
+template <typename T, size_t N, vector_options O>
+void norm(soa_array<vector<T, N, O>> const& a,
+          std::type_identity_t<std::span<T>> out) {
+    _VVML::dot(a, a, out);
+    __vml_batch_kernel(sqrt, T)(out.data(), out.data(), out.size());
+}
+
+/// `result[i] = normalize(a[i])`
+template <typename T, size_t N, vector_options O>
+soa_array<vector<T, N, O>> normalize(soa_array<vector<T, N, O>> const& a) {
+    std::vector<T> norms(a.size());
+    _VVML::norm(a, norms);
+    soa_array<vector<T, N, O>> result(a.size());
+    auto const kernel = __vml_batch_kernel(div, T);
+    for (size_t k = 0; k < N; ++k) {
+        kernel(a.data(k), norms.data(), result.data(k), a.size());
+    }
+    return result;
+}
+
+/// `out[i] = normalize_approx<P>(in[i])` for 2-, 3- and 4-vectors. \p in and
+/// \p out may be the same array.
+template <normalize_precision P = normalize_precision::rsqrt_newton,
+          typename T, size_t N, vector_options O>
+    requires(N >= 2 && N <= 4)
+void normalize_approx(soa_array<vector<T, N, O>> const& in,
+                      soa_array<vector<T, N, O>>& out) {
+    __vml_expect(in.size() == out.size());
+    if (in.empty()) {
+        return;
+    }
+    __vml_batch_kernel(normalize, T)(P, N, { in.data(0), 1, in.stride() },
+                                     { out.data(0), 1, out.stride() },
+                                     in.size());
+}
+
+template <typename>
+inline constexpr bool __vml_is_soa_element = false;
+template <typename T, size_t N, vector_options O>
+inline constexpr bool __vml_is_soa_element<vector<T, N, O>> =
+    std::same_as<T, float> || std::same_as<T, double>;
+
+template <typename>
+inline constexpr bool __vml_is_soa_packet = false;
+template <typename T, size_t W, size_t N, vector_options O>
+inline constexpr bool __vml_is_soa_packet<vector<simd_lane<T, W>, N, O>> =
+    __vml_is_soa_element<vector<T, N, O>>;
+
+/// \p F maps a \p V to a vector that an `soa_array` can store
+template <typename F, typename V>
+concept __vml_soa_element_function =
+    std::invocable<F, V> &&
+    __vml_is_soa_element<std::invoke_result_t<F, V>>;
+
+/// \p F maps a \p V to a vector of lanes that an `soa_array` can store
+template <typename F, typename V>
+concept __vml_soa_packet_function =
+    std::invocable<F, V> && __vml_is_soa_packet<std::invoke_result_t<F, V>>;
+
+/// `result[i] = f(a[i])`, \p f returns a vector of `float` or `double`. \p f
+/// is called once per element, the elements are read from and written to
+/// the streams directly.
+template <typename T, size_t N, vector_options O,
+          __vml_soa_element_function<vector<T, N, O>> F>
+auto map(soa_array<vector<T, N, O>> const& a, F&& f) {
+    using result_type = std::invoke_result_t<F, vector<T, N, O>>;
+    soa_array<result_type> result(a.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        result_type const x = std::invoke(f, a[i]);
+        for (size_t k = 0; k < result_type::size(); ++k) {
+            result.data(k)[i] = x.__vml_at(k);
+        }
+    }
+    return result;
+}
+
+/// Same as above for an \p f that takes a `packet_type` and returns a vector
+/// of `simd_lane`s of the same width. \p f processes a whole SIMD register
+/// of elements per call, loaded from and stored to the streams. The last
+/// packet is padded with zeros.
+///
+///     using packet = soa_array<float3>::packet_type;
+///     auto const b = map(a, [](packet const& v) { return v * v + v; });
+template <typename T, size_t N, vector_options O, typename F>
+    requires(!__vml_soa_element_function<F, vector<T, N, O>> &&
+             __vml_soa_packet_function<
+                 F, typename soa_array<vector<T, N, O>>::packet_type>)
+auto map(soa_array<vector<T, N, O>> const& a, F&& f) {
+    using packet_type = typename soa_array<vector<T, N, O>>::packet_type;
+    using lane_type = typename packet_type::value_type;
+    using result_packet = std::invoke_result_t<F, packet_type>;
+    using result_lane = typename result_packet::value_type;
+    using U = typename result_lane::value_type;
+    constexpr size_t W = lane_type::width;
+    static_assert(result_lane::width == W,
+                  "f must return as many lanes as it takes");
+    soa_array<vector<U, result_packet::size(), result_packet::options()>>
+        result(a.size());
+    static_assert(W <= soa_array<vector<T, N, O>>::alignment / sizeof(T));
+    for (size_t i = 0; i < a.size(); i += W) {
+        // The streams are padded with zeros to whole cache lines, so the last
+        // packet is loaded in place too
+        packet_type const x([&](size_t k) {
+            return lane_type::load(a.data(k) + i);
+        });
+        result_packet const y = std::invoke(f, x);
+        size_t const count = std::min(W, a.size() - i);
+        for (size_t k = 0; k < result_packet::size(); ++k) {
+            if (count == W) {
+                y.__vml_at(k).store(result.data(k) + i);
+                continue;
+            }
+            // Keep the padding of the result zero
+            U buffer[W];
+            y.__vml_at(k).store(buffer);
+            std::copy_n(buffer, count, result.data(k) + i);
+        }
+    }
+    return result;
+}
+
+/// Left fold of the elements of \p a in order, starting with \p init
+template <typename T, size_t N, vector_options O, typename U,
+          std::invocable<U, vector<T, N, O>> F>
+U fold(soa_array<vector<T, N, O>> const& a, U init, F&& f) {
+    for (size_t i = 0; i < a.size(); ++i) {
+        init = std::invoke(f, std::move(init), a[i]);
+    }
+    return init;
+}
+
+/// MARK: - Transforms
+
+template <typename T, vector_options P>
+void __vml_transform_soa(__vml_transform_kind kind,
+                         std::array<T, 16> const& m,
+                         soa_array<vector<T, 3, P>> const& in,
+                         soa_array<vector<T, 3, P>>& out) {
+    __vml_expect(in.size() == out.size());
+    if (in.empty()) {
+        return;
+    }
+    __vml_transform<T>(kind, m.data(), { in.data(0), 1, in.stride() },
+                       { out.data(0), 1, out.stride() }, in.size());
+}
+
+/// Same as the overloads for arrays of vectors, but the components are
+/// loaded from and stored to the streams directly. \p in and \p out may be
+/// the same array.
+template <typename T, vector_options O, vector_options P>
+void transform_points(matrix4x4<T, O> const& m,
+                      soa_array<vector<T, 3, P>> const& in,
+                      soa_array<vector<T, 3, P>>& out) {
+    auto kind = __vml_transform_kind::points;
+    auto const coefficients = __vml_transform_matrix(m, kind);
+    __vml_transform_soa(kind, coefficients, in, out);
+}
+
+template <typename T, vector_options O, vector_options P>
+void transform_vectors(matrix4x4<T, O> const& m,
+                       soa_array<vector<T, 3, P>> const& in,
+                       soa_array<vector<T, 3, P>>& out) {
+    auto kind = __vml_transform_kind::vectors;
+    auto const coefficients = __vml_transform_matrix(m, kind);
+    __vml_transform_soa(kind, coefficients, in, out);
+}
+
+template <typename T, vector_options O, vector_options P>
+void transform_normals(matrix4x4<T, O> const& m,
+                       soa_array<vector<T, 3, P>> const& in,
+                       soa_array<vector<T, 3, P>>& out) {
+    __vml_transform_soa(__vml_transform_kind::vectors, __vml_normal_matrix(m),
+                        in, out);
+}
+
+/// MARK: - Quaternions
+
+/// Same as the overloads for arrays of vectors and quaternions. Quaternions
+/// are stored as 4-vectors with the real part in component 0.
+template <typename T, vector_options P>
+void rotate(soa_array<vector<T, 3, P>> const& in, quaternion<T> const& q,
+            soa_array<vector<T, 3, P>>& out) {
+    __vml_transform_soa(__vml_transform_kind::vectors,
+                        __vml_rotation_matrix(q), in, out);
+}
+
+template <typename T, vector_options P, vector_options Q>
+void rotate(soa_array<vector<T, 3, P>> const& in,
+            soa_array<vector<T, 4, Q>> const& q,
+            soa_array<vector<T, 3, P>>& out) {
+    __vml_expect(in.size() == out.size() && q.size() == out.size());
+    if (in.empty()) {
+        return;
+    }
+    __vml_batch_kernel(rotate, T)({ q.data(0), 1, q.stride() },
+                                  { in.data(0), 1, in.stride() },
+                                  { out.data(0), 1, out.stride() },
+                                  in.size());
+}
+
+template <typename T, vector_options P>
+void multiply_quaternions(soa_array<vector<T, 4, P>> const& a,
+                          soa_array<vector<T, 4, P>> const& b,
+                          soa_array<vector<T, 4, P>>& out) {
+    __vml_expect(a.size() == out.size() && b.size() == out.size());
+    if (a.empty()) {
+        return;
+    }
+    __vml_batch_kernel(multiply_quaternions, T)(
+        { a.data(0), 1, a.stride() }, { b.data(0), 1, b.stride() },
+        { out.data(0), 1, out.stride() }, a.size());
+}
+
+/// The matrices are written to an array of structures
+template <typename T, vector_options P, size_t D, vector_options O>
+    requires(D == 3 || D == 4)
+void rotation_matrices(soa_array<vector<T, 4, P>> const& q,
+                       std::span<matrix<T, D, D, O>> out) {
+    using M = matrix<T, D, D, O>;
+    __vml_expect(q.size() == out.size());
+    if (q.empty()) {
+        return;
+    }
+    __vml_batch_kernel(rotation_matrices, T)(
+        { q.data(0), 1, q.stride() }, D, M::data_size() / D,
+        { reinterpret_cast<T*>(out.data()), M::data_size(), 1 }, q.size());
+}
+
+} // namespace _VVML
+
+#endif // __VML_SOA_HPP_INCLUDED__
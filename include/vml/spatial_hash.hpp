@@ -0,0 +1,341 @@
+#ifndef __VML_SPATIAL_HASH_HPP_INCLUDED__
+#define __VML_SPATIAL_HASH_HPP_INCLUDED__
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "fwd.hpp"
+#include "par.hpp"
+#include "shapes.hpp"
+#include "vector.hpp"
+
+/// # Spatial Hash
+///
+/// `spatial_hash<T, Dim, Payload>` buckets points into a uniform grid of cubic
+/// cells. Only cells that contain points are stored: an open addressing table
+/// with linear probing maps the integer coordinates of a cell to the first of
+/// its entries. The entries live in flat arrays of points, payloads and next
+/// indices. After `rebuild()` the entries of a cell are mostly adjacent, so a
+/// query walks forward through memory.
+///
+/// Radius queries visit every cell overlapping the bounding box of the query
+/// sphere. Cells about as large as the typical query radius work best.
+
+namespace _VVML {
+
+/// MARK: - class spatial_hash
+template <typename T = float, size_t Dim = 3,
+          typename Payload = std::uint32_t>
+class spatial_hash {
+    static_assert(std::is_floating_point_v<T>);
+    static_assert(Dim >= 1);
+
+    using packed_vector = vector<T, Dim, vector_options{}.packed(true)>;
+    using packed_cell = vector<int, Dim, vector_options{}.packed(true)>;
+
+public:
+    using vector_type = vector<T, Dim>;
+    using cell_type = vector<int, Dim>;
+    using payload_type = Payload;
+
+    /// Rebuilds with fewer points per thread run on one thread
+    static constexpr size_t min_points_per_thread = 1 << 14;
+
+    /// \p cell_size is the edge length of the cells
+    explicit spatial_hash(T cell_size):
+        _cell_size(cell_size), _inverse_cell_size(T(1) / cell_size) {
+        __vml_expect(cell_size > 0);
+    }
+
+    T cell_size() const { return _cell_size; }
+
+    /// Number of points
+    size_t size() const { return _points.size(); }
+    bool empty() const { return _points.empty(); }
+
+    /// The cell containing \p p. The coordinates of \p p divided by the cell
+    /// size must fit into an `int`.
+    template <vector_options P>
+    cell_type cell(vector<T, Dim, P> const& p) const {
+        return cell_type(_VVML::floor(p * _inverse_cell_size));
+    }
+
+    /// Removes all points, keeps the memory
+    void clear() {
+        _points.clear();
+        _payloads.clear();
+        _next.clear();
+        std::fill(_slots.begin(), _slots.end(), _slot{});
+        _used_slots = 0;
+    }
+
+    /// MARK: Modifiers
+
+    /// Adds \p payload at \p p
+    template <vector_options P>
+    void insert(vector<T, Dim, P> const& p, Payload payload) {
+        __vml_expect(size() < _max_size);
+        packed_cell const c = cell(p);
+        _reserve_slots(_used_slots + 1);
+        _slot& s = _slots[_find_or_insert(c, _hash(c))];
+        _points.push_back(p);
+        _payloads.push_back(std::move(payload));
+        _next.push_back(s.head);
+        s.head = std::uint32_t(_points.size() - 1);
+    }
+
+    /// Removes one entry of \p payload that was inserted at \p p. Returns
+    /// `false` if there is no such entry. The last entry moves into the gap,
+    /// so this is constant time for cells with few points.
+    template <vector_options P>
+    bool erase(vector<T, Dim, P> const& p, Payload const& payload) {
+        size_t const s = _find(cell(p));
+        if (s == _npos) {
+            return false;
+        }
+        std::uint32_t* link = &_slots[s].head;
+        while (*link != _end && !(_payloads[*link] == payload)) {
+            link = &_next[*link];
+        }
+        if (*link == _end) {
+            return false;
+        }
+        std::uint32_t const k = *link;
+        *link = _next[k];
+        std::uint32_t const last = std::uint32_t(_points.size() - 1);
+        if (k != last) {
+            // Redirect the link to the last entry before moving it
+            std::uint32_t* l = &_slots[_find(cell(_points[last]))].head;
+            while (*l != last) {
+                l = &_next[*l];
+            }
+            *l = k;
+            _points[k] = _points[last];
+            _payloads[k] = std::move(_payloads[last]);
+            _next[k] = _next[last];
+        }
+        _points.pop_back();
+        _payloads.pop_back();
+        _next.pop_back();
+        return true;
+    }
+
+    /// Replaces the contents with \p payloads at \p points. The cells are
+    /// computed and the entries sorted by table position in up to \p threads
+    /// chunks on the default thread pool, `0` uses one chunk per thread of
+    /// the pool. Linking the sorted entries into the table is serial.
+    void rebuild(std::span<vector_type const> points,
+                 std::span<Payload const> payloads, size_t threads = 0) {
+        __vml_expect(points.size() == payloads.size());
+        _rebuild(points, [&](size_t i) { return payloads[i]; }, threads);
+    }
+
+    /// Same as above with the payload of each point being its index
+    void rebuild(std::span<vector_type const> points, size_t threads = 0)
+        requires std::constructible_from<Payload, size_t>
+    {
+        _rebuild(points, [](size_t i) { return Payload(i); }, threads);
+    }
+
+    /// MARK: Queries
+
+    /// Calls \p f with the payload of every point within \p radius of
+    /// \p center. A negative or NaN radius finds nothing.
+    template <vector_options P, std::invocable<Payload const&> F>
+    void query(vector<T, Dim, P> const& center, T radius, F&& f) const {
+        // `lower > upper` would never stop the odometer below
+        if (empty() || !(radius >= T(0))) {
+            return;
+        }
+        packed_vector const c = center;
+        T const radius_squared = radius * radius;
+        packed_cell const lower = cell(c - radius);
+        packed_cell const upper = cell(c + radius);
+        packed_cell index = lower;
+        while (true) {
+            size_t const s = _find(index);
+            std::uint32_t k = s == _npos ? _end : _slots[s].head;
+            for (; k != _end; k = _next[k]) {
+                if (distance_squared(_points[k], c) <= radius_squared) {
+                    std::invoke(f, _payloads[k]);
+                }
+            }
+            // Odometer over the cells in `[lower, upper]`
+            size_t axis = 0;
+            for (; axis < Dim && index[axis] == upper[axis]; ++axis) {
+                index[axis] = lower[axis];
+            }
+            if (axis == Dim) {
+                return;
+            }
+            ++index[axis];
+        }
+    }
+
+    /// Calls \p f with the payload of every point inside \p s
+    template <vector_options P, std::invocable<Payload const&> F>
+    void query(sphere<T, Dim, P> const& s, F&& f) const {
+        query(s.origin(), s.radius(), std::forward<F>(f));
+    }
+
+private:
+    /// MARK: Table
+
+    static constexpr std::uint32_t _end =
+        std::numeric_limits<std::uint32_t>::max();
+    /// Marks slots without a cell
+    static constexpr std::uint32_t _free = _end - 1;
+    static constexpr size_t _max_size = _free;
+    static constexpr size_t _npos = size_t(-1);
+
+    /// Cells whose entries have all been erased keep their slot until the
+    /// table grows, so probe sequences never break
+    struct _slot {
+        packed_cell cell;
+        std::uint32_t head = _free;
+    };
+
+    static std::uint64_t _hash(packed_cell const& c) {
+        return std::hash<packed_cell>{}(c);
+    }
+
+    size_t _find(packed_cell const& c) const {
+        if (_slots.empty()) {
+            return _npos;
+        }
+        size_t const mask = _slots.size() - 1;
+        for (size_t s = _hash(c) & mask;; s = (s + 1) & mask) {
+            if (_slots[s].head == _free) {
+                return _npos;
+            }
+            if (_slots[s].cell == c) {
+                return s;
+            }
+        }
+    }
+
+    /// The table must have a free slot
+    size_t _find_or_insert(packed_cell const& c, std::uint64_t hash) {
+        size_t const mask = _slots.size() - 1;
+        for (size_t s = hash & mask;; s = (s + 1) & mask) {
+            if (_slots[s].head == _free) {
+                _slots[s] = { c, _end };
+                ++_used_slots;
+                return s;
+            }
+            if (_slots[s].cell == c) {
+                return s;
+            }
+        }
+    }
+
+    /// Grows the table to keep the load factor below one half with \p count
+    /// used slots, dropping empty cells
+    void _reserve_slots(size_t count) {
+        if (2 * count <= _slots.size()) {
+            return;
+        }
+        std::vector<_slot> old = std::move(_slots);
+        _slots.assign(std::bit_ceil(std::max<size_t>(4 * count, 16)), _slot{});
+        _used_slots = 0;
+        for (_slot const& s: old) {
+            if (s.head != _free && s.head != _end) {
+                _slots[_find_or_insert(s.cell, _hash(s.cell))].head = s.head;
+            }
+        }
+    }
+
+    /// MARK: Build
+
+    /// Calls `f(chunk, begin, end)` for \p chunks equal parts of `[0, n)` on
+    /// the default thread pool
+    template <typename F>
+    static void _parallel_for(size_t n, size_t chunks, F const& f) {
+        par::default_pool().for_each_chunk(chunks, 1, [&](size_t c, size_t) {
+            f(c, n * c / chunks, n * (c + 1) / chunks);
+        });
+    }
+
+    template <typename GetPayload>
+    void _rebuild(std::span<vector_type const> points,
+                  GetPayload get_payload, size_t threads) {
+        size_t const n = points.size();
+        __vml_expect(n < _max_size);
+        if (threads == 0) {
+            threads = par::default_pool().size();
+        }
+        size_t const chunks =
+            std::clamp<size_t>(n / min_points_per_thread, 1, threads);
+        _slots.assign(std::bit_ceil(std::max<size_t>(2 * n, 16)), _slot{});
+        _used_slots = 0;
+        // The entries are counting sorted by the top bits of their home slot,
+        // which groups them by cell and by table position
+        size_t const group_bits = std::min<size_t>(
+            std::countr_zero(_slots.size()), 12);
+        size_t const group_shift = std::countr_zero(_slots.size()) - group_bits;
+        size_t const groups = size_t(1) << group_bits;
+        std::vector<packed_cell> cells(n);
+        std::vector<std::uint64_t> hashes(n);
+        std::vector<std::uint32_t> offsets(chunks * groups);
+        size_t const mask = _slots.size() - 1;
+        _parallel_for(n, chunks, [&](size_t c, size_t begin, size_t end) {
+            std::uint32_t* count = offsets.data() + c * groups;
+            for (size_t i = begin; i < end; ++i) {
+                cells[i] = cell(points[i]);
+                hashes[i] = _hash(cells[i]);
+                ++count[(hashes[i] & mask) >> group_shift];
+            }
+        });
+        std::uint32_t sum = 0;
+        for (size_t g = 0; g < groups; ++g) {
+            for (size_t c = 0; c < chunks; ++c) {
+                std::uint32_t const count = offsets[c * groups + g];
+                offsets[c * groups + g] = sum;
+                sum += count;
+            }
+        }
+        std::vector<std::uint32_t> order(n);
+        _points.resize(n);
+        _payloads.clear();
+        _payloads.reserve(n);
+        _parallel_for(n, chunks, [&](size_t c, size_t begin, size_t end) {
+            std::uint32_t* offset = offsets.data() + c * groups;
+            for (size_t i = begin; i < end; ++i) {
+                size_t const k = offset[(hashes[i] & mask) >> group_shift]++;
+                order[k] = std::uint32_t(i);
+                _points[k] = points[i];
+            }
+        });
+        for (std::uint32_t i: order) {
+            _payloads.push_back(get_payload(i));
+        }
+        // Linking back to front keeps every list in memory order
+        _next.resize(n);
+        for (size_t k = n; k-- > 0;) {
+            std::uint32_t const i = order[k];
+            _slot& s = _slots[_find_or_insert(cells[i], hashes[i])];
+            _next[k] = s.head;
+            s.head = std::uint32_t(k);
+        }
+    }
+
+    T _cell_size;
+    T _inverse_cell_size;
+    /// Power of two sized, empty until the first insertion
+    std::vector<_slot> _slots;
+    size_t _used_slots = 0;
+    /// Entries
+    std::vector<packed_vector> _points;
+    std::vector<Payload> _payloads;
+    std::vector<std::uint32_t> _next;
+};
+
+} // namespace _VVML
+
+#endif // __VML_SPATIAL_HASH_HPP_INCLUDED__
@@ -8,7 +8,10 @@
 
 #undef VML_DEBUG_LEVEL
 #undef VML_SAFE_MATH
+#undef VML_DETERMINISTIC
+#undef VML_FP_CONTRACT_OFF
 #undef VML_DEFAULT_PACKED
+#undef VML_RUNTIME_DISPATCH
 #undef VML_NAMESPACE_NAME
 #undef VML_UNICODE_MATH_PARANTHESES
 
@@ -28,6 +31,12 @@
 #undef _VVML
 
 #undef __vml_safe_math_if
+#undef __vml_no_contract
+
+#undef __VML_PRIV_PRAGMA
+#undef __VML_TARGET_PUSH
+#undef __VML_TARGET_POP
+#undef __vml_batch_kernel
 
 #undef __VML_DECLARE_STDINT_TYPEDEFS__
 #undef __VML_DECLARE_COMPLEX_TYPEDEFS__
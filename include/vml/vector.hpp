@@ -8,6 +8,7 @@
 #include "common.hpp"
 #include "fwd.hpp"
 #include "intrin.hpp"
+#include "simd_lane.hpp"
 
 namespace _VVML {
 
@@ -117,6 +118,28 @@ __vml_mathfunction __vml_always_inline __vml_interface_export constexpr T fold(
     return _VVML::left_fold(v, __vml_forward(f));
 }
 
+template <size_t Begin, size_t End>
+__vml_mathfunction __vml_always_inline __vml_interface_export constexpr auto
+    __pairwise_fold_impl(auto&& f, auto const& v) {
+    if constexpr (End - Begin == 1) {
+        return v.__vml_at(Begin);
+    }
+    else {
+        constexpr size_t Middle = Begin + (End - Begin) / 2;
+        return std::invoke(f, _VVML::__pairwise_fold_impl<Begin, Middle>(f, v),
+                           _VVML::__pairwise_fold_impl<Middle, End>(f, v));
+    }
+}
+
+/// Folds the halves of \p v recursively and combines the results with \p f,
+/// e.g. `f(f(v0, v1), f(v2, v3))`. For sums the error grows with
+/// `log2(S)` instead of `S`.
+template <typename T, size_t S, vector_options O, _VVML::invocable_r<T, T, T> F>
+__vml_mathfunction __vml_always_inline __vml_interface_export constexpr T
+    fold_pairwise(vector<T, S, O> const& v, F&& f) {
+    return _VVML::__pairwise_fold_impl<0, S>(f, v);
+}
+
 template <typename, size_t, vector_options, typename, typename>
 struct __vector_base;
 
@@ -138,6 +161,15 @@ struct __vector_data_ {
                 __vec = _mm_load_ps(arr);
             }
         }
+        else if constexpr ((std::is_same_v<T, int> ||
+                            std::is_same_v<T, unsigned>) &&
+                           Size == 4 && !O.packed())
+        {
+            if (!std::is_constant_evaluated()) {
+                alignas(16) T arr[4]{ a, b, c, d };
+                __vec = _mm_load_si128((__m128i const*)arr);
+            }
+        }
 #if VML_AVX
         else if constexpr (std::is_same_v<T, double> && Size == 4 &&
                            !O.packed())
@@ -147,6 +179,14 @@ struct __vector_data_ {
                 __vec = _mm256_load_pd(arr);
             }
         }
+        else if constexpr (std::is_same_v<T, float> && Size == 8 &&
+                           !O.packed())
+        {
+            if (!std::is_constant_evaluated()) {
+                alignas(32) float arr[8]{ a, b, c, d, r... };
+                __vec = _mm256_load_ps(arr);
+            }
+        }
 #endif
     }
 
@@ -389,7 +429,9 @@ struct __vector_base;
 
 template <typename T, size_t Size, vector_options O, typename... AllT,
           size_t... I>
-class alignas(__calculate_alignment(alignof(T), Size, O.packed()))
+/// Lanes are SIMD registers already, vectors of lanes are never padded
+class alignas(__calculate_alignment(alignof(T), Size,
+                                    O.packed() || __vml_is_simd_lane<T>))
     __vector_base<T, Size, O, __vml_type_sequence<AllT...>,
                   __vml_index_sequence<I...>>:
     public __vector_data<T, Size, O> {
@@ -497,7 +539,7 @@ struct vector: public __vector_base<T, Size, O> {
     __vml_pure __vml_always_inline
         __vml_interface_export static constexpr size_t
         data_size() {
-        return Size + (Size == 3 && !O.packed());
+        return Size + (Size == 3 && !O.packed() && !__vml_is_simd_lane<T>);
     }
     __vml_pure __vml_always_inline
         __vml_interface_export static constexpr vector_options
@@ -781,17 +823,38 @@ struct vector: public __vector_base<T, Size, O> {
 template <typename... T>
 vector(T...) -> vector<__vml_promote(T...), sizeof...(T)>;
 
+/// Vectors of `simd_lane` are equal if all components are equal in all lanes
 template <typename T, typename U, size_t Size, vector_options O,
           vector_options P>
     requires requires(T&& t, U&& u) {
         {
             t == u
         } -> std::convertible_to<bool>;
-    }
+    } || (__vml_is_simd_lane<T> && std::same_as<T, U>)
 __vml_mathfunction __vml_always_inline __vml_interface_export constexpr bool
     operator==(vector<T, Size, O> const& v, vector<U, Size, P> const& w) {
-    return _VVML::fold(_VVML::map(v, w, _VVML::__vml_equals),
-                       _VVML::__vml_logical_and);
+    if constexpr (__vml_is_simd_lane<T>) {
+        // Lanes compare to masks, which are combined before reducing
+        auto mask = v.__vml_at(0) == w.__vml_at(0);
+        for (size_t i = 1; i < Size; ++i) {
+            mask = mask & (v.__vml_at(i) == w.__vml_at(i));
+        }
+        return mask.all();
+    }
+    else {
+        /// The mask of all lanes only fits the native SIMD widths
+        if constexpr (real_scalar<T> && real_scalar<U> && Size <= 4) {
+            if (!std::is_constant_evaluated()) {
+                using V = vector<__vml_promote(T, U), Size, combine(O, P)>;
+                using simd_type = __vml_get_simd_type<V>;
+                V mask = __vml_load<V>(v);
+                simd_type::cmp_eq(mask.__vec, __vml_load<V>(w).__vec);
+                return simd_type::movemask(mask.__vec) == (1u << Size) - 1;
+            }
+        }
+        return _VVML::fold(_VVML::map(v, w, _VVML::__vml_equals),
+                           _VVML::__vml_logical_and);
+    }
 }
 
 template <typename CharT, typename T, size_t Size, vector_options O>
@@ -898,6 +961,14 @@ template <typename T, size_t Size, vector_options O>
 __vml_mathfunction __vml_always_inline
     __vml_interface_export constexpr vector<T, Size, O>
     reverse(vector<T, Size, O> const& v) {
+    if constexpr (Size == 4) {
+        if (!std::is_constant_evaluated()) {
+            using simd_type = __vml_get_simd_type<vector<T, Size, O>>;
+            vector<T, Size, O> result = v;
+            simd_type::template shuffle<3, 2, 1, 0>(result.__vec);
+            return result;
+        }
+    }
     return vector<T, Size, O>(
         [&](size_t i) { return v.__vml_at(Size - 1 - i); });
 }
@@ -959,6 +1030,13 @@ constexpr vector<bool, Size, O> isnormal(vector<T, Size, O> const& m) {
 template <scalar T, scalar U, size_t Size, vector_options O, vector_options P>
 __vml_mathfunction __vml_always_inline __vml_interface_export constexpr auto
     dot(vector<T, Size, O> const& a, vector<U, Size, P> const& b) {
+    // The horizontal sums add in a different order than the fold
+    if constexpr (real_scalar<T> && real_scalar<U> && !VML_DETERMINISTIC) {
+        if (!std::is_constant_evaluated()) {
+            auto const product = a * b;
+            return __vml_get_simd_type<decltype(product)>::hsum(product.__vec);
+        }
+    }
     return fold(a * b, _VVML::__vml_plus);
 }
 
@@ -976,6 +1054,88 @@ __vml_mathfunction __vml_always_inline __vml_interface_export constexpr auto
     return norm_squared(a);
 }
 
+/// MARK: Compensated Reductions
+/// The functions below return results as accurate as if they were computed
+/// in twice the working precision and then rounded (Ogita, Rump and Oishi,
+/// "Accurate Sum and Dot Product"). They rely on strict IEEE semantics and
+/// are broken by `-ffast-math`.
+
+/// Returns `a + b` and stores its rounding error to \p err (Knuth's TwoSum)
+template <std::floating_point T>
+__vml_mathfunction __vml_always_inline __vml_interface_export constexpr T
+    __vml_two_sum(T a, T b, T& err) {
+    T const s = a + b;
+    T const z = s - a;
+    err = (a - (s - z)) + (b - z);
+    return s;
+}
+
+/// Returns `a * b` and stores its rounding error to \p err. Without FMA
+/// the operands are split in halves whose products are exact (Dekker).
+template <std::floating_point T>
+__vml_mathfunction __vml_always_inline __vml_interface_export constexpr T
+    __vml_two_product(T a, T b, T& err) {
+    T p = a * b;
+#if defined(__FMA__) || defined(__ARM_FEATURE_FMA)
+    if (!std::is_constant_evaluated()) {
+#if defined(__GNUC__) && !defined(__clang__) && defined(__FMA__)
+        // GCC contracts across statements by default, `p` must not be fused
+        // into the additions of the caller
+        if constexpr (!std::same_as<T, long double>) {
+            asm("" : "+x"(p));
+        }
+#endif
+        err = std::fma(a, b, -p);
+        return p;
+    }
+#endif
+    constexpr T split =
+        T((1ull << (std::numeric_limits<T>::digits + 1) / 2) + 1);
+    auto const halves = [&](T x, T& hi, T& lo) {
+        T const c = split * x;
+        hi = c - (c - x);
+        lo = x - hi;
+    };
+    T ah, al, bh, bl;
+    halves(a, ah, al);
+    halves(b, bh, bl);
+    err = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+    return p;
+}
+
+template <std::floating_point T, size_t Size, vector_options O>
+__vml_mathfunction __vml_always_inline __vml_interface_export constexpr T
+    sum_compensated(vector<T, Size, O> const& a) {
+    T s = a.__vml_at(0), c = 0;
+    for (size_t i = 1; i < Size; ++i) {
+        T e;
+        s = _VVML::__vml_two_sum(s, a.__vml_at(i), e);
+        c += e;
+    }
+    return s + c;
+}
+
+template <std::floating_point T, size_t Size, vector_options O,
+          vector_options P>
+__vml_mathfunction __vml_always_inline __vml_interface_export constexpr T
+    dot_compensated(vector<T, Size, O> const& a, vector<T, Size, P> const& b) {
+    T c;
+    T s = _VVML::__vml_two_product(a.__vml_at(0), b.__vml_at(0), c);
+    for (size_t i = 1; i < Size; ++i) {
+        T ep, es;
+        T const p = _VVML::__vml_two_product(a.__vml_at(i), b.__vml_at(i), ep);
+        s = _VVML::__vml_two_sum(s, p, es);
+        c += ep + es;
+    }
+    return s + c;
+}
+
+template <std::floating_point T, size_t Size, vector_options O>
+__vml_mathfunction __vml_always_inline __vml_interface_export constexpr T
+    norm_squared_compensated(vector<T, Size, O> const& a) {
+    return _VVML::dot_compensated(a, a);
+}
+
 template <scalar T, size_t Size, vector_options O>
 __vml_mathfunction __vml_always_inline __vml_interface_export constexpr auto
     norm(vector<T, Size, O> const& a) {
@@ -1033,7 +1193,10 @@ template <typename T, size_t Size, vector_options O>
 constexpr auto max_norm(vector<T, Size, O> const& v) {
     return __vml_with_index_sequence((I, Size), {
         using std::abs;
-        return max(abs(v.__vml_at(I))...);
+        // `max` returns a reference to one of the temporaries, copy it before
+        // they are destroyed
+        auto const result = max(abs(v.__vml_at(I))...);
+        return result;
     });
 }
 
@@ -1073,12 +1236,93 @@ __vml_mathfunction __vml_always_inline __vml_interface_export constexpr auto
     return a / fast_norm(a);
 }
 
+/// Accuracy and cost of `normalize_approx`
+enum class normalize_precision {
+    /// Same as `normalize`, safe against overflow of the squared norm
+    exact,
+    /// Same as `fast_normalize`, one square root and one division
+    fast,
+    /// Reciprocal square root estimate refined by one Newton-Raphson step,
+    /// about 22 correct bits for `float`
+    rsqrt_newton,
+    /// Reciprocal square root estimate, 12 correct bits for `float` (14 with
+    /// AVX-512)
+    rsqrt,
+};
+
+/// `1 / sqrt(x)` with precision \p P. There is no estimate instruction for
+/// `double` before AVX-512, so `double` is always computed exactly. The
+/// estimates differ between CPU vendors, with `VML_DETERMINISTIC` `float` is
+/// computed exactly too.
+template <normalize_precision P, std::floating_point T>
+__vml_always_inline T __vml_rsqrt(T x) {
+    if constexpr (std::is_same_v<T, float> && !VML_DETERMINISTIC &&
+                  (P == normalize_precision::rsqrt ||
+                   P == normalize_precision::rsqrt_newton))
+    {
+        __m128 const v = _mm_set_ss(x);
+#if defined(__AVX512F__)
+        float y = _mm_cvtss_f32(_mm_rsqrt14_ss(v, v));
+#else
+        float y = _mm_cvtss_f32(_mm_rsqrt_ss(v));
+#endif
+        if constexpr (P == normalize_precision::rsqrt_newton) {
+            y = y * (1.5f - 0.5f * x * y * y);
+        }
+        return y;
+    }
+    else {
+        return T(1) / std::sqrt(x);
+    }
+}
+
+/// Normalizes \p a with the accuracy of \p P. The estimates neither guard
+/// against overflow of the squared norm nor against zero vectors. In constant
+/// expressions the estimates are computed like `fast`.
+template <normalize_precision P = normalize_precision::rsqrt_newton,
+          std::floating_point T, size_t Size, vector_options O>
+__vml_mathfunction __vml_always_inline __vml_interface_export constexpr vector<
+    T, Size, O>
+    normalize_approx(vector<T, Size, O> const& a) {
+    if constexpr (P == normalize_precision::exact) {
+        return normalize(a);
+    }
+    else if constexpr (P == normalize_precision::fast) {
+        return fast_normalize(a);
+    }
+    else {
+        // The estimate instructions are not usable in constant expressions
+        if (std::is_constant_evaluated()) {
+            return fast_normalize(a);
+        }
+        return a * __vml_rsqrt<P>(dot(a, a));
+    }
+}
+
 template <real_scalar T, real_scalar... U, size_t Size, vector_options O,
           vector_options... P>
 __vml_mathfunction __vml_always_inline __vml_interface_export constexpr vector<
     __vml_promote(T, U...), Size, combine(O, P...)>
     min(vector<T, Size, O> const& v, vector<U, Size, P> const&... w) {
-    return map(v, w..., [](auto&&... x) { return _VVML::min(x...); });
+    if constexpr (__vml_is_simd_lane<T>) {
+        // Lanes are SIMD registers already
+        return map(v, w..., [](auto&&... x) { return _VVML::min(x...); });
+    }
+    else {
+        if (std::is_constant_evaluated()) {
+            return map(v, w...,
+                       [](auto&&... x) { return _VVML::min(x...); });
+        }
+
+        using result_type =
+            vector<__vml_promote(T, U...), Size, combine(O, P...)>;
+        using simd_type = __vml_get_simd_type<result_type>;
+
+        result_type result = __vml_load<result_type>(v);
+        (simd_type::min(result.__vec, __vml_load<result_type>(w).__vec), ...);
+
+        return result;
+    }
 }
 
 template <real_scalar T, real_scalar... U, size_t Size, vector_options O,
@@ -1086,7 +1330,58 @@ template <real_scalar T, real_scalar... U, size_t Size, vector_options O,
 __vml_mathfunction __vml_always_inline __vml_interface_export constexpr vector<
     __vml_promote(T, U...), Size, combine(O, P...)>
     max(vector<T, Size, O> const& v, vector<U, Size, P> const&... w) {
-    return map(v, w..., [](auto&&... x) { return _VVML::max(x...); });
+    if constexpr (__vml_is_simd_lane<T>) {
+        // Lanes are SIMD registers already
+        return map(v, w..., [](auto&&... x) { return _VVML::max(x...); });
+    }
+    else {
+        if (std::is_constant_evaluated()) {
+            return map(v, w...,
+                       [](auto&&... x) { return _VVML::max(x...); });
+        }
+
+        using result_type =
+            vector<__vml_promote(T, U...), Size, combine(O, P...)>;
+        using simd_type = __vml_get_simd_type<result_type>;
+
+        result_type result = __vml_load<result_type>(v);
+        (simd_type::max(result.__vec, __vml_load<result_type>(w).__vec), ...);
+
+        return result;
+    }
+}
+
+/// Computes `a * b + c` (element-wise). Whether the result is rounded once
+/// depends on the FMA support of the target, with `VML_DETERMINISTIC` it is
+/// always rounded twice.
+template <real_scalar T, real_scalar U, real_scalar V, size_t Size,
+          vector_options O, vector_options P, vector_options Q>
+__vml_mathfunction __vml_always_inline __vml_interface_export constexpr vector<
+    __vml_promote(T, U, V), Size, combine(O, P, Q)>
+    fma(vector<T, Size, O> const& a, vector<U, Size, P> const& b,
+        vector<V, Size, Q> const& c) {
+    if constexpr (__vml_is_simd_lane<T>) {
+        return map(a, b, c,
+                   [](auto x, auto y, auto z) { return _VVML::fma(x, y, z); });
+    }
+    else {
+        if (std::is_constant_evaluated()) {
+            return map(a, b, c, [](auto x, auto y, auto z) {
+                __vml_no_contract;
+                return x * y + z;
+            });
+        }
+
+        using result_type =
+            vector<__vml_promote(T, U, V), Size, combine(O, P, Q)>;
+        using simd_type = __vml_get_simd_type<result_type>;
+
+        result_type result = __vml_load<result_type>(a);
+        simd_type::fma(result.__vec, __vml_load<result_type>(b).__vec,
+                       __vml_load<result_type>(c).__vec);
+
+        return result;
+    }
 }
 
 template <real_scalar T, real_scalar U = T, real_scalar V = T, size_t Size,
@@ -1103,6 +1398,14 @@ __vml_mathfunction __vml_always_inline __vml_interface_export constexpr vector<
 template <scalar T, size_t Size, vector_options O>
 __vml_mathfunction __vml_always_inline __vml_interface_export constexpr auto
     abs(vector<T, Size, O> const& a) {
+    using U = decltype(_VVML::__vml_abs(std::declval<T const&>()));
+    if constexpr (std::is_same_v<U, T>) {
+        if (!std::is_constant_evaluated()) {
+            vector<T, Size, O> result = a;
+            __vml_get_simd_type<vector<T, Size, O>>::abs(result.__vec);
+            return result;
+        }
+    }
     return a.map(_VVML::__vml_abs);
 }
 
@@ -1317,7 +1620,15 @@ __vml_mathfunction __vml_interface_export constexpr vector<bool, Size,
 template <typename T, size_t N, _VVML::vector_options O>
 class std::hash<_VVML::vector<T, N, O>> {
 public:
-    size_t operator()(_VVML::vector<T, N, O> const& v) const {
+    constexpr size_t operator()(_VVML::vector<T, N, O> const& v) const {
+        if constexpr (_VVML::__vml_hashable<T>) {
+            // Copy to skip the padding of aligned vectors
+            T data[N];
+            for (size_t i = 0; i < N; ++i) {
+                data[i] = v.__vml_at(i);
+            }
+            return size_t(_VVML::__vml_hash(data, N));
+        }
         size_t seed = _VVML::__vml_hash_seed;
         for (auto& i: v) {
             seed = _VVML::__vml_hash_combine(seed, i);
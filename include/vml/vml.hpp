@@ -1,11 +1,20 @@
 #ifndef __VML_VML_HPP_INCLUDED__
 #define __VML_VML_HPP_INCLUDED__
 
+#include "batch.hpp"
+#include "bvh.hpp"
 #include "complex.hpp"
+#include "encoding.hpp"
 #include "ext.hpp"
+#include "frustum.hpp"
+#include "half.hpp"
+#include "lazy.hpp"
 #include "matrix.hpp"
+#include "par.hpp"
 #include "quaternion.hpp"
 #include "shapes.hpp"
+#include "soa.hpp"
+#include "spatial_hash.hpp"
 #include "vector.hpp"
 
 #include "undef.hpp"
@@ -58,6 +67,21 @@
 // |                              |                 |        |  correctly. Disabling this will speed up these
 // |                              |                 |        |  operations.
 // +------------------------------+-----------------+--------+
+// | VML_DETERMINISTIC            |              0  |       0|  If enabled dot, norm, normalize, matrix and quaternion
+// |                              |              1  |        |  products give bit identical results for the scalar,
+// |                              |                 |        |  SSE, AVX and AVX-512 paths: sums have a fixed order,
+// |                              |                 |        |  products are not contracted to FMA and rsqrt
+// |                              |                 |        |  estimates are replaced by exact division. Batch
+// |                              |                 |        |  reductions use the same accumulator layout for every
+// |                              |                 |        |  instruction set. Parallel reductions combine chunks
+// |                              |                 |        |  in a fixed order regardless of this setting.
+// |                              |                 |        |  With GCC also compile with -ffp-contract=off and
+// |                              |                 |        |  define VML_FP_CONTRACT_OFF, or use the CMake option.
+// +------------------------------+-----------------+--------+
+// | VML_FP_CONTRACT_OFF          |              0  |       0|  Confirms that GCC compiles with -ffp-contract=off.
+// |                              |              1  |        |  VML_DETERMINISTIC fails to compile with GCC without
+// |                              |                 |        |  it, because GCC contracts to FMA by default.
+// +------------------------------+-----------------+--------+
 // | VML_DEFAULT_PACKED           |              0  |       0|  If enabled vectors and matrices use 'Packed' memory
 // |                              |              1  |        |  layout by default. Otherwise memory layout is 'Aligned'.
 // |                              |                 |        |  Regardless of what is specified here, the typedefs
@@ -65,6 +89,12 @@
 // |                              |                 |        |  can also be specified in the vector_options template
 // |                              |                 |        |  parameter.
 // +------------------------------+-----------------+--------+
+// | VML_RUNTIME_DISPATCH         |              0  |       0|  If enabled the batch kernels in "batch.hpp" are compiled
+// |                              |              1  |        |  for SSE2, AVX2 + FMA + F16C and AVX-512 and selected at
+// |                              |                 |        |  runtime depending on the host CPU. Otherwise only the
+// |                              |                 |        |  instruction set enabled by the compiler flags is used.
+// |                              |                 |        |  Small vector and matrix types are not affected.
+// +------------------------------+-----------------+--------+
 // | VML_NAMESPACE_NAME           |            Any  |     vml|  Change the name of the 'vml' namespace. Can be useful
 // |                              |                 |        |  to share code between C++ and shader header files.
 // +------------------------------+-----------------+--------+
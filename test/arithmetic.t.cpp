@@ -29,6 +29,59 @@ TEST_CASE("vector basic arithmetic", "[vector]") {
           vml::__vml_mul_by_i(complex_int{ 3, -2 }));
 }
 
+TEST_CASE("simd vector arithmetic", "[vector]") {
+    constexpr float4 a = { 1, -2, 3, -4 };
+    constexpr float4 b = { 0.5f, 4, -1, 2 };
+    CHECK(a + b == float4{ 1.5f, 2, 2, -2 });
+    CHECK(a - b == float4{ 0.5f, -6, 4, -6 });
+    CHECK(a / b == float4{ 2, -0.5f, -3, -2 });
+    CHECK(vml::min(a, b) == float4{ 0.5f, -2, -1, -4 });
+    CHECK(vml::max(a, b) == float4{ 1, 4, 3, 2 });
+    CHECK(vml::abs(a) == float4{ 1, 2, 3, 4 });
+    CHECK(vml::fma(a, b, a) == float4{ 1.5f, -10, 0, -12 });
+    CHECK(vml::dot(a, b) == -18.5f);
+    CHECK(vml::reverse(a) == float4{ -4, 3, -2, 1 });
+    CHECK(a != b);
+
+    constexpr int4 c = { 7, -8, 9, -10 };
+    constexpr int4 d = { 2, 3, -4, 5 };
+    CHECK(c + d == int4{ 9, -5, 5, -5 });
+    CHECK(c - d == int4{ 5, -11, 13, -15 });
+    CHECK(c * d == int4{ 14, -24, -36, -50 });
+    CHECK(c / d == int4{ 3, -2, -2, -2 });
+    CHECK(vml::min(c, d) == int4{ 2, -8, -4, -10 });
+    CHECK(vml::max(c, d) == int4{ 7, 3, 9, 5 });
+    CHECK(vml::abs(c) == int4{ 7, 8, 9, 10 });
+    CHECK(vml::dot(c, d) == -96);
+    CHECK(vml::reverse(c) == int4{ -10, 9, -8, 7 });
+
+    uint4 const e = { 1, 0x8000'0000, 3, 4 };
+    uint4 const f = { 2, 1, 0xffff'ffff, 4 };
+    CHECK(vml::min(e, f) == uint4{ 1, 1, 3, 4 });
+    CHECK(vml::max(e, f) == uint4{ 2, 0x8000'0000, 0xffff'ffff, 4 });
+    CHECK(e * f == uint4{ 2, 0x8000'0000, 0xffff'fffd, 16 });
+
+    double4 const g = { 1, 2, 3, 4 };
+    CHECK(g * g - g == double4{ 0, 2, 6, 12 });
+    CHECK(vml::dot(g, g) == 30);
+
+    static_assert(a + b == float4{ 1.5f, 2, 2, -2 });
+    static_assert(vml::min(c, d) == int4{ 2, -8, -4, -10 });
+    static_assert(vml::dot(c, d) == -96);
+}
+
+TEST_CASE("comparison of vectors wider than a mask", "[vector]") {
+    using float33 = vml::vector<float, 33>;
+    float33 const a([](size_t i) { return float(i); });
+    float33 b = a;
+    CHECK(a == b);
+    b[32] = -1;
+    CHECK(a != b);
+    b = a;
+    b[0] = -1;
+    CHECK(a != b);
+}
+
 TEST_CASE("matrix basic arithmetic", "[matrix]") {
     int2x2 const a = { 1, 2, 3, 4 };
     float2x2 const b = { 0.1f, 0.2f, 0.3f, 0.4f };
@@ -50,6 +103,19 @@ TEST_CASE("matrix multiplication", "[matrix]") {
     CHECK(b * A == int3{ 66, 78, 90 });
 }
 
+TEST_CASE("4x4 matrix multiplication", "[matrix]") {
+    constexpr float4x4 A = { 1, 2,  3,  4,  5,  6,  7,  8,
+                             9, 10, 11, 12, 13, 14, 15, 16 };
+    constexpr float4x4 B = { 2, 0, 1, -1, 0, 1, 3, 2, -2, 4, 0, 1, 1, 1, 1, 1 };
+    constexpr float4x4 C = A * B;
+    CHECK(A * B == C);
+    CHECK(C == float4x4{ 0, 18, 11, 10, 4, 42, 31, 22, 8, 66, 51, 34, 12, 90,
+                         71, 46 });
+    double4x4 const D = A;
+    CHECK(D * double4x4(B) == double4x4(C));
+    CHECK(A * float4x4(1) == A);
+}
+
 #define TYPE_LIST(_Tp, _Up)                                                    \
     (vml::quaternion<_Tp>, vml::quaternion<_Up>, 0),                           \
         (vml::quaternion<_Tp>, vml::complex<_Up>, 0),                          \
@@ -0,0 +1,350 @@
+#include <vml/vml.hpp>
+
+#include <array>
+#include <span>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "helpers.hpp"
+
+using namespace vml::short_types;
+
+TEST_CASE("batch arithmetic", "[batch]") {
+    vml_test::simd_level_guard const guard(
+        GENERATE(from_range(vml_test::simd_levels)));
+    /// Odd sizes to exercise the tails of every kernel width
+    size_t const count = GENERATE(1, 7, 33);
+    std::vector<float3> a(count), b(count), out(count);
+    for (size_t i = 0; i < count; ++i) {
+        a[i] = float3(float(i), -float(i), 1);
+        b[i] = float3(2, float(i + 1), -0.5f);
+    }
+    vml::batch::add(a, b, out);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(out[i] == a[i] + b[i]);
+    }
+    vml::batch::sub(a, b, out);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(out[i] == a[i] - b[i]);
+    }
+    vml::batch::mul(a, b, out);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(out[i] == a[i] * b[i]);
+    }
+    vml::batch::div(a, b, out);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(out[i] == a[i] / b[i]);
+    }
+    vml::batch::min(a, b, out);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(out[i] == vml::min(a[i], b[i]));
+    }
+    vml::batch::max(a, b, out);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(out[i] == vml::max(a[i], b[i]));
+    }
+    vml::batch::mul(a, 0.5f, out);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(out[i] == a[i] * 0.5f);
+    }
+    vml::batch::fma(a, 2.0f, b, out);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(out[i] == a[i] * 2.0f + b[i]);
+    }
+    /// In place
+    vml::batch::fma(a, b, b, b);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(b[i] == a[i] * float3(2, float(i + 1), -0.5f) +
+                          float3(2, float(i + 1), -0.5f));
+    }
+}
+
+TEST_CASE("batch arithmetic on scalars", "[batch]") {
+    std::array<double, 5> const a = { 1, 2, 3, 4, 5 };
+    std::array<double, 5> const b = { 5, 4, 3, 2, 1 };
+    std::array<double, 5> out;
+    vml::batch::fma(a, b, a, out);
+    CHECK(out == std::array<double, 5>{ 6, 10, 12, 12, 10 });
+    vml::batch::max(a, b, std::span(out));
+    CHECK(out == std::array<double, 5>{ 5, 4, 3, 4, 5 });
+}
+
+TEST_CASE("simd level", "[batch]") {
+    auto const previous = vml::active_simd_level();
+    {
+        vml_test::simd_level_guard const guard(vml::simd_level::sse2);
+        CHECK(vml::active_simd_level() == vml::simd_level::sse2);
+        vml::set_simd_level(vml::simd_level::avx512);
+        CHECK(vml::active_simd_level() == vml::__vml_detect_simd_level());
+    }
+    CHECK(vml::active_simd_level() == previous);
+}
+
+TEST_CASE("batch transforms", "[batch]") {
+    vml_test::simd_level_guard const guard(
+        GENERATE(from_range(vml_test::simd_levels)));
+    size_t const count = GENERATE(1, 8, 21);
+    float4x4 const affine = { 2, 0, 1, 3,  //
+                              0, 1, 0, -1, //
+                              1, 0, 3, 2,  //
+                              0, 0, 0, 1 };
+    float4x4 const projective = { 1, 0, 0, 0, //
+                                  0, 1, 0, 0, //
+                                  0, 0, 1, 0, //
+                                  0, 0, 1, 0 };
+    std::vector<float3> points(count), out(count);
+    std::vector<vml::packed_float3> packed(count), packed_out(count);
+    for (size_t i = 0; i < count; ++i) {
+        points[i] = float3(float(i), 1 - float(i), 2 + float(i));
+        packed[i] = points[i];
+    }
+    auto const homogeneous = [](float4x4 const& m, float3 p, float w) {
+        float4 const r = m * float4(p, w);
+        return w == 0 || r.w == 1 ? float3(r.xyz) : float3(r.xyz / r.w);
+    };
+
+    vml::transform_points(affine, points, out);
+    vml::transform_points(affine, packed, packed_out);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(out[i] == homogeneous(affine, points[i], 1));
+        CHECK(float3(packed_out[i]) == out[i]);
+    }
+    vml::transform_points(projective, std::span<float3 const>(points),
+                          std::span<float3>(out));
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(out[i] == vml::approx(homogeneous(projective, points[i], 1))
+                            .epsilon(1e-5f));
+    }
+    vml::transform_vectors(affine, points, out);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(out[i] == homogeneous(affine, points[i], 0));
+    }
+    /// In place
+    vml::transform_normals(affine, packed, packed);
+    float3x3 const normal_matrix =
+        vml::transpose(vml::inverse(float3x3(affine.row_swizzle(0, 1, 2)
+                                                 .column_swizzle(0, 1, 2))));
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(float3(packed[i]) ==
+              vml::approx(normal_matrix * points[i]).epsilon(1e-5f));
+    }
+}
+
+TEST_CASE("batch quaternions", "[batch]") {
+    vml_test::simd_level_guard const guard(
+        GENERATE(from_range(vml_test::simd_levels)));
+    size_t const count = GENERATE(1, 8, 21);
+    std::vector<quaternion_float> q(count), r(count), products(count);
+    std::vector<float3> v(count), out(count);
+    std::vector<vml::packed_float3> packed(count);
+    for (size_t i = 0; i < count; ++i) {
+        float const t = float(i);
+        q[i] = vml::make_rotation(0.3f * t, float3(1, t, 2 - t));
+        r[i] = vml::make_rotation(1 - 0.2f * t, float3(t, -1, 0.5f));
+        v[i] = float3(t, 1 - t, 2);
+    }
+    // Rotations are exact up to rounding
+    auto const error = [](auto const& a, auto const& b) {
+        return vml::max_norm(a - b);
+    };
+
+    vml::rotate(v, q[0], out);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(error(out[i], vml::rotate(v[i], q[0])) < 1e-4f);
+    }
+    vml::rotate(v, q, packed);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(error(float3(packed[i]), vml::rotate(v[i], q[i])) < 1e-4f);
+    }
+    // In place
+    vml::rotate(packed, std::span<quaternion_float const>(r), packed);
+    for (size_t i = 0; i < count; ++i) {
+        float3 const expected = vml::rotate(vml::rotate(v[i], q[i]), r[i]);
+        CHECK(error(float3(packed[i]), expected) < 1e-4f);
+    }
+
+    vml::multiply_quaternions(q, r, products);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(error(float4(products[i]), float4(q[i] * r[i])) < 1e-6f);
+    }
+
+    std::vector<float3x3> m3(count);
+    std::vector<vml::packed_float3x3> p3(count);
+    std::vector<float4x4> m4(count);
+    vml::rotation_matrices(q, m3);
+    vml::rotation_matrices(q, p3);
+    vml::rotation_matrices(q, m4);
+    for (size_t i = 0; i < count; ++i) {
+        float3 const expected = vml::rotate(v[i], q[i]);
+        CHECK(error(m3[i] * v[i], expected) < 1e-4f);
+        CHECK(error(float3x3(p3[i]) * v[i], expected) < 1e-4f);
+        CHECK(error(m4[i], vml::rotation(q[i])) < 1e-6f);
+    }
+}
+
+TEST_CASE("batch decompositions", "[batch]") {
+    vml_test::simd_level_guard const guard(
+        GENERATE(from_range(vml_test::simd_levels)));
+    size_t const count = GENERATE(1, 8, 21);
+    std::vector<float3x3> m(count), symmetric(count), a(count), b(count);
+    std::vector<vml::packed_float3x3> packed(count), pa(count), pb(count);
+    std::vector<float3> values(count);
+    std::vector<double3x3> md(count), ad(count), bd(count);
+    std::vector<vml::packed_double3> sigma(count);
+    for (size_t i = 0; i < count; ++i) {
+        float const t = float(i);
+        m[i] = { 1 + t, 2 - t, 0.5f, t, -1, 3, 2, t * t / 8, 1 - t };
+        if (i % 4 == 3) {
+            // Rank deficient
+            m[i].set_row(2, m[i].row(0) + m[i].row(1));
+        }
+        symmetric[i] = m[i] + vml::transpose(m[i]);
+        packed[i] = m[i];
+        md[i] = vml::type_cast<double>(m[i]);
+    }
+    // Results of the same math up to rounding. Compared to the scalar
+    // decomposition the results may differ by sign, so the products are
+    // checked.
+    auto const error = [](auto const& x, auto const& y) {
+        return vml::max_norm(x - y) / std::max(1.0f, float(vml::max_norm(y)));
+    };
+
+    vml::eigen_symmetric(symmetric, values, a);
+    for (size_t i = 0; i < count; ++i) {
+        auto const expected = vml::eigen_symmetric(symmetric[i]);
+        CHECK(error(values[i], expected.values) < 1e-5f);
+        CHECK(error(a[i] * float3x3::diag(values[i]) * vml::transpose(a[i]),
+                    symmetric[i]) < 1e-5f);
+    }
+
+    vml::svd(md, ad, sigma, bd);
+    vml::svd(packed, pa, std::span(values), pb);
+    for (size_t i = 0; i < count; ++i) {
+        auto const expected = vml::svd(md[i]);
+        CHECK(error(double3(sigma[i]), expected.sigma) < 1e-12);
+        CHECK(error(ad[i] * double3x3::diag(double3(sigma[i])) *
+                        vml::transpose(bd[i]),
+                    md[i]) < 1e-12);
+        CHECK(error(float3x3(pa[i]) * float3x3::diag(values[i]) *
+                        vml::transpose(float3x3(pb[i])),
+                    m[i]) < 1e-5f);
+        CHECK(std::abs(vml::det(float3x3(pa[i])) - 1) < 1e-5f);
+        CHECK(std::abs(vml::det(bd[i]) - 1) < 1e-12);
+    }
+
+    // In place
+    b = m;
+    vml::polar_decompose(b, b, a);
+    for (size_t i = 0; i < count; ++i) {
+        auto const expected = vml::polar_decompose(m[i]);
+        CHECK(error(b[i] * a[i], m[i]) < 1e-5f);
+        CHECK(error(b[i], expected.rotation) < 1e-4f);
+        CHECK(error(a[i], vml::transpose(a[i])) < 1e-5f);
+    }
+}
+
+TEST_CASE("normalize_approx", "[batch]") {
+    using enum vml::normalize_precision;
+    float4 const v = { 3, -4, 12, 0.5f };
+    float4 const n = vml::normalize(v);
+    CHECK(vml::normalize_approx<exact>(v) == n);
+    CHECK(vml::normalize_approx<fast>(v) == vml::approx(n).epsilon(1e-6f));
+    CHECK(vml::normalize_approx(v) == vml::approx(n).epsilon(1e-6f));
+    CHECK(vml::normalize_approx<rsqrt>(v) == vml::approx(n).epsilon(1e-3f));
+    CHECK(vml::normalize_approx<rsqrt>(double3(1, 2, 2)) ==
+          vml::approx(double3(1, 2, 2) / 3));
+
+    vml_test::simd_level_guard const guard(
+        GENERATE(from_range(vml_test::simd_levels)));
+    size_t const count = GENERATE(1, 8, 21);
+    std::vector<float3> normals(count), out(count);
+    std::vector<float4> tangents(count);
+    std::vector<vml::packed_double3> packed(count);
+    for (size_t i = 0; i < count; ++i) {
+        normals[i] = float3(float(i) + 0.5f, 1 - float(i), 2);
+        tangents[i] = float4(normals[i], -float(i));
+        packed[i] = double3(normals[i]);
+    }
+    vml::normalize_approx<rsqrt>(normals, out);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(out[i] ==
+              vml::approx(vml::normalize(normals[i])).epsilon(1e-3f));
+    }
+    vml::normalize_approx<fast>(normals, out);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(out[i] ==
+              vml::approx(vml::normalize(normals[i])).epsilon(1e-6f));
+    }
+    /// In place
+    auto const expected = tangents;
+    vml::normalize_approx(tangents, tangents);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(tangents[i] ==
+              vml::approx(vml::normalize(expected[i])).epsilon(1e-6f));
+    }
+    vml::normalize_approx<exact>(std::span(packed), packed);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(double3(packed[i]) ==
+              vml::approx(vml::normalize(double3(normals[i]))));
+    }
+}
+
+TEST_CASE("batch compensated reductions", "[batch]") {
+    vml_test::simd_level_guard const guard(
+        GENERATE(from_range(vml_test::simd_levels)));
+    /// Every component sees `1e8, 1, -1e8` in turn, a plain sum loses the
+    /// ones
+    size_t const count = GENERATE(3, 21, 333);
+    std::vector<float3> a(count), ones(count, float3(1));
+    std::vector<vml::packed_float3> packed(count);
+    std::vector<double> scalars(count);
+    for (size_t i = 0; i < count; ++i) {
+        a[i] = float3([&](size_t k) {
+            size_t const j = (i + k) % 3;
+            return j == 0 ? 1e8f : j == 1 ? 1.0f : -1e8f;
+        });
+        packed[i] = a[i];
+        scalars[i] = a[i].x * 1e10;
+    }
+    float const third = float(count / 3);
+    CHECK(vml::batch::sum_compensated(a) == float3(third));
+    CHECK(vml::batch::sum_compensated(packed) ==
+          vml::packed_float3(third));
+    CHECK(vml::batch::sum_compensated(scalars) == third * 1e10);
+    CHECK(vml::batch::dot_compensated(a, ones) == float(count));
+    /// `x^2 + y^2 = 1 + 2^-11 + 2^-23` has bits below the precision of
+    /// `x^2`
+    std::vector<float2> v(8, float2(1 + 0x1p-12f, 0x1p-12f));
+    CHECK(vml::batch::norm_squared_compensated(v) == 8 + 0x1p-8f + 0x1p-20f);
+}
+
+TEST_CASE("hash_many", "[batch]") {
+    vml_test::simd_level_guard const guard(
+        GENERATE(from_range(vml_test::simd_levels)));
+    size_t const count = GENERATE(1, 7, 33);
+    std::vector<int3> voxels(count);
+    std::vector<vml::packed_double3> points(count);
+    std::vector<vml::vector<std::uint8_t, 5>> bytes(count);
+    for (size_t i = 0; i < count; ++i) {
+        int const k = int(i);
+        voxels[i] = { k, -k, k * k };
+        points[i] = { 0.5 * k, -0.0, double(k) };
+        bytes[i] = { std::uint8_t(k), 1, 2, 3, std::uint8_t(255 - k) };
+    }
+    std::vector<size_t> hashes(count);
+    vml::hash_many(voxels, hashes);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(hashes[i] == std::hash<int3>{}(voxels[i]));
+    }
+    vml::hash_many(std::span(points), hashes);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(hashes[i] == std::hash<vml::packed_double3>{}(points[i]));
+    }
+    vml::hash_many(bytes, hashes);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(hashes[i] ==
+              std::hash<vml::vector<std::uint8_t, 5>>{}(bytes[i]));
+    }
+}
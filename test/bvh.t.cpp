@@ -0,0 +1,159 @@
+#include <vml/vml.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "helpers.hpp"
+
+using namespace vml::short_types;
+
+namespace {
+
+using box = vml::AABB<float, 3>;
+
+template <typename Query>
+std::set<size_t> collect(vml::bvh<float> const& h, Query const& q) {
+    std::set<size_t> result;
+    h.query(q, [&](size_t i) { CHECK(result.insert(i).second); });
+    return result;
+}
+
+float box_distance_squared(box const& b, float3 p) {
+    return vml::distance_squared(p,
+                                 vml::clamp(p, b.lower_bound(),
+                                            b.upper_bound()));
+}
+
+/// Ray parameter where the ray enters \p b, infinity if it misses
+float ray_box(box const& b, float3 o, float3 d) {
+    float enter = 0, exit = std::numeric_limits<float>::infinity();
+    for (size_t k = 0; k < 3; ++k) {
+        float const t0 = (b.lower_bound()[k] - o[k]) / d[k];
+        float const t1 = (b.upper_bound()[k] - o[k]) / d[k];
+        enter = std::max(enter, std::min(t0, t1));
+        exit = std::min(exit, std::max(t0, t1));
+    }
+    return enter <= exit ? enter : std::numeric_limits<float>::infinity();
+}
+
+} // namespace
+
+static_assert(sizeof(vml::bvh<float>::node) == 32);
+
+TEST_CASE("bvh queries", "[bvh]") {
+    auto const method =
+        GENERATE(vml::bvh_build::sah, vml::bvh_build::binned_sah);
+    std::vector<box> const boxes = vml_test::random_boxes(500);
+    vml::bvh<float> const h(boxes, method);
+    REQUIRE(h.size() == boxes.size());
+    CHECK(h.nodes().size() < 2 * boxes.size());
+    CHECK(vml::encloses(h.bounds(), boxes[17]));
+
+    SECTION("box") {
+        box const q(float3(20, 30, 40), float3(45, 50, 60));
+        std::set<size_t> expected;
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            if (vml::do_intersect(q, boxes[i])) {
+                expected.insert(i);
+            }
+        }
+        CHECK(!expected.empty());
+        CHECK(collect(h, q) == expected);
+    }
+    SECTION("sphere") {
+        vml::sphere<float> const q({ 50, 50, 50 }, 15);
+        std::set<size_t> expected;
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            if (box_distance_squared(boxes[i], float3(50)) <= 15 * 15) {
+                expected.insert(i);
+            }
+        }
+        CHECK(!expected.empty());
+        CHECK(collect(h, q) == expected);
+    }
+    SECTION("point") {
+        float3 const p =
+            (boxes[42].lower_bound() + boxes[42].upper_bound()) / 2;
+        std::set<size_t> const found = collect(h, p);
+        CHECK(found.contains(42));
+        for (size_t i: found) {
+            CHECK(vml::do_intersect(boxes[i], p));
+        }
+    }
+    SECTION("overlapping pairs") {
+        std::set<std::pair<size_t, size_t>> expected, found;
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            for (size_t j = i + 1; j < boxes.size(); ++j) {
+                if (vml::do_intersect(boxes[i], boxes[j])) {
+                    expected.insert({ i, j });
+                }
+            }
+        }
+        h.overlapping_pairs([&](size_t i, size_t j) {
+            CHECK(found.insert({ i, j }).second);
+        });
+        CHECK(found == expected);
+    }
+    SECTION("nearest") {
+        float3 const p(-10, 50, 120);
+        auto const hit = h.nearest(p);
+        REQUIRE(hit);
+        float best = std::numeric_limits<float>::infinity();
+        for (box const& b: boxes) {
+            best = std::min(best, box_distance_squared(b, p));
+        }
+        CHECK(hit->distance == Catch::Approx(std::sqrt(best)));
+        CHECK(box_distance_squared(boxes[hit->index], p) == best);
+    }
+    SECTION("ray") {
+        float3 const o(-5, 3, 7);
+        float3 const d = vml::normalize(float3(1, 0.5f, 0.4f));
+        auto const intersect = [&](size_t i) {
+            return ray_box(boxes[i], o, d);
+        };
+        auto const hit = h.intersect_ray(o, d, 1000.0f, intersect);
+        float best = std::numeric_limits<float>::infinity();
+        size_t index = 0;
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            if (float const t = intersect(i); t < best) {
+                best = t;
+                index = i;
+            }
+        }
+        REQUIRE(hit);
+        CHECK(hit->index == index);
+        CHECK(hit->distance == best);
+        CHECK(!h.intersect_ray(o, d, best / 2, intersect));
+        auto const ray_hit =
+            h.intersect_ray(vml::ray<float>(o, d), 1000.0f, intersect);
+        REQUIRE(ray_hit);
+        CHECK(ray_hit->index == index);
+        CHECK(ray_hit->distance == best);
+        CHECK(!h.intersect_ray(vml::ray<float>(o, d), best / 2, intersect));
+    }
+}
+
+TEST_CASE("bvh over triangles", "[bvh]") {
+    std::vector<vml::triangle<float>> triangles(64);
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        float const x = float(i % 8), y = float(i / 8);
+        triangles[i][0] = float3(x, y, 0);
+        triangles[i][1] = float3(x + 1, y, 0);
+        triangles[i][2] = float3(x, y + 1, 1);
+    }
+    vml::bvh<float> const h(triangles);
+    CHECK(h.bounds() == box(float3(0, 0, 0), float3(8, 8, 1)));
+    std::set<size_t> found;
+    h.query(float3(2.5f, 3.25f, 0.5f), [&](size_t i) { found.insert(i); });
+    CHECK(found == std::set<size_t>{ 26 });
+    CHECK(vml::bvh<float>().empty());
+    CHECK(!vml::bvh<float>().nearest(float3(0)));
+}
@@ -0,0 +1,135 @@
+# Verifies the CHECK-${CONFIG} comments in ${SOURCE} against the assembly in
+# ${ASM}. See kernels.cpp for the syntax.
+#
+#   cmake -DSOURCE=kernels.cpp -DASM=kernels.O2.s -DCONFIG=O2 -P check.cmake
+
+cmake_minimum_required(VERSION 3.23)
+
+foreach(var SOURCE ASM CONFIG)
+  if(NOT DEFINED ${var})
+    message(FATAL_ERROR "${var} is not defined")
+  endif()
+endforeach()
+
+file(STRINGS ${SOURCE} directives REGEX "^// CHECK-${CONFIG}: ")
+if(NOT directives)
+  message(FATAL_ERROR "No CHECK-${CONFIG} directives in ${SOURCE}")
+endif()
+file(READ ${ASM} asm)
+# Comments may contain characters that CMake lists do not tolerate
+string(REGEX REPLACE "[#;][^\n]*" "" asm "${asm}")
+string(REPLACE "[" "<" asm "${asm}")
+string(REPLACE "]" ">" asm "${asm}")
+
+# Mach-O prefixes symbols with an underscore, its local labels start with `L`.
+# ELF local labels start with `.L`, an `L` there may start a function name.
+if(asm MATCHES "\n_vml_codegen_")
+  set(local_label "^(\\.L|L)")
+else()
+  set(local_label "^\\.L")
+endif()
+
+# Sets `${out}` to the instructions of the function `vml_codegen_${name}`
+function(get_instructions name out)
+  string(FIND "${asm}" "\nvml_codegen_${name}:" begin)
+  if(begin EQUAL -1)
+    # Mach-O prefixes symbols with an underscore
+    string(FIND "${asm}" "\n_vml_codegen_${name}:" begin)
+  endif()
+  if(begin EQUAL -1)
+    set(${out} NOTFOUND PARENT_SCOPE)
+    return()
+  endif()
+  string(SUBSTRING "${asm}" ${begin} -1 body)
+  string(FIND "${body}" ".cfi_endproc" end)
+  string(SUBSTRING "${body}" 0 ${end} body)
+  string(REPLACE "\n" ";" lines "${body}")
+  set(result)
+  foreach(line IN LISTS lines)
+    if(line MATCHES "^[ \t]+[a-z]")
+      string(STRIP "${line}" line)
+      string(REGEX REPLACE "[ \t]+" " " line "${line}")
+      list(APPEND result "${line}")
+    endif()
+  endforeach()
+  set(${out} "${result}" PARENT_SCOPE)
+endfunction()
+
+set(failures 0)
+foreach(directive IN LISTS directives)
+  if(NOT directive MATCHES
+     "^// CHECK-${CONFIG}: ([A-Za-z0-9_]+): ([a-z-]+) ?(.*)$")
+    message(FATAL_ERROR "Malformed directive: ${directive}")
+  endif()
+  set(name ${CMAKE_MATCH_1})
+  set(check ${CMAKE_MATCH_2})
+  separate_arguments(args UNIX_COMMAND "${CMAKE_MATCH_3}")
+  get_instructions(${name} instructions)
+  if(NOT instructions)
+    message(SEND_ERROR "vml_codegen_${name} not found in ${ASM}")
+    math(EXPR failures "${failures} + 1")
+    continue()
+  endif()
+
+  set(calls)
+  foreach(instruction IN LISTS instructions)
+    # Every call, and every jump that does not target a local label: direct,
+    # conditional and indirect tail calls
+    if(instruction MATCHES "^(call[a-z]*|j[a-z]+) (.*)$")
+      set(opcode "${CMAKE_MATCH_1}")
+      set(target "${CMAKE_MATCH_2}")
+      if(opcode MATCHES "^call" OR NOT target MATCHES "${local_label}")
+        list(APPEND calls "${instruction}")
+      endif()
+    endif()
+  endforeach()
+
+  set(error)
+  if(check STREQUAL "no-calls")
+    if(calls)
+      set(error "calls other functions")
+    endif()
+  elseif(check STREQUAL "no-call-to")
+    foreach(call IN LISTS calls)
+      if(call MATCHES " _?${args}")
+        set(error "calls a function matching ${args}")
+      endif()
+    endforeach()
+  elseif(check STREQUAL "max-instructions")
+    list(LENGTH instructions count)
+    if(count GREATER args)
+      set(error "has ${count} instructions, expected at most ${args}")
+    endif()
+  elseif(check STREQUAL "count" OR check STREQUAL "contains")
+    list(GET args 0 mnemonic)
+    set(count 0)
+    foreach(instruction IN LISTS instructions)
+      if(instruction MATCHES "^${mnemonic}( |$)")
+        math(EXPR count "${count} + 1")
+      endif()
+    endforeach()
+    if(check STREQUAL "contains" AND count EQUAL 0)
+      set(error "contains no ${mnemonic}")
+    elseif(check STREQUAL "count")
+      list(GET args 1 expected)
+      if(NOT count EQUAL expected)
+        set(error "contains ${count} ${mnemonic}, expected ${expected}")
+      endif()
+    endif()
+  else()
+    message(FATAL_ERROR "Unknown check: ${directive}")
+  endif()
+
+  if(error)
+    list(JOIN instructions "\n    " listing)
+    message(SEND_ERROR
+      "vml_codegen_${name} ${error} (${CONFIG}):\n    ${listing}")
+    math(EXPR failures "${failures} + 1")
+  endif()
+endforeach()
+
+list(LENGTH directives total)
+if(failures GREATER 0)
+  message(FATAL_ERROR "${failures} of ${total} codegen checks failed")
+endif()
+message(STATUS "${total} codegen checks passed")
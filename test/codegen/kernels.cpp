@@ -0,0 +1,85 @@
+#include <vml/vml.hpp>
+
+/// Kernels compiled to assembly by the `codegen` test. Every kernel is
+/// exported as `vml_codegen_<name>`. The `CHECK-<config>` comments are read by
+/// `check.cmake` and verified against the assembly of the configuration
+/// (`O0` or `O2`):
+///
+///     // CHECK-O2: <name>: no-calls
+///     // CHECK-O2: <name>: max-instructions <n>
+///     // CHECK-O2: <name>: count <mnemonic> <n>
+///     // CHECK-O2: <name>: contains <mnemonic>
+///     // CHECK-O0: <name>: no-call-to <symbol regex>
+///
+/// The checks target x86-64 without any `-m` flags, i.e. SSE2.
+
+using namespace vml::short_types;
+
+extern "C" {
+
+// CHECK-O2: dot_float4: no-calls
+// CHECK-O2: dot_float4: max-instructions 10
+// CHECK-O0: dot_float4: no-call-to _ZN3vml3dotI
+// CHECK-O0: dot_float4: no-call-to _ZN3vml10__vml_loadI
+float vml_codegen_dot_float4(float4 const& a, float4 const& b) {
+    return vml::dot(a, b);
+}
+
+// CHECK-O2: dot_float3: no-calls
+// CHECK-O2: dot_float3: max-instructions 10
+float vml_codegen_dot_float3(float3 const& a, float3 const& b) {
+    return vml::dot(a, b);
+}
+
+// CHECK-O2: add_float3: no-calls
+// CHECK-O2: add_float3: count addps 1
+// CHECK-O2: add_float3: count addss 0
+// CHECK-O0: add_float3: no-call-to _ZN3vmlplI
+void vml_codegen_add_float3(float3 const& a, float3 const& b, float3& result) {
+    result = a + b;
+}
+
+// CHECK-O2: add_float4: no-calls
+// CHECK-O2: add_float4: count addps 1
+// CHECK-O0: add_float4: no-call-to _ZN3vmlplI
+// CHECK-O0: add_float4: no-call-to _ZN3vml10__vml_loadI
+void vml_codegen_add_float4(float4 const& a, float4 const& b, float4& result) {
+    result = a + b;
+}
+
+// CHECK-O2: mul_float4_scalar: no-calls
+// CHECK-O2: mul_float4_scalar: count mulps 1
+void vml_codegen_mul_float4_scalar(float4 const& a, float b, float4& result) {
+    result = a * b;
+}
+
+// CHECK-O2: fma_float4: no-calls
+// CHECK-O2: fma_float4: max-instructions 6
+void vml_codegen_fma_float4(float4 const& a, float4 const& b,
+                            float4 const& c, float4& result) {
+    result = vml::fma(a, b, c);
+}
+
+// CHECK-O2: min_float4: no-calls
+// CHECK-O2: min_float4: count minps 1
+void vml_codegen_min_float4(float4 const& a, float4 const& b,
+                            float4& result) {
+    result = vml::min(a, b);
+}
+
+// CHECK-O2: normalize_approx_float4: no-calls
+// CHECK-O2: normalize_approx_float4: count rsqrtss 1
+// CHECK-O2: normalize_approx_float4: count sqrtss 0
+// CHECK-O2: normalize_approx_float4: count divps 0
+void vml_codegen_normalize_approx_float4(float4 const& a, float4& result) {
+    result = vml::normalize_approx(a);
+}
+
+// CHECK-O2: mul_float4x4: no-calls
+// CHECK-O2: mul_float4x4: contains mulps
+void vml_codegen_mul_float4x4(float4x4 const& a, float4x4 const& b,
+                              float4x4& result) {
+    result = a * b;
+}
+
+} // extern "C"
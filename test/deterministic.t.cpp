@@ -0,0 +1,109 @@
+#include <vml/vml.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "helpers.hpp"
+
+/// This file is built into the `test_deterministic` executable with
+/// `VML_DETERMINISTIC` enabled. Constant evaluation takes the scalar paths,
+/// so results computed at compile time are the reference for the SIMD paths.
+
+using namespace vml::short_types;
+
+static_assert(VML_DETERMINISTIC);
+
+namespace {
+
+/// Bitwise equality, also for NaN and signed zeros
+template <typename T>
+bool same_bits(T const& a, T const& b) {
+    return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+/// Aligned 3-vectors have an unspecified padding lane
+template <size_t Size, vml::vector_options O>
+bool same_bits(vml::vector<float, Size, O> const& a,
+               vml::vector<float, Size, O> const& b) {
+    for (size_t i = 0; i < Size; ++i) {
+        if (!same_bits(a[i], b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("deterministic vector and matrix math", "[deterministic]") {
+    /// Variables without `constexpr` are evaluated by the runtime paths
+    constexpr float4 a = { 0.1f, -1.3f, 2.7f, 1e-3f };
+    constexpr float4 b = { 3.3f, 0.7f, -0.9f, 1e4f };
+    constexpr float dot4 = vml::dot(a, b);
+    CHECK(same_bits(vml::dot(a, b), dot4));
+    constexpr float3 c = { 0.3f, 1.1f, -7.9f };
+    constexpr float dot3 = vml::dot(c, c);
+    CHECK(same_bits(vml::dot(c, c), dot3));
+    CHECK(same_bits(vml::norm(c), std::sqrt(dot3)));
+    CHECK(same_bits(vml::normalize(c), c / std::sqrt(dot3)));
+    using enum vml::normalize_precision;
+    CHECK(same_bits(vml::normalize_approx<rsqrt>(c),
+                    c * (1 / std::sqrt(dot3))));
+
+    constexpr float4x4 A = { 0.1f, 2,    -3.7f, 4,    5, 0.6f, 7,   -8.1f,
+                             9,    1e3f, 11,    0.12f, 13, -14, 1.5f, 16 };
+    constexpr float4x4 B = { 2.2f, 0, 1, -1.3f, 0, 1, 3, 0.2f,
+                             -2,   4, 0, 1e-2f, 1, 1, 1, 1.7f };
+    constexpr float4x4 C = A * B;
+    CHECK(same_bits(A * B, C));
+    constexpr float4 Ab = A * b;
+    CHECK(same_bits(A * b, Ab));
+
+    constexpr quaternion_float q = { 0.5f, -0.1f, 0.7f, 1.3f };
+    constexpr quaternion_float r = { 1.1f, 0.3f, -2.1f, 0.01f };
+    constexpr quaternion_float qr = q * r;
+    CHECK(same_bits(q * r, qr));
+}
+
+TEST_CASE("deterministic batch kernels", "[deterministic]") {
+    size_t const count = 1001;
+    std::vector<float3> v(count), normalized(count);
+    std::vector<float> scalars(3 * count);
+    std::vector<quaternion_float> q(count), r(count), products(count);
+    for (size_t i = 0; i < count; ++i) {
+        float const t = float(i) * 0.37f;
+        v[i] = float3(std::sin(t) * 1e3f, std::cos(t), t);
+        scalars[3 * i] = v[i].x;
+        scalars[3 * i + 1] = v[i].y;
+        scalars[3 * i + 2] = v[i].z;
+        q[i] = quaternion_float(std::cos(t), std::sin(t), t, 1);
+        r[i] = quaternion_float(t, -1, std::sin(t), 0.5f);
+    }
+    vml_test::simd_level_guard const guard(vml::simd_level::sse2);
+    float3 const sum = vml::batch::sum_compensated(v);
+    float const flat_sum = vml::batch::sum_compensated(scalars);
+    float const dot = vml::batch::dot_compensated(v, v);
+    vml::multiply_quaternions(q, r, products);
+    auto const expected_products = products;
+    for (auto level: { vml::simd_level::avx2, vml::simd_level::avx512 }) {
+        vml::set_simd_level(level);
+        CHECK(same_bits(vml::batch::sum_compensated(v), sum));
+        CHECK(same_bits(vml::batch::sum_compensated(scalars), flat_sum));
+        CHECK(same_bits(vml::batch::dot_compensated(v, v), dot));
+        vml::multiply_quaternions(q, r, products);
+        CHECK(std::memcmp(products.data(), expected_products.data(),
+                          count * sizeof(quaternion_float)) == 0);
+    }
+    for (auto level: vml_test::simd_levels) {
+        vml::set_simd_level(level);
+        vml::normalize_approx(v, normalized);
+        size_t wrong = 0;
+        for (size_t i = 0; i < count; ++i) {
+            wrong += !same_bits(normalized[i], vml::normalize_approx(v[i]));
+        }
+        CHECK(wrong == 0);
+    }
+}
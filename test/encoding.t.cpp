@@ -0,0 +1,130 @@
+#include <vml/vml.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "helpers.hpp"
+
+using namespace vml::short_types;
+
+namespace {
+
+/// Evenly distributed points on the unit sphere, including the poles
+std::vector<float3> sphere_points(size_t count) {
+    std::vector<float3> result = { { 0, 0, 1 },  { 0, 0, -1 }, { 1, 0, 0 },
+                                   { -1, 0, 0 }, { 0, 1, 0 },  { 0, -1, 0 } };
+    float const golden = vml::constants<float>::pi * (3 - std::sqrt(5.0f));
+    for (size_t i = 0; i < count; ++i) {
+        float const z = 1 - 2 * (float(i) + 0.5f) / float(count);
+        float const r = std::sqrt(1 - z * z);
+        float const phi = golden * float(i);
+        result.push_back({ r * std::cos(phi), r * std::sin(phi), z });
+    }
+    return result;
+}
+
+std::vector<quaternion_float> rotations(size_t count) {
+    std::vector<quaternion_float> result = { { 1, 0, 0, 0 },
+                                             { 0, 0, 0, -1 },
+                                             { 0.5f, -0.5f, 0.5f, -0.5f } };
+    for (float3 const& axis: sphere_points(count)) {
+        float const angle = 7 * float(result.size());
+        result.push_back(vml::make_rotation(angle, axis));
+    }
+    return result;
+}
+
+/// Angle between unit vectors in degrees
+float angle(float3 a, float3 b) {
+    return std::acos(std::min(vml::dot(a, b), 1.0f)) * 180 /
+           vml::constants<float>::pi;
+}
+
+/// Largest component error of \p b relative to \p a or `-a`
+float rotation_error(quaternion_float a, quaternion_float b) {
+    float const s = vml::dot(float4(a), float4(b)) < 0 ? -1 : 1;
+    return vml::max_norm(float4(a) - s * float4(b));
+}
+
+} // namespace
+
+TEST_CASE("octahedral encoding", "[encoding]") {
+    float max8 = 0, max16 = 0;
+    for (float3 const& n: sphere_points(2000)) {
+        auto const code8 = vml::encode_octahedral<8>(n);
+        max8 = std::max(max8, angle(n, vml::decode_octahedral(code8)));
+        max16 = std::max(max16, angle(n, vml::decode_octahedral(
+                                             vml::encode_octahedral(n))));
+    }
+    CHECK(max8 < 1.0f);
+    CHECK(max16 < 0.05f);
+    CHECK(vml::encode_octahedral(float3(0, 0, 1)) == octahedral16(32768));
+    CHECK(vml::decode_octahedral(octahedral8(0, 0)) == float3(0, 0, -1));
+    static_assert(sizeof(octahedral16) == 4 && sizeof(octahedral8) == 2);
+}
+
+TEST_CASE("smallest three encoding", "[encoding]") {
+    float max32 = 0, max48 = 0;
+    for (quaternion_float const& q: rotations(500)) {
+        auto const q32 =
+            vml::decode_smallest_three(vml::encode_smallest_three(q));
+        auto const q48 =
+            vml::decode_smallest_three(vml::encode_smallest_three<48>(q));
+        max32 = std::max(max32, rotation_error(q, q32));
+        max48 = std::max(max48, rotation_error(q, q48));
+    }
+    CHECK(max32 < 2e-3f);
+    CHECK(max48 < 1e-4f);
+    // The dropped component is stored in the top two bits
+    CHECK(vml::encode_smallest_three(quaternion_float(0, 0, 0, -1)) >> 30 == 3);
+    static_assert(sizeof(smallest_three48) == 6);
+}
+
+TEST_CASE("batch encodings", "[encoding][batch]") {
+    vml_test::simd_level_guard const guard(
+        GENERATE(from_range(vml_test::simd_levels)));
+    size_t const count = GENERATE(1, 7, 40);
+
+    auto normals = sphere_points(count);
+    normals.resize(count);
+    std::vector<octahedral16> codes16(count);
+    std::vector<octahedral8> codes8(count);
+    std::vector<packed_float3> decoded(count);
+    vml::batch::encode_octahedral(normals, codes16);
+    vml::batch::encode_octahedral(normals, codes8);
+    // FMA contraction may differ from the scalar code by one step
+    for (size_t i = 0; i < count; ++i) {
+        auto const expected = vml::encode_octahedral(normals[i]);
+        CHECK(vml::max_norm(int2(codes16[i]) - int2(expected)) <= 1);
+    }
+    vml::batch::decode_octahedral(codes16, decoded);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(angle(normals[i], decoded[i]) < 0.05f);
+    }
+    vml::batch::decode_octahedral(codes8, decoded);
+    for (size_t i = 0; i < count; ++i) {
+        auto const expected = vml::decode_octahedral(codes8[i]);
+        CHECK(vml::max_norm(float3(decoded[i]) - expected) < 1e-5f);
+    }
+
+    auto quaternions = rotations(count);
+    quaternions.resize(count);
+    std::vector<smallest_three32> codes32(count);
+    std::vector<smallest_three48> codes48(count);
+    std::vector<quaternion_float> restored(count);
+    vml::batch::encode_smallest_three(quaternions, codes32);
+    vml::batch::decode_smallest_three(codes32, restored);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(codes32[i] >> 30 ==
+              vml::encode_smallest_three(quaternions[i]) >> 30);
+        CHECK(rotation_error(quaternions[i], restored[i]) < 2e-3f);
+    }
+    vml::batch::encode_smallest_three(quaternions, codes48);
+    vml::batch::decode_smallest_three(codes48, restored);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(rotation_error(quaternions[i], restored[i]) < 1e-4f);
+    }
+}
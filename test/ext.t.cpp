@@ -113,6 +113,37 @@ TEST_CASE("matrix inverse") {
 
         CHECK(A * I == vml::approx(ldouble2x2(1)).epsilon(0.00000000001));
     }
+
+    SECTION("4x4 simd") {
+        constexpr float4x4 A = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 1, 2, 3, 0, 5, 6 };
+        constexpr float4x4 ref = vml::inverse(A);
+        float4x4 const I = vml::inverse(A);
+        CHECK(I == vml::approx(ref).epsilon(0.0001));
+        CHECK(A * I == vml::approx(float4x4(1)).epsilon(0.0001));
+
+        double4x4 const B = vml::type_cast<double>(A);
+        CHECK(B * vml::inverse(B) ==
+              vml::approx(double4x4(1)).epsilon(0.00000000001));
+    }
+
+    SECTION("affine") {
+        constexpr float4x4 A = { 2, 1, 0, 4, 0, 3, 1, -1, 1, 0, 1, 2, 0, 0, 0, 1 };
+        constexpr float4x4 ref = vml::inverse(A);
+        float4x4 const I = vml::affine_inverse(A);
+        CHECK(I.row(3) == float4(0, 0, 0, 1));
+        CHECK(I == vml::approx(ref).epsilon(0.0001));
+        CHECK(vml::affine_inverse(vml::type_cast<int>(A)) ==
+              vml::approx(vml::type_cast<double>(ref)).epsilon(0.0001));
+    }
+
+    SECTION("rigid") {
+        float4x4 const A = vml::translation(float3(1, -2, 3)) *
+                           vml::rotation(vml::to_quaternion(0.3f, 1.1f, -0.7f));
+        CHECK(vml::rigid_inverse(A) ==
+              vml::approx(vml::inverse(A)).epsilon(0.0001));
+        CHECK(A * vml::rigid_inverse(A) ==
+              vml::approx(float4x4(1)).epsilon(0.0001));
+    }
 }
 
 TEST_CASE("submatrix") {
@@ -125,6 +156,109 @@ TEST_CASE("matrix determinant", "[matrix]") {
     CHECK(vml::det(A) == 160);
 }
 
+TEST_CASE("LU decomposition", "[matrix]") {
+    using int6x6 = vml::matrix<int, 6, 6>;
+    using double6x6 = vml::matrix<double, 6, 6>;
+    constexpr int6x6 A = { 2,  -1, 0, 3,  1, 4,  1, 5, 2, 0, -2, 1,
+                           0,  3,  -4, 1, 2, 2,  6, 1, 1, -1, 0, 3,
+                           -3, 2,  0,  4, 5, -1, 1, 0, 2, 2, -3, 7 };
+    static_assert(vml::det(A) == 9170);
+    double6x6 const B = vml::type_cast<double>(A);
+    CHECK(vml::det(B) == Catch::Approx(9170));
+
+    SECTION("inverse") {
+        CHECK(B * vml::inverse(A) ==
+              vml::approx(double6x6(1)).epsilon(0.00000000001));
+    }
+    SECTION("solve") {
+        constexpr vml::vector<double, 6> b = { 1, 2, 3, 4, 5, 6 };
+        constexpr auto x = vml::solve(A, b);
+        CHECK(B * x == vml::approx(b).epsilon(0.00000000001));
+        auto const d = vml::lu_decompose(B);
+        CHECK(!d.singular);
+        CHECK(vml::solve(d, b) == vml::approx(x));
+    }
+    SECTION("singular") {
+        double6x6 C = B;
+        C.set_row(5, C.row(0) * 2.0 - C.row(3));
+        CHECK(vml::lu_decompose(C).singular);
+        CHECK(vml::det(vml::type_cast<int>(C)) == 0);
+    }
+    SECTION("unsigned and complex") {
+        static_assert(vml::det(vml::type_cast<unsigned>(A)) == 9170u);
+        auto U = vml::type_cast<unsigned>(A);
+        U.set_row(0, vml::type_cast<unsigned>(A).row(1));
+        U.set_row(1, vml::type_cast<unsigned>(A).row(0));
+        CHECK(vml::det(U) == unsigned(-9170));
+
+        // Every entry times `i`, so the determinant is `i^6 * 9170`
+        vml::matrix<complex_double, 6, 6> const Z(
+            [&](size_t i, size_t j) { return complex_double(0, B(i, j)); });
+        complex_double const d = vml::det(Z);
+        CHECK(vml::real(d) == Catch::Approx(-9170));
+        CHECK(vml::imag(d) == Catch::Approx(0).margin(1e-9));
+    }
+}
+
+TEST_CASE("eigen_symmetric, svd and polar_decompose", "[matrix]") {
+    auto const error = [](auto const& a, auto const& b) {
+        return vml::max_norm(a - b);
+    };
+    double3x3 const identity(1);
+    double3x3 const A = { 2, -1, 0.5, 3, 1, 4, -2, 0.25, 1 };
+    // Rank deficient and with a negative determinant
+    double3x3 const singular = { 1, 2, 3, 2, 4, 6, -1, 0, 1 };
+    double3x3 const reflection = { 1, 0, 0, 0, -2, 0, 0, 0, 3 };
+
+    SECTION("eigen_symmetric") {
+        double3x3 const S = A + vml::transpose(A);
+        auto const [values, vectors] = vml::eigen_symmetric(S);
+        CHECK(values[0] >= values[1]);
+        CHECK(values[1] >= values[2]);
+        CHECK(error(vectors * double3x3::diag(values) *
+                        vml::transpose(vectors),
+                    S) < 1e-12);
+        CHECK(error(vectors * vml::transpose(vectors), identity) < 1e-12);
+        CHECK(vml::det(vectors) == Catch::Approx(1));
+        CHECK(vml::eigen_symmetric(double3x3::diag(1, 3, 2)).values ==
+              double3(3, 2, 1));
+    }
+    SECTION("svd") {
+        for (double3x3 const& m: { A, singular, reflection }) {
+            auto const [u, sigma, v] = vml::svd(m);
+            CHECK(error(u * double3x3::diag(sigma) * vml::transpose(v), m) <
+                  1e-12);
+            CHECK(error(u * vml::transpose(u), identity) < 1e-12);
+            CHECK(error(v * vml::transpose(v), identity) < 1e-12);
+            CHECK(vml::det(u) == Catch::Approx(1));
+            CHECK(vml::det(v) == Catch::Approx(1));
+            CHECK(sigma[0] >= sigma[1]);
+            CHECK(sigma[1] >= std::abs(sigma[2]));
+        }
+        CHECK(std::abs(vml::svd(singular).sigma[2]) < 1e-12);
+        CHECK(vml::svd(reflection).sigma ==
+              vml::approx(double3(3, 2, -1)));
+        CHECK(vml::svd(double3x3(0)).sigma == double3(0));
+    }
+    SECTION("polar_decompose") {
+        for (double3x3 const& m: { A, singular, reflection }) {
+            auto const [r, s] = vml::polar_decompose(m);
+            CHECK(error(r * s, m) < 1e-12);
+            CHECK(error(r * vml::transpose(r), identity) < 1e-12);
+            CHECK(vml::det(r) == Catch::Approx(1));
+            CHECK(error(s, vml::transpose(s)) < 1e-12);
+        }
+        // Rotations are their own rotation part
+        double3x3 const rotation =
+            vml::dimension_cast<3, 3>(vml::rotation<double>(
+                vml::make_rotation(0.7, double3(1, -2, 0.5))));
+        CHECK(error(vml::polar_decompose(rotation).rotation, rotation) <
+              1e-12);
+        CHECK(error(vml::polar_decompose(2.0 * rotation).stretch,
+                    2.0 * identity) < 1e-12);
+    }
+}
+
 TEST_CASE("AABB") {
     vml::AABB<float, 2> a = { float2{ 0, 1 }, float2{ 2, 4 } };
 
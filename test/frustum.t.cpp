@@ -0,0 +1,129 @@
+#include <vml/vml.hpp>
+
+#include <numbers>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "helpers.hpp"
+
+using namespace vml::short_types;
+
+namespace {
+
+/// Smallest distance of the farthest point of a shape along the plane
+/// normals, shapes near zero can go either way due to rounding
+template <typename T>
+T margin(vml::frustum<T> const& f, vml::vector3<T> center,
+         vml::vector3<T> extent, T radius) {
+    T result = std::numeric_limits<T>::max();
+    for (auto const& p: f.planes()) {
+        T const d = vml::dot(vml::vector3<T>(p.xyz), center) + p.w +
+                    vml::dot(vml::abs(vml::vector3<T>(p.xyz)), extent) +
+                    radius;
+        result = std::min(result, d);
+    }
+    return result;
+}
+
+/// Checks `cull()` and `cull_indices()` against `frustum::intersects()`
+template <typename Shape, typename T>
+void check_cull(vml::frustum<T> const& f, std::vector<Shape> const& shapes) {
+    std::vector<std::uint64_t> visible((shapes.size() + 63) / 64, ~0ull);
+    vml::cull(f, shapes, visible);
+    std::vector<std::uint32_t> indices(shapes.size());
+    size_t const count = vml::cull_indices(f, shapes, indices);
+    size_t expected_count = 0;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        bool const expected = f.intersects(shapes[i]);
+        CHECK(bool(visible[i / 64] >> (i % 64) & 1) == expected);
+        if (expected) {
+            REQUIRE(expected_count < count);
+            CHECK(indices[expected_count++] == i);
+        }
+    }
+    CHECK(count == expected_count);
+    // Bits past the end are cleared
+    if (shapes.size() % 64 != 0) {
+        CHECK(visible.back() >> (shapes.size() % 64) == 0);
+    }
+}
+
+} // namespace
+
+TEST_CASE("frustum planes", "[frustum]") {
+    auto const projection =
+        vml::perspective(std::numbers::pi_v<float> / 2, 1.0f, 1.0f, 100.0f);
+    vml::frustum<float> const f(projection);
+    CHECK(f.contains(float3(0, 0, -10)));
+    CHECK(f.contains(float3(9, -9, -10)));
+    CHECK(!f.contains(float3(0, 0, 10)));
+    CHECK(!f.contains(float3(0, 0, -0.5f)));
+    CHECK(!f.contains(float3(0, 0, -101)));
+    CHECK(!f.contains(float3(11, 0, -10)));
+    CHECK(!f.contains(float3(0, -11, -10)));
+    // The planes are normalized
+    CHECK(std::abs(f.distance(4, float3(0, 0, -3)) - 2) < 1e-5f);
+
+    CHECK(f.intersects(vml::AABB<float, 3>(float3(-1, -1, -2),
+                                           float3(1, 1, 1))));
+    CHECK(!f.intersects(vml::AABB<float, 3>(float3(-1, -1, 1),
+                                            float3(1, 1, 2))));
+    CHECK(f.intersects(vml::AABB<float, 3>(float3(9.5f, 0, -10),
+                                           float3(12, 1, -9))));
+    CHECK(!f.intersects(vml::AABB<float, 3>(float3(11, 0, -10),
+                                            float3(12, 1, -9))));
+    CHECK(f.intersects(vml::sphere<float, 3>(float3(0, 0, 0.5f), 1.6f)));
+    CHECK(!f.intersects(vml::sphere<float, 3>(float3(0, 0, 0.5f), 1.4f)));
+    CHECK(!f.intersects(vml::sphere<float, 3>(float3(0, 0, -103), 2)));
+}
+
+TEST_CASE("frustum infinite perspective", "[frustum]") {
+    auto const projection =
+        vml::infinite_perspective(std::numbers::pi / 2, 1.0, 1.0);
+    vml::frustum<double> const f(projection,
+                                 vml::clip_depth::negative_one_to_one);
+    CHECK(f.contains(double3(0, 0, -2)));
+    CHECK(f.contains(double3(0, 0, -1e9)));
+    CHECK(!f.contains(double3(0, 0, -0.5)));
+    CHECK(!f.contains(double3(3, 0, -2)));
+    CHECK(f.planes()[5] == double4(0, 0, 0, 1));
+}
+
+TEST_CASE("frustum cull", "[frustum]") {
+    vml_test::simd_level_guard const guard(
+        GENERATE(from_range(vml_test::simd_levels)));
+    size_t const count = GENERATE(1, 7, 33, 3000);
+    auto const f = vml_test::make_frustum<float>();
+    auto const fd = vml_test::make_frustum<double>();
+    vml_test::random_numbers random;
+    auto const next = [&] { return random() - 50; };
+    std::vector<vml::AABB<float, 3>> boxes;
+    std::vector<vml::AABB<float, 3, vml::vector_options{}.packed(true)>>
+        packed_boxes;
+    std::vector<vml::sphere<float, 3>> spheres;
+    std::vector<vml::sphere<double, 3, vml::vector_options{}>> double_spheres;
+    while (boxes.size() < count) {
+        float3 const lower(next(), next(), next());
+        float3 const size = abs(float3(next(), next(), next())) / 8;
+        if (std::abs(margin<float>(f, lower + size / 2, size / 2, 0)) >
+            1e-3f) {
+            boxes.push_back({ lower, lower + size });
+            packed_boxes.push_back({ lower, lower + size });
+        }
+    }
+    while (spheres.size() < count) {
+        float3 const center(next(), next(), next());
+        float const radius = std::abs(next()) / 10;
+        if (std::abs(margin<float>(f, center, {}, radius)) > 1e-3f &&
+            std::abs(margin<double>(fd, center, {}, radius)) > 1e-3) {
+            spheres.push_back({ center, radius });
+            double_spheres.push_back({ double3(center), double(radius) });
+        }
+    }
+    check_cull(f, boxes);
+    check_cull(f, packed_boxes);
+    check_cull(f, spheres);
+    check_cull(fd, double_spheres);
+}
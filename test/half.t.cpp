@@ -0,0 +1,102 @@
+#include <vml/vml.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "helpers.hpp"
+
+using namespace vml::short_types;
+
+static_assert(vml::real_scalar<vml::half> && vml::scalar<vml::bfloat16>);
+static_assert(std::is_same_v<std::common_type_t<vml::half, float>, float>);
+static_assert(std::is_same_v<std::common_type_t<int, vml::half>, float>);
+static_assert(std::is_same_v<std::common_type_t<vml::bfloat16, double>,
+                             double>);
+static_assert(sizeof(half4) == 8 && sizeof(packed_half3) == 6);
+
+static_assert(vml::half(1.0f).bits() == 0x3c00);
+static_assert(vml::half(-2.5f).bits() == 0xc100);
+static_assert(float(vml::half::from_bits(0x7bff)) == 65504);
+static_assert(vml::bfloat16(1.0f).bits() == 0x3f80);
+static_assert(float(vml::bfloat16::from_bits(0xc040)) == -3);
+
+TEST_CASE("half conversions", "[half]") {
+    using limits = std::numeric_limits<vml::half>;
+    CHECK(float(limits::max()) == 65504);
+    CHECK(float(limits::epsilon()) == 0x1p-10f);
+    CHECK(float(limits::denorm_min()) == 0x1p-24f);
+    CHECK(vml::half(65519.0f).bits() == 0x7bff);
+    CHECK(vml::half(65520.0f).bits() == 0x7c00);
+    CHECK(vml::half(-1e10f).bits() == 0xfc00);
+    CHECK(vml::half(0x1p-25f).bits() == 0x0000);
+    CHECK(vml::half(0x1.8p-25f).bits() == 0x0001);
+    CHECK(vml::half(-0.0f).bits() == 0x8000);
+    /// Ties round to even
+    CHECK(vml::half(1 + 0x1p-11f).bits() == 0x3c00);
+    CHECK(vml::half(1 + 0x3p-11f).bits() == 0x3c02);
+    CHECK(std::isnan(float(vml::half(std::nanf("")))));
+    /// Every half but NaNs converts to float and back unchanged
+    size_t mismatches = 0;
+    for (unsigned bits = 0; bits < 0x10000; ++bits) {
+        auto const h = vml::half::from_bits(std::uint16_t(bits));
+        float const f = h;
+        mismatches += !std::isnan(f) && vml::half(f).bits() != bits;
+    }
+    CHECK(mismatches == 0);
+
+    CHECK(vml::bfloat16(1 + 0x1p-8f).bits() == 0x3f80);
+    CHECK(vml::bfloat16(1 + 0x3p-8f).bits() == 0x3f82);
+    CHECK(std::isnan(float(vml::bfloat16(std::nanf("")))));
+    CHECK(float(vml::bfloat16(std::numeric_limits<float>::infinity())) ==
+          std::numeric_limits<float>::infinity());
+}
+
+TEST_CASE("half vectors", "[half]") {
+    half3 a = { 1, 2, 3 };
+    half3 const b = a + a;
+    CHECK(float3(b) == float3(2, 4, 6));
+    a *= vml::half(0.5f);
+    CHECK(float3(a) == float3(0.5f, 1, 1.5f));
+    float3 const c = a * 2.0f;
+    CHECK(c == float3(1, 2, 3));
+    CHECK(float(vml::dot(b, b)) == 56);
+    bfloat4 const d = float4(1, -2, 0.25f, 8);
+    CHECK(float4(d * d) == float4(1, 4, 0.0625f, 64));
+    vml::matrix<vml::half, 2, 2> const m = { 1, 2, 3, 4 };
+    CHECK(float2(m * half2(1, 1)) == float2(3, 7));
+}
+
+TEST_CASE("batch half conversions", "[half][batch]") {
+    vml_test::simd_level_guard const guard(
+        GENERATE(from_range(vml_test::simd_levels)));
+    size_t const count = GENERATE(1, 7, 33);
+    std::vector<float4> in(count), out(count);
+    for (size_t i = 0; i < count; ++i) {
+        in[i] = float4(float(i) * 0.1f, -float(i), 1e-6f * float(i), 7e4f);
+    }
+    std::vector<half4> halfs(count);
+    vml::batch::convert(in, halfs);
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t k = 0; k < 4; ++k) {
+            CHECK(halfs[i][k].bits() == vml::half(in[i][k]).bits());
+        }
+    }
+    vml::batch::convert(halfs, out);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(out[i] == float4(halfs[i]));
+    }
+    std::vector<bfloat4> bfloats(count);
+    vml::batch::convert(in, bfloats);
+    vml::batch::convert(bfloats, out);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(out[i] == float4(bfloat4(in[i])));
+    }
+    std::vector<float> scalars = { 1, 2, 3 };
+    std::vector<vml::half> scalar_halfs(3);
+    vml::batch::convert(scalars, scalar_halfs);
+    CHECK(float(scalar_halfs[2]) == 3);
+}
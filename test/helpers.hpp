@@ -0,0 +1,108 @@
+#ifndef VML_TEST_HELPERS_HPP_INCLUDED
+#define VML_TEST_HELPERS_HPP_INCLUDED
+
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include <vml/vml.hpp>
+
+#include <catch2/generators/catch_generators_range.hpp>
+
+/// Fixtures and utilities shared by the test files
+
+namespace vml_test {
+
+/// All levels of the batch kernels. Levels the CPU does not support fall back
+/// to the best supported one, so every test runs on every machine.
+inline constexpr std::array simd_levels = { vml::simd_level::sse2,
+                                            vml::simd_level::avx2,
+                                            vml::simd_level::avx512 };
+
+/// Selects the batch kernel level for the lifetime of the guard. The previous
+/// level is restored even if a `REQUIRE` aborts the test case.
+///
+///     vml_test::simd_level_guard const guard(
+///         GENERATE(from_range(vml_test::simd_levels)));
+class simd_level_guard {
+public:
+    explicit simd_level_guard(vml::simd_level level):
+        _previous(vml::active_simd_level()) {
+        vml::set_simd_level(level);
+    }
+
+    simd_level_guard(simd_level_guard const&) = delete;
+    simd_level_guard& operator=(simd_level_guard const&) = delete;
+
+    ~simd_level_guard() { vml::set_simd_level(_previous); }
+
+private:
+    vml::simd_level _previous;
+};
+
+/// Deterministic pseudo random numbers in `[0, 100)`, multiples of `0.01`
+class random_numbers {
+public:
+    explicit random_numbers(unsigned seed = 4711): _state(seed) {}
+
+    float operator()() {
+        _state = _state * 1103515245u + 12345u;
+        return float((_state >> 8) % 10000) / 100.0f;
+    }
+
+private:
+    unsigned _state;
+};
+
+/// Deterministic pseudo random points in `[-50, 50)^3`
+inline std::vector<vml::float3> random_points(size_t count,
+                                              unsigned seed = 4711) {
+    random_numbers next(seed);
+    std::vector<vml::float3> result;
+    for (size_t i = 0; i < count; ++i) {
+        float const x = next() - 50, y = next() - 50, z = next() - 50;
+        result.push_back(vml::float3(x, y, z));
+    }
+    return result;
+}
+
+/// Deterministic pseudo random boxes in `[0, 105)^3` with extents below 5
+inline std::vector<vml::AABB<float, 3>> random_boxes(size_t count,
+                                                     unsigned seed = 12345) {
+    random_numbers next(seed);
+    std::vector<vml::AABB<float, 3>> result;
+    for (size_t i = 0; i < count; ++i) {
+        float const x = next(), y = next(), z = next();
+        float const sx = next() / 20, sy = next() / 20, sz = next() / 20;
+        vml::float3 const p(x, y, z);
+        result.push_back(vml::AABB<float, 3>(p, p + vml::float3(sx, sy, sz)));
+    }
+    return result;
+}
+
+/// Points on a line with small integer coordinates, so sums and products of
+/// them are exact
+inline std::vector<vml::float3> line_points(size_t count, float offset) {
+    std::vector<vml::float3> result(count);
+    for (size_t i = 0; i < count; ++i) {
+        result[i] =
+            vml::float3(float(i) + offset, 1 - float(i), 0.5f * offset);
+    }
+    return result;
+}
+
+/// A perspective frustum turned about the y axis and moved back
+template <typename T>
+vml::frustum<T> make_frustum() {
+    T const c = std::cos(T(0.3)), s = std::sin(T(0.3));
+    vml::matrix4x4<T> const view = { c, 0, s, -1, 0, 1, 0, -2,
+                                     -s, 0, c, -10, 0, 0, 0, 1 };
+    auto const projection =
+        vml::perspective(T(std::numbers::pi / 3), T(1.5), T(1), T(60));
+    return vml::frustum<T>(projection * view);
+}
+
+} // namespace vml_test
+
+#endif // VML_TEST_HELPERS_HPP_INCLUDED
@@ -0,0 +1,89 @@
+#include <vml/vml.hpp>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace vml::short_types;
+
+namespace {
+
+template <typename A, typename B>
+concept can_multiply = requires(A const& a, B const& b) { a * b; };
+
+} // namespace
+
+TEST_CASE("lazy vector expressions", "[lazy]") {
+    float4 const a = { 1, -2, 3, -4 };
+    float4 const b = { 0.5f, 4, -1, 2 };
+    float4 const c = { 2, 2, 2, 2 };
+    float const s = 3, t = -0.5f;
+
+    float4 const r = vml::lazy(a) * s + vml::lazy(b) * t - c;
+    CHECK(r == a * s + b * t - c);
+    float4 q;
+    q = -vml::lazy(a) / c + 1.0f;
+    CHECK(q == -a / c + 1.0f);
+    CHECK((vml::lazy(a) - b)[2] == 4);
+    CHECK(vml::eval(vml::lazy(a) * b) == a * b);
+
+    /// Evaluation into other options and types of the same shape
+    packed_float4 const p = vml::lazy(a) + b;
+    CHECK(p == packed_float4(a + b));
+    double4 const d = vml::lazy(a) * 2;
+    CHECK(d == double4(a * 2));
+
+    vml::vector<double, 7> x, y;
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = double(i) + 0.25;
+        y[i] = 1 - double(i);
+    }
+    vml::vector<double, 7> const z =
+        vml::lazy(x) * 2 + vml::lazy(y) * x - y / 4;
+    for (size_t i = 0; i < x.size(); ++i) {
+        CHECK(z[i] == Catch::Approx(x[i] * 2 + y[i] * x[i] - y[i] / 4));
+    }
+
+    int3 const n = { 1, 2, 3 };
+    int3 const m = vml::lazy(n) * 2 - int3(1);
+    CHECK(m == int3(1, 3, 5));
+}
+
+TEST_CASE("lazy fma contraction", "[lazy]") {
+    // a * a - 1 with a = 1 + 2^-30 has bits below the precision of a * a,
+    // only a fused multiply-add keeps them. Fully lazy chains must round like
+    // `__vml_lazy_fma`, which fuses on FMA targets.
+    double2 const a = { 1 + 0x1p-30, 1 + 0x1p-30 };
+    double2 const one = { 1, 1 };
+    double const fused = vml::__vml_lazy_fma(a[0], a[0], -1.0);
+    double2 const x = vml::lazy(a) * a - vml::lazy(one) * one;
+    double2 const y = -vml::lazy(one) + vml::lazy(a) * a;
+    CHECK(x == double2(fused));
+    CHECK(y == double2(fused));
+}
+
+TEST_CASE("lazy matrix expressions", "[lazy]") {
+    float3x3 const A = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    float3x3 const B = { 2, 0, 1, -1, 0, 1, 3, 2, -2 };
+    float3x3 const C = vml::lazy(A) * 2 - B;
+    CHECK(C == A * 2 - B);
+    float3x3 const D = vml::lazy(A) + B * 0.5f;
+    CHECK(D == A + B * 0.5f);
+
+    static_assert(!can_multiply<vml::lazy_expression<
+                                    vml::__lazy_leaf<float3x3>>,
+                                float3x3>);
+    static_assert(can_multiply<vml::lazy_expression<
+                                   vml::__lazy_leaf<float3>>,
+                               float3>);
+    static_assert(!can_multiply<vml::lazy_expression<
+                                    vml::__lazy_leaf<float3>>,
+                                float4>);
+}
+
+TEST_CASE("constexpr lazy expressions", "[lazy]") {
+    static constexpr float4 a = { 1, -2, 3, -4 };
+    static constexpr float4 b = { 0.5f, 4, -1, 2 };
+    static_assert(float4(vml::lazy(a) * 2 + b) == float4{ 2.5f, 0, 5, -6 });
+    static constexpr double2x2 A = { 1, 2, 3, 4 };
+    static_assert(double2x2(vml::lazy(A) - A * 2) == double2x2(-1, -2, -3, -4));
+}
@@ -213,3 +213,15 @@ TEST_CASE("dyadic_product", "[matrix]") {
     int2 v = { 1, 2 }, w = { 2, 3 };
     CHECK(dyadic_product(v, w) == int2x2{ 2, 3, 4, 6 });
 }
+
+TEST_CASE("matrix norms", "[matrix]") {
+    /// `max` returns a reference to one of the temporary norms, the norms used
+    /// to read it after they were destroyed
+    float3x3 const A = { 1, -2, 3, -4, 5, -6, 7, -8, -9 };
+    CHECK(vml::max_norm(A) == 9);
+    CHECK(vml::row_sum_norm(A) == 24);
+    CHECK(vml::column_sum_norm(A) == 18);
+    CHECK(vml::max_norm(vml::transpose(-A)) == 9);
+    CHECK(vml::row_sum_norm(vml::transpose(A)) == 18);
+    CHECK(vml::column_sum_norm(vml::transpose(A)) == 24);
+}
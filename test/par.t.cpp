@@ -0,0 +1,106 @@
+#include <vml/vml.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+using namespace vml::short_types;
+
+TEST_CASE("thread_pool for_each_chunk", "[par]") {
+    size_t const threads = GENERATE(1, 2, 5);
+    vml::par::thread_pool pool(threads);
+    CHECK(pool.size() == threads);
+    size_t const n = GENERATE(0, 1, 1000, 100'003);
+    std::vector<std::atomic<int>> visits(n);
+    std::atomic<size_t> wrong = 0;
+    for (int round = 0; round < 3; ++round) {
+        pool.for_each_chunk(n, 97, [&](size_t begin, size_t end) {
+            // Catch assertions are not thread safe
+            wrong += end - begin > 97;
+            for (size_t i = begin; i < end; ++i) {
+                ++visits[i];
+            }
+        });
+    }
+    for (auto& v: visits) {
+        wrong += v != 3;
+    }
+    CHECK(wrong == 0);
+}
+
+TEST_CASE("thread_pool nesting and exceptions", "[par]") {
+    vml::par::thread_pool pool(4);
+    std::atomic<size_t> count = 0;
+    pool.for_each_chunk(64, 1, [&](size_t, size_t) {
+        // Runs on the calling thread
+        pool.for_each_chunk(10, 1, [&](size_t, size_t) { ++count; });
+    });
+    CHECK(count == 640);
+    CHECK_THROWS_AS(pool.for_each_chunk(1000, 10,
+                                        [](size_t begin, size_t) {
+        if (begin == 500) {
+            throw std::runtime_error("chunk failed");
+        }
+    }),
+                    std::runtime_error);
+    // The pool is still usable
+    count = 0;
+    pool.for_each_chunk(1000, 10,
+                        [&](size_t begin, size_t end) { count += end - begin; });
+    CHECK(count == 1000);
+}
+
+TEST_CASE("par algorithms", "[par]") {
+    size_t const n = 200'001;
+    std::vector<float3> points(n);
+    vml::par::for_each_index(n, [&](size_t i) {
+        float const t = float(i);
+        points[i] = float3(t, -t, 0.5f * t);
+    });
+    CHECK(points[n - 1] == float3(200'000, -200'000, 100'000));
+
+    vml::par::thread_pool pool(3);
+    std::vector<float3> scaled(n);
+    vml::par::transform(pool, points, scaled,
+                        [](float3 const& p) { return 2.0f * p; });
+    std::vector<float> dots(n);
+    vml::par::transform(points, scaled, dots, [](float3 a, float3 b) {
+        return vml::dot(a, b) / (1 + vml::dot(a, a));
+    });
+    size_t wrong = 0;
+    for (size_t i = 0; i < n; ++i) {
+        wrong += scaled[i] != 2.0f * points[i];
+        wrong += dots[i] != vml::dot(points[i], scaled[i]) /
+                                (1 + vml::dot(points[i], points[i]));
+    }
+    CHECK(wrong == 0);
+
+    std::vector<int3> cells(n);
+    vml::par::transform(points, cells,
+                        [](float3 const& p) { return int3(p) % 7; });
+    int3 expected = 0;
+    for (auto const& c: cells) {
+        expected += c;
+    }
+    CHECK(vml::par::reduce(cells, int3(0)) == expected);
+    CHECK(vml::par::reduce(pool, cells, int3(1), [](int3 a, int3 b) {
+        return vml::max(a, b);
+    }) == int3(6, 1, 6));
+    CHECK(vml::par::transform_reduce(
+              cells, 0, std::plus<>{},
+              [](int3 const& c) { return vml::dot(c, c); }) ==
+          vml::par::transform_reduce(
+              pool, cells, 0, std::plus<>{},
+              [](int3 const& c) { return vml::dot(c, c); }));
+
+    // Chunks do not depend on the pool, neither does rounding
+    std::vector<float4x4> matrices(n / 16, float4x4(0.25f));
+    vml::par::thread_pool single(1);
+    CHECK(vml::par::reduce(single, dots, 0.0f) ==
+          vml::par::reduce(pool, dots, 0.0f));
+    CHECK(vml::par::reduce(single, matrices, float4x4(0)) ==
+          vml::par::reduce(matrices, float4x4(0)));
+}
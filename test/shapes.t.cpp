@@ -1,5 +1,8 @@
 #include <vml/shapes.hpp>
 
+#include <span>
+#include <vector>
+
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 
@@ -85,3 +88,88 @@ TEST_CASE("vml::sphere vml::AABB overlap") {
         CHECK(!vml::do_intersect(box, sphere));
     }
 }
+
+TEST_CASE("vml::ray vml::AABB intersection") {
+    vml::ray<float> const r({ -2, 0.5f, 0.5f }, { 1, 0, 0 });
+    vml::AABB<float> const box = { float3{ 0, 0, 0 }, float3{ 1, 1, 1 } };
+    auto const i = vml::intersect(r, box);
+    CHECK(i.hit());
+    CHECK(i.t_min == 2);
+    CHECK(i.t_max == 3);
+    CHECK(r.at(i.t_min) == float3(0, 0.5f, 0.5f));
+    CHECK(!vml::do_intersect(vml::ray<float>({ -2, 2, 0.5f }, { 1, 0, 0 }),
+                             box));
+    /// Behind the origin
+    CHECK(!vml::do_intersect(vml::ray<float>({ 2, 0.5f, 0.5f }, { 1, 0, 0 }),
+                             box));
+    /// Inside
+    CHECK(vml::intersect(vml::ray<float>({ 0.5f, 0.5f, 0.5f }, { 0, 1, 1 }),
+                         box)
+              .t_min == 0);
+
+    /// Dividing by a zero direction component is not a constant expression
+    constexpr vml::ray<float> c({ -2, 0.5f, 0.5f }, { 1, 0.125f, 0.125f });
+    constexpr vml::AABB<float> unit(float3(0), float3(1));
+    static_assert(vml::intersect(c, unit).t_min == 2);
+    static_assert(vml::intersect(c, unit).t_max == 3);
+}
+
+TEST_CASE("vml::ray vml::aabb_packet intersection") {
+    std::vector<vml::AABB<float>> boxes;
+    for (int i = 0; i < 8; ++i) {
+        float3 const p(float(i), float(i % 3) - 1, float(i % 2));
+        boxes.push_back({ p, p + float3(0.5f, 1.5f, 0.5f + float(i) / 8) });
+    }
+    vml::ray<float> const r({ -1, 0, 0.25f },
+                            vml::normalize(float3(3, 0.1f, 0.05f)));
+    auto const check = [&]<size_t W>(vml::aabb_packet<float, W> const& packet,
+                                     size_t count) {
+        auto const result = vml::intersect(r, packet);
+        auto const mask = result.hit();
+        CHECK(mask.any());
+        for (size_t i = 0; i < W; ++i) {
+            auto const expected = vml::intersect(r, boxes[i]);
+            bool const valid = i < count;
+            CHECK(mask[i] == (valid && expected.hit()));
+            if (valid && expected.hit()) {
+                CHECK(result.t_min[i] == expected.t_min);
+                CHECK(result.t_max[i] == expected.t_max);
+            }
+        }
+    };
+    std::span<vml::AABB<float> const> const all(boxes);
+    check(vml::aabb_packet<float, 4>(all), 4);
+    check(vml::aabb_packet<float, 8>(all), 8);
+    check(vml::aabb_packet<float, 8>(all.first(5)), 5);
+}
+
+TEST_CASE("vml::ray vml::sphere intersection") {
+    vml::sphere<float> const s({ 0, 0, 0 }, 1);
+    auto const i = vml::intersect(vml::ray<float>({ -5, 0, 0 }, { 2, 0, 0 }),
+                                  s);
+    CHECK(i.hit());
+    CHECK(i.t_min == Catch::Approx(2));
+    CHECK(i.t_max == Catch::Approx(3));
+    CHECK(vml::intersect(vml::ray<float>({ 0, 0, 0 }, { 0, 1, 0 }), s).t_min ==
+          0);
+    CHECK(!vml::do_intersect(vml::ray<float>({ -5, 2, 0 }, { 1, 0, 0 }), s));
+    CHECK(!vml::do_intersect(vml::ray<float>({ 5, 0, 0 }, { 1, 0, 0 }), s));
+}
+
+TEST_CASE("vml::ray vml::triangle intersection") {
+    vml::triangle<float> t;
+    t[0] = { 0, 0, 1 };
+    t[1] = { 2, 0, 1 };
+    t[2] = { 0, 2, 1 };
+    auto const hit =
+        vml::intersect(vml::ray<float>({ 0.5f, 1, -1 }, { 0, 0, 1 }), t);
+    REQUIRE(hit);
+    CHECK(hit->t == Catch::Approx(2));
+    CHECK(hit->u == Catch::Approx(0.25f));
+    CHECK(hit->v == Catch::Approx(0.5f));
+    CHECK(!vml::do_intersect(vml::ray<float>({ 1.5f, 1, -1 }, { 0, 0, 1 }),
+                             t));
+    CHECK(!vml::do_intersect(vml::ray<float>({ 0.5f, 1, 2 }, { 0, 0, 1 }), t));
+    /// Parallel to the plane
+    CHECK(!vml::do_intersect(vml::ray<float>({ 0.5f, 1, 1 }, { 1, 0, 0 }), t));
+}
@@ -0,0 +1,99 @@
+#include <vml/vml.hpp>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace vml::short_types;
+
+static float3 point(size_t i) {
+    return { float(i) - 3.5f, 0.5f * float(i) + 1, 2 - float(i * i) / 8 };
+}
+
+static float3_lane8 make_packet(float3 (*f)(size_t)) {
+    float3_lane8 result;
+    for (size_t i = 0; i < 8; ++i) {
+        vml::insert_lane(result, i, f(i));
+    }
+    return result;
+}
+
+TEST_CASE("simd_lane arithmetic", "[simd_lane]") {
+    float const values[8] = { 1, -2, 3, -4, 5, -6, 7, -8 };
+    float_lane8 const a = float_lane8::load(values);
+    float_lane8 const b = 2.0f;
+    float_lane8 const c = vml::fma(a, b, -a);
+    float_lane8 const m = vml::min(a, b);
+    float_lane8 const s = vml::select(a < 0.0f, -a, a);
+    for (size_t i = 0; i < 8; ++i) {
+        CHECK(c[i] == values[i]);
+        CHECK(m[i] == std::min(values[i], 2.0f));
+        CHECK(s[i] == std::abs(values[i]));
+    }
+    CHECK((a < 0.0f).bits() == 0b1010'1010);
+    CHECK((a == a).all());
+    CHECK((a > 10.0f).none());
+    CHECK(((a > 0.0f) & (a < 4.0f)).bits() == 0b0000'0101);
+    CHECK(((a < -6.0f) | (a > 6.0f)).bits() == 0b1100'0000);
+}
+
+TEST_CASE("vector of simd_lane", "[simd_lane]") {
+    static_assert(sizeof(float3_lane8) == 3 * sizeof(float_lane8));
+    auto const other = [](size_t i) {
+        return float3(1, float(i), -0.25f * float(i));
+    };
+    float3_lane8 const a = make_packet(point);
+    float3_lane8 const b = make_packet(other);
+
+    float_lane8 const d = vml::dot(a, b);
+    float3_lane8 const c = vml::cross(a, b);
+    float3_lane8 const n = vml::normalize(a);
+    float3_lane8 const e = vml::min(a, b) + 2 * vml::abs(a);
+    for (size_t i = 0; i < 8; ++i) {
+        CHECK(d[i] == Catch::Approx(vml::dot(point(i), other(i))));
+        CHECK(vml::extract_lane(c, i) ==
+              vml::approx(vml::cross(point(i), other(i))).epsilon(1e-5f));
+        CHECK(vml::extract_lane(n, i) ==
+              vml::approx(vml::normalize(point(i))).epsilon(1e-5f));
+        CHECK(vml::extract_lane(e, i) ==
+              vml::approx(vml::min(point(i), other(i)) +
+                          2 * vml::abs(point(i)))
+                  .epsilon(1e-5f));
+    }
+}
+
+TEST_CASE("comparison of vectors of simd_lane", "[simd_lane]") {
+    float3_lane8 const a = make_packet(point);
+    float3_lane8 b = a;
+    CHECK(a == b);
+    CHECK_FALSE(a != b);
+    vml::insert_lane(b, 7, point(7) + float3(0, 0, 1));
+    CHECK(a != b);
+
+    float3_lane4 const c(float_lane4(1.0f), float_lane4(2.0f),
+                         float_lane4(3.0f));
+    float3_lane4 d = c;
+    CHECK(c == d);
+    d.y = float_lane4(-2.0f);
+    CHECK(c != d);
+}
+
+TEST_CASE("matrix and quaternion of simd_lane", "[simd_lane]") {
+    float3x3 const M = { 1, 2, 0, -1, 3, 1, 0.5f, 0, 2 };
+    vml::matrix<float_lane8, 3, 3> const M8 =
+        vml::matrix<float_lane8, 3, 3>([&](size_t i, size_t j) {
+            return float_lane8(M(i, j));
+        });
+    float3_lane8 const a = make_packet(point);
+    float3_lane8 const p = M8 * a;
+
+    auto const q = vml::make_rotation(0.7f, vml::normalize(float3(1, 2, 3)));
+    vml::quaternion<float_lane8> const q8(
+        q.real, float3_lane8(q.imag.x, q.imag.y, q.imag.z));
+    float3_lane8 const r = vml::rotate(a, q8);
+    for (size_t i = 0; i < 8; ++i) {
+        CHECK(vml::extract_lane(p, i) ==
+              vml::approx(M * point(i)).epsilon(1e-5f));
+        CHECK(vml::extract_lane(r, i) ==
+              vml::approx(vml::rotate(point(i), q)).epsilon(1e-5f));
+    }
+}
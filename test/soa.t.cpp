@@ -0,0 +1,131 @@
+#include <vml/vml.hpp>
+
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "helpers.hpp"
+
+using namespace vml::short_types;
+
+namespace {
+
+template <typename A, typename F>
+concept can_map = requires(A const& a, F f) { vml::map(a, f); };
+
+} // namespace
+
+TEST_CASE("soa_array element access", "[soa]") {
+    std::vector<float3> const aos = vml_test::line_points(21, 1);
+    vml::soa_array<float3> a(aos);
+    REQUIRE(a.size() == 21);
+    CHECK(float3(a[3]) == aos[3]);
+    CHECK(reinterpret_cast<uintptr_t>(a.data(2)) % a.alignment == 0);
+    a[4] = float3(7, 8, 9);
+    a[5][1] = -1;
+    CHECK(std::as_const(a)[4] == float3(7, 8, 9));
+    CHECK(a.component(1)[5] == -1);
+
+    std::vector<float3> back(a.size());
+    a.to_aos(back);
+    CHECK(back[4] == float3(7, 8, 9));
+    CHECK(back[20] == aos[20]);
+
+    vml::soa_array<float3> b = a;
+    a.resize(30);
+    CHECK(std::as_const(a)[29] == float3(0));
+    CHECK(std::as_const(a)[20] == std::as_const(b)[20]);
+}
+
+TEST_CASE("soa_array bulk functions", "[soa]") {
+    vml_test::simd_level_guard const guard(
+        GENERATE(from_range(vml_test::simd_levels)));
+    size_t const count = GENERATE(1, 19);
+    std::vector<float3> const x = vml_test::line_points(count, 1);
+    std::vector<float3> const y = vml_test::line_points(count, 2);
+    vml::soa_array<float3> const a(x), b(y);
+
+    auto const sum = a + b;
+    auto const product = 2.0f * (a * b);
+    std::vector<float> dots(count), norms(count);
+    vml::dot(a, b, dots);
+    vml::norm(a, norms);
+    auto const normalized = vml::normalize(a);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(sum[i] == x[i] + y[i]);
+        CHECK(product[i] == 2.0f * (x[i] * y[i]));
+        CHECK(dots[i] == Catch::Approx(vml::dot(x[i], y[i])));
+        CHECK(norms[i] == Catch::Approx(vml::norm(x[i])));
+        CHECK(normalized[i] == vml::approx(vml::normalize(x[i])));
+    }
+    vml::soa_array<float3> unit(count);
+    vml::normalize_approx(a, unit);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(unit[i] ==
+              vml::approx(vml::normalize(x[i])).epsilon(1e-6f));
+    }
+
+    auto const projected = vml::map(a, [](float3 v) { return float2(v.xy); });
+    CHECK(projected[count - 1] == x[count - 1].xy);
+    using packet = vml::soa_array<float3>::packet_type;
+    auto const squares =
+        vml::map(a, [](packet const& v) { return v * v + v; });
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(squares[i] == x[i] * x[i] + x[i]);
+    }
+    for (size_t i = count; i < squares.stride(); ++i) {
+        CHECK(squares.data(2)[i] == 0);
+    }
+    static_assert(!can_map<vml::soa_array<float3>, float (*)(float3)>);
+    CHECK(vml::fold(a, float3(0), std::plus<>{}) ==
+          vml::approx(std::accumulate(x.begin(), x.end(), float3(0))));
+}
+
+TEST_CASE("soa_array transforms", "[soa]") {
+    float4x4 const m = { 0, -1, 0, 4, //
+                         1, 0,  0, 5, //
+                         0, 0,  2, 6, //
+                         0, 0,  0, 1 };
+    std::vector<float3> const x = vml_test::line_points(19, 1);
+    vml::soa_array<float3> a(x), b(x.size());
+    vml::transform_points(m, a, b);
+    vml::transform_vectors(m, a, a);
+    for (size_t i = 0; i < x.size(); ++i) {
+        CHECK(std::as_const(b)[i] == float3((m * float4(x[i], 1)).xyz));
+        CHECK(std::as_const(a)[i] == float3((m * float4(x[i], 0)).xyz));
+    }
+    vml::transform_normals(m, b, b);
+    /// `b[3]` is `(6, 9, 7)`, the normal matrix rotates and halves `z`
+    CHECK(std::as_const(b)[3] == vml::approx(float3(-9, 6, 3.5f)));
+}
+
+TEST_CASE("soa_array quaternions", "[soa]") {
+    std::vector<float3> const x = vml_test::line_points(19, 1);
+    std::vector<quaternion_float> q(x.size());
+    vml::soa_array<float4> rotations(x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        q[i] = vml::make_rotation(0.25f * float(i), float3(1, 2, float(i)));
+        rotations[i] = float4(q[i]);
+    }
+    vml::soa_array<float3> a(x), b(x.size());
+    vml::rotate(a, q[3], b);
+    vml::rotate(a, rotations, a);
+    for (size_t i = 0; i < x.size(); ++i) {
+        CHECK(vml::max_norm(std::as_const(b)[i] - vml::rotate(x[i], q[3])) <
+              1e-4f);
+        CHECK(vml::max_norm(std::as_const(a)[i] - vml::rotate(x[i], q[i])) <
+              1e-4f);
+    }
+    vml::multiply_quaternions(rotations, rotations, rotations);
+    std::vector<float3x3> m(x.size());
+    vml::rotation_matrices(rotations, std::span(m));
+    for (size_t i = 0; i < x.size(); ++i) {
+        float3 const expected = vml::rotate(x[i], q[i] * q[i]);
+        CHECK(vml::max_norm(m[i] * x[i] - expected) < 1e-4f);
+    }
+}
@@ -0,0 +1,101 @@
+#include <vml/vml.hpp>
+
+#include <limits>
+#include <set>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "helpers.hpp"
+
+using namespace vml::short_types;
+
+namespace {
+
+std::set<std::uint32_t> brute_force(std::vector<float3> const& points,
+                                    float3 center, float radius) {
+    std::set<std::uint32_t> result;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (vml::distance_squared(points[i], center) <= radius * radius) {
+            result.insert(std::uint32_t(i));
+        }
+    }
+    return result;
+}
+
+std::set<std::uint32_t> collect(vml::spatial_hash<float> const& h,
+                                float3 center, float radius) {
+    std::set<std::uint32_t> result;
+    h.query(center, radius,
+            [&](std::uint32_t i) { CHECK(result.insert(i).second); });
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("spatial_hash cells", "[spatial_hash]") {
+    vml::spatial_hash<float> h(2.0f);
+    CHECK(h.cell(float3(0.5f, 1.99f, 2.0f)) == int3(0, 0, 1));
+    CHECK(h.cell(float3(-0.5f, -2.0f, -2.01f)) == int3(-1, -1, -2));
+}
+
+TEST_CASE("spatial_hash rebuild and query", "[spatial_hash]") {
+    // Enough points for the parallel path
+    size_t const threads = GENERATE(1, 4);
+    auto const points = vml_test::random_points(40000);
+    vml::spatial_hash<float> h(1.5f);
+    h.rebuild(points, threads);
+    CHECK(h.size() == points.size());
+    for (float3 center: vml_test::random_points(20)) {
+        for (float radius: { 0.1f, 1.5f, 4.0f }) {
+            CHECK(collect(h, center, radius) ==
+                  brute_force(points, center, radius));
+        }
+    }
+    CHECK(collect(h, float3(1000), 5).empty());
+    CHECK(collect(h, points[0], 0).count(0) == 1);
+    CHECK(collect(h, points[0], -1).empty());
+    CHECK(collect(h, points[0], std::numeric_limits<float>::quiet_NaN())
+              .empty());
+}
+
+TEST_CASE("spatial_hash insert and erase", "[spatial_hash]") {
+    auto points = vml_test::random_points(500);
+    vml::spatial_hash<float> h(3.0f);
+    for (size_t i = 0; i < points.size(); ++i) {
+        h.insert(points[i], std::uint32_t(i));
+    }
+    CHECK(h.size() == points.size());
+    CHECK(collect(h, float3(0), 20) == brute_force(points, float3(0), 20));
+    // Erase every third point and move the others
+    for (size_t i = 0; i < points.size(); ++i) {
+        REQUIRE(h.erase(points[i], std::uint32_t(i)));
+        if (i % 3 == 0) {
+            points[i] = float3(1000);
+        }
+        else {
+            points[i] = -points[i];
+            h.insert(points[i], std::uint32_t(i));
+        }
+    }
+    CHECK(!h.erase(float3(1000), 0));
+    CHECK(h.size() == points.size() - (points.size() + 2) / 3);
+    for (float3 center: vml_test::random_points(10)) {
+        CHECK(collect(h, center, 6) == brute_force(points, center, 6));
+    }
+    h.clear();
+    CHECK(h.empty());
+    CHECK(collect(h, float3(0), 100).empty());
+}
+
+TEST_CASE("spatial_hash 2D with payloads", "[spatial_hash]") {
+    std::vector<float2> const points = { { 0, 0 }, { 1, 0 }, { 0, 3 } };
+    std::vector<char> const payloads = { 'a', 'b', 'c' };
+    vml::spatial_hash<float, 2, char> h(1.0f);
+    h.rebuild(points, payloads);
+    std::set<char> found;
+    h.query(vml::sphere<float, 2>(float2(0.5f, 0), 0.6f),
+            [&](char c) { found.insert(c); });
+    CHECK(found == std::set<char>{ 'a', 'b' });
+}
@@ -1,8 +1,11 @@
 #include <vml/quaternion.hpp>
 #include <vml/vector.hpp>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <tuple>
+#include <vector>
 
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_template_test_macros.hpp>
@@ -264,6 +267,46 @@ TEST_CASE("fold(vector)", "[vector]") {
     static_assert(std::is_same_v<decltype(rf), double const>);
 }
 
+TEST_CASE("fold_pairwise(vector)", "[vector]") {
+    auto const minus = [](int a, int b) { return a - b; };
+    CHECK(vml::fold(int4{ 8, 4, 2, 1 }, minus) == 1);
+    CHECK(vml::fold_pairwise(int4{ 8, 4, 2, 1 }, minus) == 3);
+    CHECK(vml::fold_pairwise(vml::vector<int, 5>{ 16, 8, 4, 2, 1 }, minus) ==
+          5);
+    static_assert(vml::fold_pairwise(int3{ 1, 2, 3 }, Plus) == 6);
+}
+
+TEST_CASE("compensated reductions", "[vector]") {
+    double3 const v = { 1e30, 1, -1e30 };
+    CHECK(vml::fold(v, Plus) == 0);
+    CHECK(vml::sum_compensated(v) == 1);
+    static_assert(vml::sum_compensated(double3{ 1e30, 1, -1e30 }) == 1);
+    // x * x - 1 with x = 1 + 2^-30 has bits below the precision of x * x.
+    // Whether the naive sums round them away depends on FMA contraction, so
+    // only their error is bounded.
+    double2 const a = { 1 + 0x1p-30, 1 }, b = { 1 + 0x1p-30, -1 };
+    constexpr double exact_dot = 0x1p-29 + 0x1p-60;
+    CHECK(vml::dot_compensated(a, b) == exact_dot);
+    CHECK(std::abs(vml::dot(a, b) - exact_dot) <= 0x1p-60);
+    static_assert(vml::dot_compensated(double2{ 1 + 0x1p-30, 1 },
+                                       double2{ 1 + 0x1p-30, -1 }) ==
+                  exact_dot);
+    float2 const f = { 1 + 0x1p-12f, 0x1p-12f };
+    constexpr float exact_norm_squared = 1 + 0x1p-11f + 0x1p-23f;
+    CHECK(vml::norm_squared_compensated(f) == exact_norm_squared);
+    CHECK(std::abs(vml::norm_squared(f) - exact_norm_squared) <= 0x1p-23f);
+}
+
+TEST_CASE("max_norm(vector)", "[vector]") {
+    /// `max` returns a reference to one of the temporary absolute values,
+    /// `max_norm` used to read it after they were destroyed
+    size_t const i = GENERATE(0, 1, 2, 3);
+    float4 v = { 1, -2, 3, -2 };
+    v[i] = -7;
+    CHECK(vml::max_norm(v) == 7);
+    CHECK(vml::max_norm(int3{ -5, 4, 1 }) == 5);
+}
+
 TEST_CASE("vector comparisons", "[vector]") {
     int3 const i = { 1, 2, 3 };
     float3 const f = { .1, .2, .3 };
@@ -286,6 +329,30 @@ TEST_CASE("clamp", "[vector]") {
     CHECK(w == vml::float3{ 0.5, 1, 0 });
 }
 
+TEST_CASE("std::hash(vector)", "[vector]") {
+    std::hash<float3> const hf;
+    CHECK(hf({ -0.0f, 1, 2 }) == hf({ 0.0f, 1, 2 }));
+    CHECK(hf({ NAN, 1, 2 }) == hf({ -NAN, 1, 2 }));
+    CHECK(hf({ 1, 2, 3 }) != hf({ 1, 3, 2 }));
+    CHECK(hf({ 1, 2, 3 }) == std::hash<vml::packed_float3>{}({ 1, 2, 3 }));
+    CHECK(std::hash<int3>{}({ 1, 2, 3 }) ==
+          std::hash<vml::packed_int3>{}({ 1, 2, 3 }));
+    constexpr int4 a = { 1, 2, 3, 4 }, b = { 1, 2, 4, 3 };
+    static_assert(std::hash<int4>{}(a) != std::hash<int4>{}(b));
+    // Neighbouring voxel coordinates must not collide
+    std::hash<int3> const hi;
+    std::vector<size_t> hashes;
+    for (int z = -16; z < 16; ++z) {
+        for (int y = -16; y < 16; ++y) {
+            for (int x = -16; x < 16; ++x) {
+                hashes.push_back(hi({ x, y, z }));
+            }
+        }
+    }
+    std::sort(hashes.begin(), hashes.end());
+    CHECK(std::adjacent_find(hashes.begin(), hashes.end()) == hashes.end());
+}
+
 namespace {
 
 struct MyVec2 {